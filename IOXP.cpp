@@ -48,18 +48,157 @@
 /* -------------------------------------------------------------------- */
 #include "IOXP.h"
 #include <Wire.h>
+#if defined(__PIC32MX__)
 #include <sys/attribs.h>
+#endif
 
 
 #include <WProgram.h>
 
+/* -------------------------------------------------------------------- */
+/*					Local Definitions							        */
+/* -------------------------------------------------------------------- */
+#if defined(BUFFER_LENGTH)
+#define IOXP_WIRE_BUFFER_LEN	BUFFER_LENGTH	// size of the Wire transmit / receive buffers
+#else
+#define IOXP_WIRE_BUFFER_LEN	32
+#endif
+
+// keeps the compiler from moving memory accesses across the event queue index updates
+#if defined(__GNUC__)
+#define IOXP_COMPILER_BARRIER()	__asm__ __volatile__("" ::: "memory")
+#else
+#define IOXP_COMPILER_BARRIER()
+#endif
+
+// age given to the INT edge time when the pending flag is set without an edge: older than any FIFO
+// read, so the event times are bounded by the FIFO reads only
+#define IOXP_NO_EDGE_AGE_US		0x7FFFFFFFUL
+
+/* -------------------------------------------------------------------- */
+/*				Global Variables								        */
+/* -------------------------------------------------------------------- */
+// default key map: Digilent PmodKYPD plugged into J1 connector of PmodIOXP (R0-3, C0-3)
+const int8_t keyMap_KYPD[IOXP_KB_ROWS][IOXP_KB_COLS] = 
+					{{ 0xD,0xC,0xB,0xA, -1, -1, -1, -1, -1, -1, -1},    //row 0
+                     { 0xE,  9,  6,  3, -1, -1, -1, -1, -1, -1, -1},    //row 1
+                     { 0xF,  8,  5,  2, -1, -1, -1, -1, -1, -1, -1},    //row 2
+                     {   0,  7,  4,  1, -1, -1, -1, -1, -1, -1, -1},    //row 3
+                     {  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},    //row 4
+                     {  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},    //row 5
+                     {  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},    //row 6
+                     {  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},    //row 7
+					 };
+
+/* -------------------------------------------------------------------- */
+/*				Local Variables									        */
+/* -------------------------------------------------------------------- */
+// description of an event identifier (bits [6:0] of a FIFO event), 0xFF for the unused fields
+struct IOXPEventDesc {
+	uint8_t bKind;
+	uint8_t bRow;
+	uint8_t bCol;
+	uint8_t bGPI;
+	uint8_t bLogic;
+	uint8_t bKeyIdx;	// row * IOXP_KB_COLS + column for keys, 0 otherwise
+};
+
+#define IOXP_EVT_NONE			{IOXP_EVENT_KIND_NONE, 0xFF, 0xFF, 0xFF, 0xFF, 0}
+#define IOXP_EVT_KEY(r, c)		{IOXP_EVENT_KIND_KEY, (r), (c), 0xFF, 0xFF, (r) * IOXP_KB_COLS + (c)}
+#define IOXP_EVT_KEY_ROW(r)		IOXP_EVT_KEY(r, 0), IOXP_EVT_KEY(r, 1), IOXP_EVT_KEY(r, 2), IOXP_EVT_KEY(r, 3), \
+								IOXP_EVT_KEY(r, 4), IOXP_EVT_KEY(r, 5), IOXP_EVT_KEY(r, 6), IOXP_EVT_KEY(r, 7), \
+								IOXP_EVT_KEY(r, 8), IOXP_EVT_KEY(r, 9), IOXP_EVT_KEY(r, 10)
+#define IOXP_EVT_GND(r)			{IOXP_EVENT_KIND_GND, (r), 0xFF, 0xFF, 0xFF, 0}
+#define IOXP_EVT_GPI(n)			{IOXP_EVENT_KIND_GPI, 0xFF, 0xFF, (n), 0xFF, 0}
+#define IOXP_EVT_LOGIC(n)		{IOXP_EVENT_KIND_LOGIC, 0xFF, 0xFF, 0xFF, (n), 0}
+
+// event identifier -> event description, used by DecodeEvent
+static const IOXPEventDesc rgEvtDesc[128] = 
+{
+	IOXP_EVT_NONE,
+	IOXP_EVT_KEY_ROW(0), IOXP_EVT_KEY_ROW(1), IOXP_EVT_KEY_ROW(2), IOXP_EVT_KEY_ROW(3),
+	IOXP_EVT_KEY_ROW(4), IOXP_EVT_KEY_ROW(5), IOXP_EVT_KEY_ROW(6), IOXP_EVT_KEY_ROW(7),
+	IOXP_EVT_GND(0), IOXP_EVT_GND(1), IOXP_EVT_GND(2), IOXP_EVT_GND(3),
+	IOXP_EVT_GND(4), IOXP_EVT_GND(5), IOXP_EVT_GND(6), IOXP_EVT_GND(7),
+	IOXP_EVT_GPI(1), IOXP_EVT_GPI(2), IOXP_EVT_GPI(3), IOXP_EVT_GPI(4), IOXP_EVT_GPI(5),
+	IOXP_EVT_GPI(6), IOXP_EVT_GPI(7), IOXP_EVT_GPI(8), IOXP_EVT_GPI(9), IOXP_EVT_GPI(10),
+	IOXP_EVT_GPI(11), IOXP_EVT_GPI(12), IOXP_EVT_GPI(13), IOXP_EVT_GPI(14), IOXP_EVT_GPI(15),
+	IOXP_EVT_GPI(16), IOXP_EVT_GPI(17), IOXP_EVT_GPI(18), IOXP_EVT_GPI(19),
+	IOXP_EVT_LOGIC(1), IOXP_EVT_LOGIC(2),
+	IOXP_EVT_NONE, IOXP_EVT_NONE, IOXP_EVT_NONE, IOXP_EVT_NONE, IOXP_EVT_NONE,
+	IOXP_EVT_NONE, IOXP_EVT_NONE, IOXP_EVT_NONE, IOXP_EVT_NONE, IOXP_EVT_NONE
+};
+// the rows above are written for this geometry
+IOXP_STATIC_ASSERT(IOXP_KB_ROWS == 8 && IOXP_KB_COLS == 11 && IOXP_GPIOS == 19 && IOXP_NO_LOGIC == 2, event_table_geometry);
+IOXP_STATIC_ASSERT(IOXP_EVENT_ID_END == 118, event_table_layout);
+
+// event kind -> first event identifier of the kind, used by EncodeEvent
+static const uint8_t rgbEvtIdFirst[IOXP_EVENT_KINDS] = 
+{
+	0, IOXP_EVENT_ID_KEY, IOXP_EVENT_ID_GND, IOXP_EVENT_ID_GPI, IOXP_EVENT_ID_LOGIC
+};
+
+volatile bool *IOXP::rgpfIntPending[IOXP_EXT_INT_CNT];
+volatile uint32_t *IOXP::rgpdwIntTimeUS[IOXP_EXT_INT_CNT];
+
+// external interrupt handlers used by ConfigureEventQueue, indexed by the interrupt number
+void (* const IOXP::rgpfIntHandler[IOXP_EXT_INT_CNT])() = 
+{
+	IOXP::IntHandler0, IOXP::IntHandler1, IOXP::IntHandler2, IOXP::IntHandler3, IOXP::IntHandler4
+};
+
 /* -------------------------------------------------------------------- */
 /*				Procedure Definitions							        */
 /* -------------------------------------------------------------------- */
 
-IOXP::IOXP()
+/* -------------------------------------------------------------------- */
+/*	IOXP::IOXP                                                          */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		IOXP myIOXP(bI2CAddr, pWire);                                   */
+/*	Parameters:                                                         */  
+/*		uint8_t bI2CAddr	- the 7-bit I2C address of the device,      */
+/*							  IOXP_I2C_ADDR (0x34) by default           */
+/*		TwoWire *pWire		- the I2C bus the device is connected to,   */
+/*							  NULL (default) for the global Wire object */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Several objects can coexist, on different buses or at different */
+/*		addresses (for example behind an I2C multiplexer).              */
+/* -------------------------------------------------------------------- */
+
+IOXP::IOXP(uint8_t bI2CAddr, TwoWire *pWire)
 {
+	this->bI2CAddr = bI2CAddr;
+	this->pWire = (pWire != NULL) ? pWire : &Wire;
 	SetKeyMap(keyMap_KYPD);
+	bLastI2CStatus = IOXP_I2C_OK;
+	ResetBusCost();
+#if defined(IOXP_PROFILE)
+	ResetStats();
+#endif
+	fCacheEn = false;
+	fBatch = false;
+	pEvtQueue = NULL;
+	pDispatch = NULL;
+	pReqHead = NULL;
+	pReqTail = NULL;
+	bReqChunk = IOXP_REQ_CHUNK;
+	bSclPin = IOXP_NO_PIN;
+	bSdaPin = IOXP_NO_PIN;
+	SetRetryPolicy(0, IOXP_RETRY_BACKOFF_US, IOXP_CALL_TIMEOUT_US);
+	ResetBusErrors();
+	fIntPending = false;
+	bLastIntStatus = 0;
+	dwBeginUS = 0;
+	dwIntTimeUS = 0;
+	dwLastFifoUS = 0;
+	dwGpiActive = 0;
+	dwGpiResync = 0;
+	ResetOverflowCounters();
+	ClearKeyState();
+	InvalidateRegisterCache();
+	ResetRegisterCacheStats();
 }
 
 /* -------------------------------------------------------------------- */
@@ -73,27 +212,99 @@ IOXP::IOXP()
 /*		uint8_t *rgbValues - the array of values to be written          */
 /*                                                                      */	                                                     
 /*  Return Value:                                                       */
-/*		void                                                            */
+/*		uint8_t - IOXP_I2C_OK or one of the IOXP_I2C_ERR_... codes      */
 /*                                                                      */
 /*	Errors:                                                             */
+/*		IOXP_I2C_ERR_NACK_ADDR, IOXP_I2C_ERR_NACK_DATA, IOXP_I2C_ERR_BUS */
+/*		as reported by Wire.endTransmission, once the retries set by    */
+/*		SetRetryPolicy are exhausted, or IOXP_I2C_ERR_TIMEOUT, see      */
+/*		RetryTransfer.                                                  */
 /*                                                                      */
 /*	Description:                                                        */
 /*		This function writes the values from the buffer to the          */ 
 /*  	specified number of registers starting from a specified address */
 /*		value. It performs the I2C write cycle for the specified array  */ 
 /*  	of values to the specified address.                             */
+/*		Transfers that do not fit in the Wire buffer are split into     */
+/*		several write cycles, each one starting at the address of its   */
+/*		first register. A failed cycle is retried, the cycles already   */
+/*		done are not repeated.                                          */
+/*		Inside a batch (BeginBatch) writes to configuration registers   */
+/*		are only staged.                                                */
 /* -------------------------------------------------------------------- */
 
-void IOXP::WriteBytesI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues)
+uint8_t IOXP::WriteBytesI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues)
 {
-    Wire.beginTransmission(IOXP_I2C_ADDR); //start transmission to device 
-    Wire.send(bAddress);        // send register address
-	int nIdxBytes;
-	for(nIdxBytes = 0; nIdxBytes < bCntBytes; nIdxBytes++)
+	uint8_t bStatus = IOXP_I2C_OK;
+	uint8_t bIdxBytes = 0;
+	if(fBatch && IOXP_IS_ADDR_CACHEABLE(bAddress) && IOXP_IS_ADDR_CACHEABLE(bAddress + bCntBytes - 1))
 	{
-		Wire.send(rgbValues[nIdxBytes]); // send value to write
-	}	
-	Wire.endTransmission(); //end transmission
+		// stage the values, they are written by CommitBatch
+		for(bIdxBytes = 0; bIdxBytes < bCntBytes; bIdxBytes++)
+		{
+			rgbBatchVal[bAddress + bIdxBytes] = rgbValues[bIdxBytes];
+			rgbBatchMask[bAddress + bIdxBytes] = 0xFF;
+		}
+		return IOXP_I2C_OK;
+	}
+	uint8_t bAttempt = 0;
+	uint32_t dwStartUS = micros();
+	bStatus = CheckBus();
+	while(bStatus == IOXP_I2C_OK && bIdxBytes < bCntBytes)
+	{
+		// one byte of the Wire buffer is taken by the register address
+		uint8_t bCntChunk = bCntBytes - bIdxBytes;
+		if(bCntChunk > IOXP_WIRE_BUFFER_LEN - 1)
+		{
+			bCntChunk = IOXP_WIRE_BUFFER_LEN - 1;
+		}
+		bStatus = WriteChunkI2C(bAddress + bIdxBytes, bCntChunk, rgbValues + bIdxBytes);
+		if(bStatus != IOXP_I2C_OK)
+		{
+			bStatus = RetryTransfer(bStatus, bAttempt, dwStartUS);
+			continue;
+		}
+		UpdateShadow(bAddress + bIdxBytes, bCntChunk, rgbValues + bIdxBytes);
+		bIdxBytes += bCntChunk;
+	}
+	bLastI2CStatus = bStatus;
+	return bStatus;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::WriteChunkI2C                                                 */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		WriteChunkI2C(bAddress, bCntBytes, rgbValues);                  */
+/*	Parameters:                                                         */  
+/*		uint8_t bAddress	- the first register                        */
+/*		uint8_t bCntBytes	- the number of values, fitting in the Wire */
+/*							  buffer with the register address          */
+/*		uint8_t *rgbValues	- the values                                */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or the Wire.endTransmission error         */
+/*                                                                      */
+/*	Description:                                                        */
+/*		One I2C write cycle, without retry.                             */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::WriteChunkI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues)
+{
+#if defined(IOXP_PROFILE)
+	uint32_t dwStartUS = micros();
+#endif
+	pWire->beginTransmission(bI2CAddr);	//start transmission to device 
+	pWire->send(bAddress);					// send register address
+	pWire->send(rgbValues, bCntBytes);		// send values to write
+	uint8_t bStatus = pWire->endTransmission();	//end transmission
+#if defined(IOXP_PROFILE)
+	ProfileTransfer(bAddress, bCntBytes, false, micros() - dwStartUS);
+#endif
+	// START, device address, register address, data, STOP
+	dwBusBytes += 2 + bCntBytes;
+	dwBusConditions += 2;
+	return bStatus;
 }
 
 /* -------------------------------------------------------------------- */
@@ -108,35 +319,270 @@ void IOXP::WriteBytesI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues
 /*	   uint8_t *rgbValues - the array where values will be read         */
 /*                                                                      */	                                                     
 /*  Return Value:                                                       */
-/*		void                                                            */
+/*		uint8_t - IOXP_I2C_OK or one of the IOXP_I2C_ERR_... codes      */
 /*                                                                      */
 /*	Errors:                                                             */
+/*		IOXP_I2C_ERR_NACK_ADDR, IOXP_I2C_ERR_NACK_DATA, IOXP_I2C_ERR_BUS */
+/*		if the register address could not be sent.                     */
+/*		IOXP_I2C_ERR_SHORT_READ if the device returned fewer bytes than */
+/*		requested. IOXP_I2C_ERR_TIMEOUT if the time budget ran out      */
+/*		before the retries, see RetryTransfer. The values not received  */
+/*		are set to 0.                                                   */
 /*                                                                      */
 /*	Description:                                                        */
 /*		This function will read the specified number of registers       */ 
 /*  	starting from a specified address and store their values in the */
 /*		buffer. It performs the I2C read cycle from the specified       */ 
 /*  	address into the specified array of values.                     */
+/*		The register address is written without a STOP condition and    */
+/*		the data is read after a repeated START. Transfers that do not  */
+/*		fit in the Wire buffer are split into several read cycles. A    */
+/*		failed cycle is retried from the first byte not received.       */
+/*		Inside a batch (BeginBatch) the staged bits replace the values  */
+/*		read from the device.                                           */
 /* -------------------------------------------------------------------- */
 
-void IOXP::ReadBytesI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues)
-{      
-
-	Wire.beginTransmission(IOXP_I2C_ADDR); 	//start transmission to idDevice 
-	Wire.send(bAddress);        			//send address to read from
-	Wire.endTransmission(); 				//end transmission
-	Wire.beginTransmission(IOXP_I2C_ADDR); 	//start transmission to idDevice (initiate again)
-	Wire.requestFrom(IOXP_I2C_ADDR, (int)bCntBytes);// request bCntBytes bytes from IOXP_I2C_ADDR device                		
-
+uint8_t IOXP::ReadBytesI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues)
+{
+	uint8_t bStatus = IOXP_I2C_OK;
 	uint8_t bIdxBytes = 0;
+	uint8_t bAttempt = 0;
+	uint32_t dwStartUS = micros();
+	bStatus = CheckBus();
+	while(bStatus == IOXP_I2C_OK && bIdxBytes < bCntBytes)
+	{
+		uint8_t bCntChunk = bCntBytes - bIdxBytes;
+		uint8_t bCntRead = 0;
+		if(bCntChunk > IOXP_WIRE_BUFFER_LEN)
+		{
+			bCntChunk = IOXP_WIRE_BUFFER_LEN;
+		}
+		bStatus = ReadChunkI2C(bAddress + bIdxBytes, bCntChunk, rgbValues + bIdxBytes, bCntRead);
+		// the bytes received are valid, a retry goes on after them
+		UpdateShadow(bAddress + bIdxBytes, bCntRead, rgbValues + bIdxBytes);
+		bIdxBytes += bCntRead;
+		if(bStatus != IOXP_I2C_OK)
+		{
+			bStatus = RetryTransfer(bStatus, bAttempt, dwStartUS);
+		}
+	}
+	if(bIdxBytes < bCntBytes)
+	{
+		// never leave stale bytes in the caller buffer
+		memset(rgbValues + bIdxBytes, 0, bCntBytes - bIdxBytes);
+	}
+	if(fBatch)
+	{
+		// reads return the values staged by the batch
+		for(bIdxBytes = 0; bIdxBytes < bCntBytes; bIdxBytes++)
+		{
+			int nAddr = bAddress + bIdxBytes;
+			if(IOXP_IS_ADDR_CACHEABLE(nAddr))
+			{
+				uint8_t bMask = rgbBatchMask[nAddr];
+				rgbValues[bIdxBytes] = (rgbValues[bIdxBytes] & ~bMask) | (rgbBatchVal[nAddr] & bMask);
+			}
+		}
+	}
+	bLastI2CStatus = bStatus;
+	return bStatus;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::ReadChunkI2C                                                  */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ReadChunkI2C(bAddress, bCntBytes, rgbValues, bCntRead);         */
+/*	Parameters:                                                         */  
+/*		uint8_t bAddress	- the first register                        */
+/*		uint8_t bCntBytes	- the number of values, fitting in the Wire */
+/*							  buffer                                    */
+/*		uint8_t *rgbValues	- receives the values                       */
+/*		uint8_t &bCntRead	- output: the number of values received     */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK, the Wire.endTransmission error of the    */
+/*				  address phase, or IOXP_I2C_ERR_SHORT_READ             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		One I2C read cycle (address write, repeated START, read),       */
+/*		without retry.                                                  */
+/* -------------------------------------------------------------------- */
 
-	while(Wire.available() && bIdxBytes < bCntBytes)
+uint8_t IOXP::ReadChunkI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues, uint8_t &bCntRead)
+{
+#if defined(IOXP_PROFILE)
+	uint32_t dwStartUS = micros();
+#endif
+	bCntRead = 0;
+	pWire->beginTransmission(bI2CAddr);	//start transmission to device 
+	pWire->send(bAddress);					//send address to read from
+	uint8_t bStatus = pWire->endTransmission(false);	//no STOP, the read follows with a repeated START
+	dwBusBytes += 2;
+	dwBusConditions++;
+	if(bStatus != IOXP_I2C_OK)
+	{
+		dwBusConditions++;	// the failed cycle is closed by a STOP
+#if defined(IOXP_PROFILE)
+		ProfileTransfer(bAddress, 0, true, micros() - dwStartUS);
+#endif
+		return bStatus;
+	}
+	pWire->requestFrom((int)bI2CAddr, (int)bCntBytes);	// request bCntBytes bytes, ends with STOP
+	while(pWire->available() && bCntRead < bCntBytes)
 	{ 
-		rgbValues[bIdxBytes] = Wire.receive(); // receive a byte
-		bIdxBytes++;
+		rgbValues[bCntRead] = pWire->receive(); // receive a byte
+		bCntRead++;
+	}
+	// repeated START, device address, the data received, STOP
+	dwBusBytes += 1 + bCntRead;
+	dwBusConditions += 2;
+#if defined(IOXP_PROFILE)
+	ProfileTransfer(bAddress, bCntRead, true, micros() - dwStartUS);
+#endif
+	return (bCntRead < bCntBytes) ? IOXP_I2C_ERR_SHORT_READ : IOXP_I2C_OK;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::RetryTransfer                                                 */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		RetryTransfer(bStatus, bAttempt, dwStartUS);                    */
+/*	Parameters:                                                         */  
+/*		uint8_t bStatus		- the error of the last cycle               */
+/*		uint8_t &bAttempt	- retries already done by the call, updated */
+/*		uint32_t dwStartUS	- micros() at the start of the call         */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK to retry the cycle, otherwise the final   */
+/*				  status of the call                                    */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Counts the error, then retries while the call has retries left  */
+/*		(SetRetryPolicy) and is within its time budget: waits the       */
+/*		backoff, doubled at each retry, and checks the bus (CheckBus)   */
+/*		first, so a device holding SDA low is cleared by RecoverBus.    */
+/*		A call out of time returns IOXP_I2C_ERR_TIMEOUT, one out of     */
+/*		retries the last error.                                         */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::RetryTransfer(uint8_t bStatus, uint8_t &bAttempt, uint32_t dwStartUS)
+{
+	if(bStatus == IOXP_I2C_ERR_SHORT_READ)
+	{
+		busErrors.dwShortReads++;
+	}
+	else if(bStatus == IOXP_I2C_ERR_NACK_ADDR || bStatus == IOXP_I2C_ERR_NACK_DATA)
+	{
+		busErrors.dwNacks++;
+	}
+	else
+	{
+		busErrors.dwBusErrors++;
+	}
+	if(bAttempt >= bRetries || bStatus == IOXP_I2C_ERR_LENGTH)
+	{
+		busErrors.dwFailures++;
+		return bStatus;
+	}
+	uint32_t dwBackoffUS = (uint32_t)wBackoffUS << bAttempt;
+	if(micros() - dwStartUS + dwBackoffUS > dwTimeoutUS)
+	{
+		busErrors.dwTimeouts++;
+		busErrors.dwFailures++;
+		return IOXP_I2C_ERR_TIMEOUT;
+	}
+	bAttempt++;
+	busErrors.dwRetries++;
+	if(dwBackoffUS != 0)
+	{
+		delayMicroseconds(dwBackoffUS);
+	}
+	bStatus = CheckBus();
+	if(bStatus != IOXP_I2C_OK)
+	{
+		busErrors.dwFailures++;
+	}
+	return bStatus;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::CheckBus                                                      */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		CheckBus();                                                     */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK if a transfer can be started,             */
+/*				  IOXP_I2C_ERR_BUS if SDA stays low                     */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Without SetBusRecoveryPins, always IOXP_I2C_OK. Otherwise SDA   */
+/*		is read before the START: the Wire library waits for the bus to */
+/*		be idle without a time limit, so a low SDA is first cleared     */
+/*		with RecoverBus, and the transfer is not started if it fails.   */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::CheckBus()
+{
+	if(bSdaPin == IOXP_NO_PIN || digitalRead(bSdaPin) != LOW)
+	{
+		return IOXP_I2C_OK;
+	}
+	return RecoverBus();
+}
+
+#if defined(IOXP_PROFILE)
+/* -------------------------------------------------------------------- */
+/*	IOXP::ProfileTransfer                                               */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ProfileTransfer(bAddress, bCntBytes, fRead, dwTimeUS);          */
+/*	Parameters:                                                         */  
+/*		uint8_t bAddress	- the address of the first register         */
+/*		uint8_t bCntBytes	- the number of data bytes transferred      */
+/*		bool fRead			- true for a read, false for a write        */
+/*		uint32_t dwTimeUS	- the time spent in the Wire calls          */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Adds one I2C transaction to the bus traffic statistics. Only    */
+/*		compiled when IOXP_PROFILE is defined.                          */
+/* -------------------------------------------------------------------- */
+
+void IOXP::ProfileTransfer(uint8_t bAddress, uint8_t bCntBytes, bool fRead, uint32_t dwTimeUS)
+{
+	if(bAddress >= IOXP_NO_REGS)
+	{
+		return;
+	}
+	if(fRead)
+	{
+		stats.rgdwReads[bAddress]++;
+	}
+	else
+	{
+		stats.rgdwWrites[bAddress]++;
+	}
+	stats.rgdwBytes[bAddress] += bCntBytes;
+	stats.dwWireTimeUS += dwTimeUS;
+	if(bCntBytes > stats.bMaxTransferBytes)
+	{
+		stats.bMaxTransferBytes = bCntBytes;
+		stats.bMaxTransferAddr = bAddress;
+	}
+	if(dwTimeUS > stats.dwMaxTransferUS)
+	{
+		stats.dwMaxTransferUS = dwTimeUS;
 	}
-	Wire.endTransmission(); 				//end transmission
 }
+#endif
 
 /* -------------------------------------------------------------------- */
 /*	IOXP::WriteMaskedRegisterValue                                      */
@@ -160,16 +606,140 @@ void IOXP::ReadBytesI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues)
 /*		are copied from the value to the register, while the bits       */ 
 /*  	corresponding to binary 0 values in the mask remain unchanged   */
 /* 		in the register.                                                */
+/*		When the register cache is enabled and holds the register, the  */
+/*		read is skipped, and so is the write if the value is unchanged. */
+/*		Inside a batch (BeginBatch) the write is only staged.           */
 /* -------------------------------------------------------------------- */
 
 void IOXP::WriteMaskedRegisterValue(uint8_t bAddress, uint8_t bMask, uint8_t bVal)
 {
 	uint8_t bOldVal;
-	ReadBytesI2C(bAddress, 1, &bOldVal);
+	if(fBatch && IOXP_IS_ADDR_CACHEABLE(bAddress))
+	{
+		// merge into the staged value, CommitBatch supplies the other bits
+		rgbBatchVal[bAddress] = (rgbBatchVal[bAddress] & ~bMask) | (bVal & bMask);
+		rgbBatchMask[bAddress] |= bMask;
+		return;
+	}
+	bool fCached = fCacheEn && IsShadowValid(bAddress);
+	if(fCached)
+	{
+		bOldVal = rgbShadow[bAddress];
+		dwCacheSavedReads++;
+	}
+	else if(ReadBytesI2C(bAddress, 1, &bOldVal) != IOXP_I2C_OK)
+	{
+		// do not write back a value built on a failed read
+		return;
+	}
 	uint8_t bNewVal = (bOldVal & ~bMask) | (bVal & bMask); 
+	if(fCached && bNewVal == bOldVal)
+	{
+		// the register already holds the value
+		dwCacheSavedWrites++;
+		return;
+	}
 	WriteBytesI2C(bAddress, 1, &bNewVal);
 }
 
+/* -------------------------------------------------------------------- */
+/*	IOXP::UpdateLatchBits                                               */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		UpdateLatchBits(bAddress, bMask, bVal);                         */
+/*	Parameters:                                                         */  
+/*		uint8_t bAddress	- a configuration register                  */
+/*		uint8_t bMask		- the bits to change                        */
+/*		uint8_t bVal		- their new values                          */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or one of the IOXP_I2C_ERR_... codes      */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Same as WriteMaskedRegisterValue for the registers only written */
+/*		by the MCU (output levels, directions, pulls, debounce), used   */
+/*		as latches like GpoUpdate does: the shadow is used whenever it  */
+/*		holds the register, even with the cache disabled, so the update */
+/*		is one write, and none when the bits already have the values.   */
+/*		The register is read once if the shadow does not hold it.      */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::UpdateLatchBits(uint8_t bAddress, uint8_t bMask, uint8_t bVal)
+{
+	uint8_t bOldVal;
+	if(fBatch || !IsShadowValid(bAddress))
+	{
+		bLastI2CStatus = IOXP_I2C_OK;
+		WriteMaskedRegisterValue(bAddress, bMask, bVal);
+		return bLastI2CStatus;
+	}
+	bOldVal = rgbShadow[bAddress];
+	uint8_t bNewVal = (bOldVal & ~bMask) | (bVal & bMask);
+	if(bNewVal == bOldVal)
+	{
+		dwCacheSavedWrites++;
+		return IOXP_I2C_OK;
+	}
+	return WriteBytesI2C(bAddress, 1, &bNewVal);
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::UpdateShadow                                                  */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		UpdateShadow(bAddress, bCntBytes, rgbValues);                   */
+/*	Parameters:                                                         */  
+/*		uint8_t bAddress   - the address of the first register          */
+/*		uint8_t bCntBytes  - the number of registers transferred        */
+/*		uint8_t *rgbValues - the register values                        */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Copies the values of the cacheable registers of an I2C transfer */
+/*		into the register shadow and marks them as valid. Volatile      */
+/*		registers (IOXP_IS_ADDR_CACHEABLE) are skipped.                 */
+/* -------------------------------------------------------------------- */
+
+void IOXP::UpdateShadow(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues)
+{
+	for(int nIdxBytes = 0; nIdxBytes < bCntBytes; nIdxBytes++)
+	{
+		int nAddr = bAddress + nIdxBytes;
+		if(IOXP_IS_ADDR_CACHEABLE(nAddr))
+		{
+			rgbShadow[nAddr] = rgbValues[nIdxBytes];
+			rgbShadowValid[nAddr >> 3] |= (1 << (nAddr & 7));
+		}
+	}
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::IsShadowValid                                                 */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		IsShadowValid(bAddress);                                        */
+/*	Parameters:                                                         */  
+/*		uint8_t bAddress - the register address                         */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		bool - true if the shadow holds the value of the register       */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns true if the register was written or read since the      */
+/*		last invalidation of the register cache.                        */
+/* -------------------------------------------------------------------- */
+
+bool IOXP::IsShadowValid(uint8_t bAddress)
+{
+	return IOXP_IS_ADDR_CACHEABLE(bAddress) && (rgbShadowValid[bAddress >> 3] & (1 << (bAddress & 7))) != 0;
+}
+
 /* -------------------------------------------------------------------- */
 /*	IOXP::ReadMaskedRegisterValue                                       */
 /*                                                                      */
@@ -214,18 +784,15 @@ uint8_t IOXP::ReadMaskedRegisterValue(uint8_t bAddress, uint8_t bMask)
 /*	Description:                                                        */
 /*		Returns the scale corresponding to the mask (the number of bits */ 
 /*  	that the mask value must be shifted right so that the LSB is 1) */
+/*		A zero mask returns 0. The scale is the count of trailing zero  */
+/*		bits (IOXP_CTZ), without a loop over the mask. The IOXPField    */
+/*		descriptors compute it at compile time and do not use this      */
+/*		function.                                                       */
 /* -------------------------------------------------------------------- */
 
 uint8_t IOXP::Mask2Scale(uint8_t bMask)
 {
-	uint8_t bResult = 0;
-	uint8_t bVal = bMask;
-	while((bMask & 1) == 0)
-	{	
-		bMask >>= 1;
-		bResult++;
-	}
-	return bResult;
+	return (bMask == 0) ? 0 : (uint8_t)IOXP_CTZ(bMask);
 }
 
 /* -------------------------------------------------------------------- */
@@ -250,13 +817,44 @@ uint8_t IOXP::Mask2Scale(uint8_t bMask)
 int IOXP::GetKeyVal(uint8_t bRow, uint8_t bCol)
 {	
 	int iKeyVal = -1; 
-	if(bRow <= IOXP_KB_ROWS && bCol <= IOXP_KB_COLS)
+	if(bRow < IOXP_KB_ROWS && bCol < IOXP_KB_COLS)
 	{
-		iKeyVal = keyMap[bRow][bCol];
+		iKeyVal = GetKeyMapVal(bRow * IOXP_KB_COLS + bCol);
 	}
 	return iKeyVal;
 }
 
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetKeyIdxByVal                                                */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GetKeyIdxByVal(iKeyVal);                                        */
+/*	Parameters:                                                         */  
+/*	 	int iKeyVal		- the key value                                 */
+/*  Return Value:                                                       */
+/*		uint8_t - the key index (row * IOXP_KB_COLS + col) of the first */
+/*				  key having this value, 0xFF if none                   */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Lookup in the reverse index built by SetKeyMap, a hash table    */
+/*		filled to at most 88 / 128: about 2 probes for a value found.   */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::GetKeyIdxByVal(int iKeyVal)
+{
+	if(iKeyVal != -1)
+	{
+		for(uint8_t bSlot = KeyHash(iKeyVal); rgbKeyHash[bSlot] != 0xFF; bSlot = (bSlot + 1) & (IOXP_KEY_HASH_SLOTS - 1))
+		{
+			if(GetKeyMapVal(rgbKeyHash[bSlot]) == iKeyVal)
+			{
+				return rgbKeyHash[bSlot];
+			}
+		}
+	}
+	return 0xFF;
+}
+
 /* -------------------------------------------------------------------- */
 /*	IOXP::GetKeyByVal                                                   */
 /*                                                                      */
@@ -280,26 +878,43 @@ int IOXP::GetKeyVal(uint8_t bRow, uint8_t bCol)
 /*      column information. If no key corresponds to the specified key  */
 /*      value, row and value get 0xFF value. If more keys correspond to */
 /*      the specified key value, the first found key will be used.      */ 
+/*		The key is found with the reverse index built by SetKeyMap,     */
+/*		see GetKeyIdxByVal.                                             */
 /* -------------------------------------------------------------------- */
 
 void IOXP::GetKeyByVal(int iKeyVal, uint8_t &bRow, uint8_t &bCol)
 {	
+	uint8_t bKeyIdx = GetKeyIdxByVal(iKeyVal);
 	bRow = 0xFF;
 	bCol = 0xFF;
-	for(int idxRows = 0; idxRows < IOXP_KB_ROWS; idxRows++)       
+	if(bKeyIdx != 0xFF)
 	{
-		for(int idxCols = 0; idxCols < IOXP_KB_COLS; idxCols++)        
-		{
-			if(keyMap[idxRows][idxCols] == iKeyVal)
-			{
-				// first occurrence of iKeyVal in the table
-				bRow = idxRows;
-				bCol = idxCols;
-				idxRows = IOXP_KB_ROWS;	// force out
-				idxCols = IOXP_KB_COLS; // force out
-			}
-		}
+		bRow = bKeyIdx / IOXP_KB_COLS;
+		bCol = bKeyIdx % IOXP_KB_COLS;
 	}
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::KeyHash                                                       */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		KeyHash(iKeyVal);                                               */
+/*	Parameters:                                                         */  
+/*	 	int iKeyVal		- the key value                                 */
+/*                                                                      */
+/*  Return Value:                                                       */
+/*		uint8_t - the first slot of rgbKeyHash to look at               */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Multiplicative (Fibonacci) hash of the key value.               */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::KeyHash(int iKeyVal)
+{
+	uint32_t dwHash = (uint32_t)iKeyVal * (uint32_t)2654435761UL;
+	return (uint8_t)(dwHash >> (32 - IOXP_KEY_HASH_BITS));
 }   
 
 /* -------------------------------------------------------------------- */
@@ -348,12 +963,14 @@ void IOXP::GetKeyByVal(int iKeyVal, uint8_t &bRow, uint8_t &bCol)
 /*								0 - GPI/logic is inactive               */                                                     
 /*						                                                */
 /*  Return Value:                                                       */
-/*		void 	                                                        */
+/*		uint8_t - the event kind, one of IOXP_EVENT_KIND_...            */
 /*                                                                      */
 /*	Errors:                                                             */
 /*                                                                      */
 /*	Description:                                                        */
 /*		Decodes the information corresponding to a specific event.      */
+/*		The fields are taken from the rgEvtDesc table, indexed by the   */
+/*		event identifier; only the key value needs the key map.         */
 /*		If the event is a key event, key value, row and column the      */
 /*      information corresponding to the key are stored in output       */
 /*		parameters while the other parameters corresponding to GPI      */
@@ -367,50 +984,47 @@ void IOXP::GetKeyByVal(int iKeyVal, uint8_t &bRow, uint8_t &bCol)
 /*		and to Key events are set to -1 (keyVal) and 0xFF respectively. */                                                      
 /* -------------------------------------------------------------------- */
 
-void IOXP::DecodeEvent(uint8_t bEvent, int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+uint8_t IOXP::DecodeEvent(uint8_t bEvent, int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
 {
-	bEventState = (bEvent & 0x80) != 0 ? 1: 0;
-	uint8_t bEventNo = bEvent & 0x7F;
-	iKeyVal = -1; // default value
-	bRow = 0xFF; // default value
-	bCol = 0xFF; // default value
-	bGPI = 0xFF; // default value
-	bLogic = 0xFF; // default value
-	if(bEventNo >= 1 && bEventNo <= IOXP_KB_ROWS * IOXP_KB_COLS)
-	{
-		// (Row, Column)
-		// decode the row and column by the event number
-		bRow = (uint8_t)((bEventNo - 1)/IOXP_KB_COLS);
-		bCol = bEventNo - 1 - IOXP_KB_COLS * bRow;
-		iKeyVal = GetKeyVal(bRow, bCol);
-	}
-	else
-	{
-		if(/*bEventNo >= 1 + IOXP_KB_ROWS * IOXP_KB_COLS && */bEventNo <= 1 + IOXP_KB_ROWS * (IOXP_KB_COLS + 1))
-		{
-			// (Row, GND)
-			// bCol remains 0xFF, corresponding to GND
-			// decode the row by the event number
-			bRow = bEventNo - (1 + IOXP_KB_ROWS * IOXP_KB_COLS);
-		}
-		else
-		{
-			if(/*bEventNo >= 1 + IOXP_KB_ROWS * (IOXP_KB_COLS + 1) && */bEventNo <= 1 + IOXP_KB_ROWS * (IOXP_KB_COLS + 1) + IOXP_GPIOS)
-			{
-				// GPI
-				// decode the GPI number by the event number
-				bGPI = bEventNo - (IOXP_KB_ROWS * (IOXP_KB_COLS + 1));
-			}
-			else
-			{
-				if(/*bEventNo >= 1 + IOXP_KB_ROWS * (IOXP_KB_COLS + 1) + IOXP_GPIOS && */bEventNo <= 1 + IOXP_KB_ROWS * (IOXP_KB_COLS + 1) + IOXP_GPIOS + IOXP_NO_LOGIC)
-				{
-					// Logic
-					// decode the Logic number by the event number
-					bGPI = bEventNo - (IOXP_KB_ROWS * (IOXP_KB_COLS + 1) + IOXP_GPIOS);
-				}
-			}
-		}
+	const IOXPEventDesc &desc = rgEvtDesc[bEvent & 0x7F];
+	bEventState = bEvent >> 7;
+	bRow = desc.bRow;
+	bCol = desc.bCol;
+	bGPI = desc.bGPI;
+	bLogic = desc.bLogic;
+	// the key map is always read (bKeyIdx is valid for every event), then selected without a branch
+	int iMapVal = GetKeyMapVal(desc.bKeyIdx);
+	iKeyVal = (desc.bKind == IOXP_EVENT_KIND_KEY) ? iMapVal : -1;
+	return desc.bKind;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetKeyMapVal                                                  */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GetKeyMapVal(bKeyIdx);                                          */
+/*	Parameters:                                                         */  
+/*	 	uint8_t bKeyIdx	- the key index, row * IOXP_KB_COLS + column    */
+/*                                                                      */
+/*  Return Value:                                                       */
+/*		int - the value of the key in the key map                       */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Reads one element of the key map, whatever its element size.    */
+/* -------------------------------------------------------------------- */
+
+int IOXP::GetKeyMapVal(uint8_t bKeyIdx)
+{
+	switch(bKeyMapElemSize)
+	{
+		case 1:
+			return ((const int8_t *)pvKeyMap)[bKeyIdx];
+		case 2:
+			return ((const int16_t *)pvKeyMap)[bKeyIdx];
+		default:
+			return ((const int32_t *)pvKeyMap)[bKeyIdx];
 	}
 }
 
@@ -463,11 +1077,18 @@ void IOXP::DecodeEvent(uint8_t bEvent, int &iKeyVal, uint8_t &bRow, uint8_t &bCo
 /*		will be used. Its LSB 7 bits correspond to the event identifier */
 /*		(96 keys, 19 GPIs, 2 Logics). The MSB bit correspond to the     */
 /*		event state. The last five parameters have default values       */ 
+/*		The identifier is the first identifier of the event kind        */
+/*		(rgbEvtIdFirst) plus the index of the key, row, GPI or Logic.   */
+/*		0xFF is returned if the parameters do not describe an event.    */
+/*		This is the inverse of the rgEvtDesc decode table without a     */
+/*		second table: extras/host/TestEvents checks both directions     */
+/*		over every event byte.                                          */
 /* -------------------------------------------------------------------- */
 
 uint8_t IOXP::EncodeEvent(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
 {
-	uint8_t bEvent = 0xFF;
+	uint8_t bKind = IOXP_EVENT_KIND_NONE;
+	uint8_t bIdx = 0;	// index of the event within its kind
 	if((iKeyVal != -1) || (bRow != 0xFF) || (bCol != 0xFF))
 	{	// keyboard event
 		if(iKeyVal != -1 && bRow == 0xFF && bCol == 0xFF)
@@ -475,38 +1096,36 @@ uint8_t IOXP::EncodeEvent(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI,
 			// if key value is defined and row and columns are not defined
 			GetKeyByVal(iKeyVal, bRow, bCol); 
 		}
-		if(bRow != 0xFF)
+		if(bRow < IOXP_KB_ROWS)
 		{
 			if(bCol == 0xFF)
 			{
 				// GND
-				bEvent = 1 + IOXP_KB_ROWS * IOXP_KB_COLS + bRow;
+				bKind = IOXP_EVENT_KIND_GND;
+				bIdx = bRow;
 			}
-			else
+			else if(bCol < IOXP_KB_COLS)
 			{
-				bEvent = 1 + bRow * IOXP_KB_COLS + bCol;
+				bKind = IOXP_EVENT_KIND_KEY;
+				bIdx = bRow * IOXP_KB_COLS + bCol;
 			}
 		}
 	}
-	else
-	{
-		if(bGPI >= 1 && bGPI <= IOXP_GPIOS)
-		{	// GPI event
-			bEvent = 1 + IOXP_KB_ROWS * (IOXP_KB_COLS + 1) + bGPI;
-		}
-		else
-		{
-			if(bLogic >= 0 && bLogic <= IOXP_NO_LOGIC)
-			{	// Logic event
-				bEvent = 1 + IOXP_KB_ROWS * (IOXP_KB_COLS + 1) + IOXP_GPIOS + bLogic;
-			}
-		}
+	else if(bGPI >= 1 && bGPI <= IOXP_GPIOS)
+	{	// GPI event
+		bKind = IOXP_EVENT_KIND_GPI;
+		bIdx = bGPI - 1;
 	}
-	if(bEvent != 0xFF)
+	else if(bLogic >= 1 && bLogic <= IOXP_NO_LOGIC)
+	{	// Logic event
+		bKind = IOXP_EVENT_KIND_LOGIC;
+		bIdx = bLogic - 1;
+	}
+	if(bKind == IOXP_EVENT_KIND_NONE)
 	{
-		bEvent += bEventState != 0 ? 0x80 : 0;
+		return 0xFF;
 	}
-	return bEvent;
+	return (rgbEvtIdFirst[bKind] + bIdx) | (bEventState != 0 ? 0x80 : 0);
 }
 
 /* -------------------------------------------------------------------- */
@@ -514,21 +1133,103 @@ uint8_t IOXP::EncodeEvent(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI,
 /*                                                                      */
 /*	Synopsis:                                                           */
 /*		myIOXP.begin();                                                 */
+/*		myIOXP.begin(IOXP_BEGIN_RESET_CFG);                             */
+/*		myIOXP.begin(0, IOXPImage<MyCfg>::rgbImage);                    */
 /*	Parameters:                                                         */  
-/*	 	void                                                            */
+/*	 	uint8_t bOptions		- IOXP_BEGIN_... flags, 0 by default    */
+/*		const uint8_t *rgbImage	- optional configuration image          */
+/*								  (IOXP_CFG_IMAGE_SIZE values of the    */
+/*								  registers IOXP_CFG_FIRST -            */
+/*								  IOXP_CFG_LAST), NULL by default       */
 /*  Return Value:                                                       */
-/*		void                                                            */
+/*		uint8_t - IOXP_I2C_OK, an IOXP_I2C_ERR_... value if the device  */
+/*				  did not answer, or IOXP_ERR_DEVICE_ID                 */
 /*                                                                      */
 /*	Errors:                                                             */
+/*		The initialization stops at the first error.                    */
 /*                                                                      */
 /*	Description:                                                        */
 /*		This function initializes the I2C interface #1 that is used to */
 /*		communicate with PmodIOXP.                                      */ 
+/*		It initializes the Wire object given to the constructor. When   */
+/*		several objects share a bus, calling it once is enough (pass    */
+/*		IOXP_BEGIN_NO_WIRE to the others).                              */
+/*		Then it reads the registers ID - GPI_STATUS_C in one burst:     */
+/*		this checks the MAN_ID of the device, empties the event FIFO    */
+/*		and clears the GPI interrupts left from before an MCU reset     */
+/*		(the key state is cleared too). The pending INT_STATUS bits are */
+/*		then cleared. Finally rgbImage, or the reset values with        */
+/*		IOXP_BEGIN_RESET_CFG, is written to the configuration registers */
+/*		in two bursts. The GPI states are then read as the reference of */
+/*		the resync done after a FIFO overflow (see ResyncState).        */
+/*		The duration is kept for GetBeginTimeUS. The bus traffic is at  */
+/*		most 5 transactions and about 110 bytes: 11 ms at 100 kHz and   */
+/*		3 ms at 400 kHz.                                                */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::begin(uint8_t bOptions, const uint8_t *rgbImage)
+{
+	uint8_t rgbVals[IOXP_ADDR_VOLATILE_LAST + 1];
+	uint8_t bStatus;
+	uint32_t dwStartUS = micros();
+	if(!(bOptions & IOXP_BEGIN_NO_WIRE))
+	{
+		pWire->begin();
+	}
+	InvalidateRegisterCache();
+	ClearKeyState();
+	fIntPending = false;	// an edge after this point is a new interrupt
+	bStatus = ReadBytesI2C(IOXP_ADDR_ID, sizeof(rgbVals), rgbVals);
+	dwLastFifoUS = micros();
+	if(bStatus == IOXP_I2C_OK && 
+		((rgbVals[IOXP_ADDR_ID] & IOXP_FIELD_MAN_ID::bFieldMask) >> IOXP_FIELD_MAN_ID::bShift) != IOXP_ID_MAN_ID_ADP5589)
+	{
+		bStatus = IOXP_ERR_DEVICE_ID;
+	}
+	if(bStatus == IOXP_I2C_OK)
+	{
+		// write 1 to clear; the FIFO is empty now so EVENT_INT stays cleared
+		rgbVals[0] = (uint8_t)IOXP_INT_STATUS_ALL;
+		bStatus = WriteBytesI2C(IOXP_ADDR_INT_STATUS, 1, rgbVals);
+	}
+	if(bStatus == IOXP_I2C_OK && rgbImage == NULL && (bOptions & IOXP_BEGIN_RESET_CFG))
+	{
+		rgbImage = IOXPImage<IOXPDefaultConfig>::rgbImage;
+	}
+	if(bStatus == IOXP_I2C_OK && rgbImage != NULL)
+	{
+		bStatus = ApplyConfigImage(rgbImage);	// the cache is empty, so the whole image is written
+	}
+	dwGpiResync = 0;
+	if(bStatus == IOXP_I2C_OK)
+	{
+		uint32_t dwEventEn;
+		bStatus = ReadGpiState(dwGpiActive, dwEventEn);	// reference for the resync after a FIFO overflow
+	}
+	bLastIntStatus = 0;
+	dwBeginUS = micros() - dwStartUS;
+	return bStatus;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetBeginTimeUS                                                */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GetBeginTimeUS();                                               */
+/*	Parameters:                                                         */  
+/*	 	void                                                            */
+/*  Return Value:                                                       */
+/*		uint32_t - duration of the last begin call (us), 0 before       */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Measured with micros(), Wire.begin included.                    */
 /* -------------------------------------------------------------------- */
 
-void IOXP::begin()
+uint32_t IOXP::GetBeginTimeUS()
 {
-	Wire.begin();
+	return dwBeginUS;
 }
 
 /* --------------------------------------------------------------------------------------------------------------------------- */
@@ -553,9 +1254,9 @@ void IOXP::begin()
 /*			IOXP_STATUS_LOCK_STAT  				(0x0220)	- LOCK_STAT bit of the Status register                             */
 /*			IOXP_STATUS_LOGIC1_STAT  			(0x0240)	- LOGIC1_STAT bit of the Status register                           */
 /*			IOXP_STATUS_LOGIC2_STAT  	 		(0x0280)	- LOGIC2_STAT bit of the Status register                           */
-/*			IOXP_UNLOCK1_UNLOCK1_STATE	  		(0x3340)	- UNLOCK1_STATE bit of the UNLOCK1 register                        */
-/*			IOXP_UNLOCK2_UNLOCK2_STATE	  		(0x3440)	- UNLOCK2_STATE bit of the UNLOCK2 register                        */
-/*			IOXP_EXT_LOCK_EVENT_EXT_LOCK_STATE	(0x3540)	- EXT_LOCK_STATE bit of the EXT_LOCK register                      */
+/*			IOXP_UNLOCK1_UNLOCK1_STATE	  		(0x3380)	- UNLOCK1_STATE bit of the UNLOCK1 register                        */
+/*			IOXP_UNLOCK2_UNLOCK2_STATE	  		(0x3480)	- UNLOCK2_STATE bit of the UNLOCK2 register                        */
+/*			IOXP_EXT_LOCK_EVENT_EXT_LOCK_STATE	(0x3580)	- EXT_LOCK_STATE bit of the EXT_LOCK register                      */
 /*			IOXP_LOCK_CFG_LOCK_EN	  			(0x3701)	- LOCK_EN bit of the LOCK_CFG register			                   */
 /*			IOXP_RESET1_EVENT_A_RESET1_EVENT_A_LEVEL	(0x3880)	- RESET1_EVENT_A_LEVEL bit of the RESET1_EVENT_A register  */
 /*			IOXP_RESET1_EVENT_B_RESET1_EVENT_B_LEVEL	(0x3980)	- RESET1_EVENT_B_LEVEL bit of the RESET1_EVENT_B register  */
@@ -578,7 +1279,7 @@ void IOXP::begin()
 /*			IOXP_LOGIC_2_LB2_INV				(0x4510)	- LB2_INV bit of the LOGIC_2 register                              */
 /*			IOXP_LOGIC_2_LC2_INV				(0x4520)	- LC2_INV bit of the LOGIC_2 register                              */
 /*			IOXP_LOGIC_2_LY2_INV				(0x4540)	- LY2_INV bit of the LOGIC_2 register                              */
-/*			IOXP_LOGIC_2_LY1_CASCADE			(0x4540)	- LY1_CASCADE bit of the LOGIC_2 register                          */
+/*			IOXP_LOGIC_2_LY1_CASCADE			(0x4580)	- LY1_CASCADE bit of the LOGIC_2 register                          */
 /*			IOXP_LOGIC_FF_CFG_FF1_CLR			(0x4601)	- FF1_CLR bit of the LOGIC_FF_CFG register                         */
 /*			IOXP_LOGIC_FF_CFG_FF1_SET			(0x4602)	- FF1_SET bit of the LOGIC_FF_CFG register                         */
 /*			IOXP_LOGIC_FF_CFG_FF2_CLR			(0x4604)	- FF2_CLR bit of the LOGIC_FF_CFG register                         */
@@ -616,7 +1317,7 @@ void IOXP::begin()
 /*							- GPI_INT bit of the GPI_INT_STAT registers corresponding to GPIO no x  (x between 1 and 19)       */
 /*          IOXP_GPI_STATUS_GPI_STAT(x)		 	((((0x16 + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	                       */
 /*							- GPI_STAT bit of the GPI_STATUS registers corresponding to GPIO no x  (x between 1 and 19)        */
-/*          IOXP_INT_LEVEL_GPI_INT_LEVEL(x)		((((0x38 + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	                       */
+/*          IOXP_INT_LEVEL_GPI_INT_LEVEL(x)		((((0x1E + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	                       */
 /*							- GPI_INT_LEVEL bit of GPI_INT_LEVEL registers corresponding to GPIO no x  (x between 1 and 19)    */
 /*          IOXP_GPO_DATA_OUT_GPO_DATA(x)		((((0x2A + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	                       */
 /*							- GPO_DATA bit of the GPO_DATA_OUT registers corresponding to GPIO no x  (x between 1 and 19)      */
@@ -640,8 +1341,8 @@ void IOXP::begin()
 
 void IOXP::SetRegisterBit(uint16_t wBitDef, uint8_t bBitVal)
 {
-	uint8_t bRegisterAddr = *((uint8_t *)&wBitDef + 1);
-	uint8_t bMask = *(uint8_t *)&wBitDef;
+	uint8_t bRegisterAddr = (uint8_t)(wBitDef >> 8);
+	uint8_t bMask = (uint8_t)wBitDef;
 	WriteMaskedRegisterValue(bRegisterAddr, bMask, (bBitVal != 0) ? 0xFF: 0);
 }
 
@@ -667,9 +1368,9 @@ void IOXP::SetRegisterBit(uint16_t wBitDef, uint8_t bBitVal)
 /*			IOXP_STATUS_LOCK_STAT  				(0x0220)	- LOCK_STAT bit of the Status register                             */
 /*			IOXP_STATUS_LOGIC1_STAT  			(0x0240)	- LOGIC1_STAT bit of the Status register                           */
 /*			IOXP_STATUS_LOGIC2_STAT  	 		(0x0280)	- LOGIC2_STAT bit of the Status register                           */
-/*			IOXP_UNLOCK1_UNLOCK1_STATE	  		(0x3340)	- UNLOCK1_STATE bit of the UNLOCK1 register                        */
-/*			IOXP_UNLOCK2_UNLOCK2_STATE	  		(0x3440)	- UNLOCK2_STATE bit of the UNLOCK2 register                        */
-/*			IOXP_EXT_LOCK_EVENT_EXT_LOCK_STATE	(0x3540)	- EXT_LOCK_STATE bit of the EXT_LOCK register                      */
+/*			IOXP_UNLOCK1_UNLOCK1_STATE	  		(0x3380)	- UNLOCK1_STATE bit of the UNLOCK1 register                        */
+/*			IOXP_UNLOCK2_UNLOCK2_STATE	  		(0x3480)	- UNLOCK2_STATE bit of the UNLOCK2 register                        */
+/*			IOXP_EXT_LOCK_EVENT_EXT_LOCK_STATE	(0x3580)	- EXT_LOCK_STATE bit of the EXT_LOCK register                      */
 /*			IOXP_LOCK_CFG_LOCK_EN	  			(0x3701)	- LOCK_EN bit of the LOCK_CFG register			                   */
 /*			IOXP_RESET1_EVENT_A_RESET1_EVENT_A_LEVEL	(0x3880)	- RESET1_EVENT_A_LEVEL bit of the RESET1_EVENT_A register  */
 /*			IOXP_RESET1_EVENT_B_RESET1_EVENT_B_LEVEL	(0x3980)	- RESET1_EVENT_B_LEVEL bit of the RESET1_EVENT_B register  */
@@ -692,7 +1393,7 @@ void IOXP::SetRegisterBit(uint16_t wBitDef, uint8_t bBitVal)
 /*			IOXP_LOGIC_2_LB2_INV				(0x4510)	- LB2_INV bit of the LOGIC_2 register                              */
 /*			IOXP_LOGIC_2_LC2_INV				(0x4520)	- LC2_INV bit of the LOGIC_2 register                              */
 /*			IOXP_LOGIC_2_LY2_INV				(0x4540)	- LY2_INV bit of the LOGIC_2 register                              */
-/*			IOXP_LOGIC_2_LY1_CASCADE			(0x4540)	- LY1_CASCADE bit of the LOGIC_2 register                          */
+/*			IOXP_LOGIC_2_LY1_CASCADE			(0x4580)	- LY1_CASCADE bit of the LOGIC_2 register                          */
 /*			IOXP_LOGIC_FF_CFG_FF1_CLR			(0x4601)	- FF1_CLR bit of the LOGIC_FF_CFG register                         */
 /*			IOXP_LOGIC_FF_CFG_FF1_SET			(0x4602)	- FF1_SET bit of the LOGIC_FF_CFG register                         */
 /*			IOXP_LOGIC_FF_CFG_FF2_CLR			(0x4604)	- FF2_CLR bit of the LOGIC_FF_CFG register                         */
@@ -730,7 +1431,7 @@ void IOXP::SetRegisterBit(uint16_t wBitDef, uint8_t bBitVal)
 /*							- GPI_INT bit of the GPI_INT_STAT registers corresponding to GPIO no x  (x between 1 and 19)       */
 /*          IOXP_GPI_STATUS_GPI_STAT(x)		 	((((0x16 + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	                       */
 /*							- GPI_STAT bit of the GPI_STATUS registers corresponding to GPIO no x  (x between 1 and 19)        */
-/*          IOXP_INT_LEVEL_GPI_INT_LEVEL(x)		((((0x38 + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	                       */
+/*          IOXP_INT_LEVEL_GPI_INT_LEVEL(x)		((((0x1E + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	                       */
 /*							- GPI_INT_LEVEL bit of GPI_INT_LEVEL registers corresponding to GPIO no x  (x between 1 and 19)    */
 /*          IOXP_GPO_DATA_OUT_GPO_DATA(x)		((((0x2A + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	                       */
 /*							- GPO_DATA bit of the GPO_DATA_OUT registers corresponding to GPIO no x  (x between 1 and 19)      */
@@ -755,8 +1456,8 @@ void IOXP::SetRegisterBit(uint16_t wBitDef, uint8_t bBitVal)
 
 uint8_t IOXP::GetRegisterBit(uint16_t wBitDef)
 {
-	uint8_t bRegisterAddr = *((uint8_t *)&wBitDef + 1);
-	uint8_t bMask = *(uint8_t *)&wBitDef;
+	uint8_t bRegisterAddr = (uint8_t)(wBitDef >> 8);
+	uint8_t bMask = (uint8_t)wBitDef;
 	return ReadMaskedRegisterValue(bRegisterAddr, bMask) != 0;
 }
 
@@ -775,17 +1476,17 @@ uint8_t IOXP::GetRegisterBit(uint16_t wBitDef)
 /*	IOXP_ID_MAN_ID  					(0x00F0)	- MAN_ID[3:0] field of the ID register                                     */
 /*			IOXP_ID_REV_ID  					(0x000F)	- REV_ID[3:0] field of the ID register                             */
 /*			IOXP_INT_STATUS_ALL   				(0x01FF)	- all bits [7:0] of INT_STATUS register                            */
-/*			IOXP_STATUS_EC  					(0x020F)	- EC[4:0] field of the Status register                             */
-/*			IOXP_UNLOCK1_UNLOCK1  				(0x333F)	- UNLOCK1[6:0] field of the UNLOCK1 register                       */
-/*			IOXP_UNLOCK2_UNLOCK2  				(0x343F)	- UNLOCK2[6:0] field of the UNLOCK2 register                       */
-/*			IOXP_EXT_LOCK_EVENT_EXT_LOCK_EVENT	(0x353F)	- EXT_LOCK_EVENT[6:0] field of the EXT_LOCK_EVENT register         */				
-/*			IOXP_UNLOCK_TIMERS_INT_MASK_TIMER  	(0x36F0)	- INT_MASK_TIMER[4:0] field of the UNLOCK_TIMERS register          */
-/*			IOXP_UNLOCK_TIMERS_UNLOCK_TIMER  	(0x360F)	- UNLOCK_TIMER[2:0] field of the UNLOCK_TIMERS register            */
-/*			IOXP_RESET1_EVENT_A_RESET1_EVENT_A  (0x383F)	- RESET1_EVENT_A[6:0] field of the RESET1_EVENT_A register         */
-/*			IOXP_RESET1_EVENT_B_RESET1_EVENT_B  (0x393F)	- RESET1_EVENT_B[6:0] field of the RESET1_EVENT_B register         */
-/*			IOXP_RESET1_EVENT_C_RESET1_EVENT_C  (0x3A3F)	- RESET1_EVENT_C[6:0] field of the RESET1_EVENT_C register         */
-/*			IOXP_RESET2_EVENT_A_RESET2_EVENT_A  (0x3B3F)	- RESET2_EVENT_A[6:0] field of the RESET2_EVENT_A register         */
-/*			IOXP_RESET2_EVENT_B_RESET2_EVENT_B  (0x3C3F)	- RESET2_EVENT_B[6:0] field of the RESET2_EVENT_B register	       */				
+/*			IOXP_STATUS_EC  					(0x021F)	- EC[4:0] field of the Status register                             */
+/*			IOXP_UNLOCK1_UNLOCK1  				(0x337F)	- UNLOCK1[6:0] field of the UNLOCK1 register                       */
+/*			IOXP_UNLOCK2_UNLOCK2  				(0x347F)	- UNLOCK2[6:0] field of the UNLOCK2 register                       */
+/*			IOXP_EXT_LOCK_EVENT_EXT_LOCK_EVENT	(0x357F)	- EXT_LOCK_EVENT[6:0] field of the EXT_LOCK_EVENT register         */				
+/*			IOXP_UNLOCK_TIMERS_INT_MASK_TIMER  	(0x36F8)	- INT_MASK_TIMER[4:0] field of the UNLOCK_TIMERS register          */
+/*			IOXP_UNLOCK_TIMERS_UNLOCK_TIMER  	(0x3607)	- UNLOCK_TIMER[2:0] field of the UNLOCK_TIMERS register            */
+/*			IOXP_RESET1_EVENT_A_RESET1_EVENT_A  (0x387F)	- RESET1_EVENT_A[6:0] field of the RESET1_EVENT_A register         */
+/*			IOXP_RESET1_EVENT_B_RESET1_EVENT_B  (0x397F)	- RESET1_EVENT_B[6:0] field of the RESET1_EVENT_B register         */
+/*			IOXP_RESET1_EVENT_C_RESET1_EVENT_C  (0x3A7F)	- RESET1_EVENT_C[6:0] field of the RESET1_EVENT_C register         */
+/*			IOXP_RESET2_EVENT_A_RESET2_EVENT_A  (0x3B7F)	- RESET2_EVENT_A[6:0] field of the RESET2_EVENT_A register         */
+/*			IOXP_RESET2_EVENT_B_RESET2_EVENT_B  (0x3C7F)	- RESET2_EVENT_B[6:0] field of the RESET2_EVENT_B register	       */				
 /*			IOXP_RESET_CFG_RESET_PULSE_WIDTH	(0x3D03)	- RESET_PULSE_WIDTH[1:0] field of the RESET_PULSE_WIDTH register   */
 /*			IOXP_RESET_CFG_RESET_TRIGGER_TIME	(0x3D1C)	- TRIGGER_TIME[2:0] field of the RESET_PULSE_WIDTH register        */
 /*			IOXP_CLOCK_DIV_CFG_CLK_DIV			(0X433E)	- CFG_CLK_DIV[4:0] field of the CLOCK_DIV register                 */
@@ -813,12 +1514,15 @@ uint8_t IOXP::GetRegisterBit(uint16_t wBitDef)
 /*		position of the group of bits in the register. The group of bits definition is made of two bytes: high byte is the     */
 /*		register address, low byte is the mask corresponding to the specified group of bits. Apart from the pre-defined values */
 /*		listed above, the user may use this function to access any register group of bits, by providing its specification.     */ 
+/*		wBitDef is a run time value, so the shift of the group is computed at each call (Mask2Scale, one trailing zero         */
+/*		count). For a constant definition, SetField<IOXP_FIELD(wBitDef)> and GetField<IOXP_FIELD(wBitDef)> compute it at       */
+/*		compile time.                                                                                                          */
 /* --------------------------------------------------------------------------------------------------------------------------- */
 
 void IOXP::SetRegisterBitsGroup(uint16_t wBitDef, uint8_t bBitsVal)
 {
-	uint8_t bRegisterAddr = *((uint8_t *)&wBitDef + 1);
-	uint8_t bMask = *(uint8_t *)&wBitDef;
+	uint8_t bRegisterAddr = (uint8_t)(wBitDef >> 8);
+	uint8_t bMask = (uint8_t)wBitDef;
 	uint8_t bScale = Mask2Scale(bMask);
 	uint8_t bScaledGroupVal = bBitsVal << bScale;
 	WriteMaskedRegisterValue(bRegisterAddr, bMask, bScaledGroupVal);
@@ -839,17 +1543,17 @@ void IOXP::SetRegisterBitsGroup(uint16_t wBitDef, uint8_t bBitsVal)
 /*			IOXP_ID_MAN_ID  					(0x00F0)	- MAN_ID[3:0] field of the ID register                             */
 /*			IOXP_ID_REV_ID  					(0x000F)	- REV_ID[3:0] field of the ID register                             */
 /*			IOXP_INT_STATUS_ALL   				(0x01FF)	- all bits [7:0] of INT_STATUS register                            */
-/*			IOXP_STATUS_EC  					(0x020F)	- EC[4:0] field of the Status register                             */
-/*			IOXP_UNLOCK1_UNLOCK1  				(0x333F)	- UNLOCK1[6:0] field of the UNLOCK1 register                       */
-/*			IOXP_UNLOCK2_UNLOCK2  				(0x343F)	- UNLOCK2[6:0] field of the UNLOCK2 register                       */
-/*			IOXP_EXT_LOCK_EVENT_EXT_LOCK_EVENT	(0x353F)	- EXT_LOCK_EVENT[6:0] field of the EXT_LOCK_EVENT register         */				
-/*			IOXP_UNLOCK_TIMERS_INT_MASK_TIMER  	(0x36F0)	- INT_MASK_TIMER[4:0] field of the UNLOCK_TIMERS register          */
-/*			IOXP_UNLOCK_TIMERS_UNLOCK_TIMER  	(0x360F)	- UNLOCK_TIMER[2:0] field of the UNLOCK_TIMERS register            */
-/*			IOXP_RESET1_EVENT_A_RESET1_EVENT_A  (0x383F)	- RESET1_EVENT_A[6:0] field of the RESET1_EVENT_A register         */
-/*			IOXP_RESET1_EVENT_B_RESET1_EVENT_B  (0x393F)	- RESET1_EVENT_B[6:0] field of the RESET1_EVENT_B register         */
-/*			IOXP_RESET1_EVENT_C_RESET1_EVENT_C  (0x3A3F)	- RESET1_EVENT_C[6:0] field of the RESET1_EVENT_C register         */
-/*			IOXP_RESET2_EVENT_A_RESET2_EVENT_A  (0x3B3F)	- RESET2_EVENT_A[6:0] field of the RESET2_EVENT_A register         */
-/*			IOXP_RESET2_EVENT_B_RESET2_EVENT_B  (0x3C3F)	- RESET2_EVENT_B[6:0] field of the RESET2_EVENT_B register	       */				
+/*			IOXP_STATUS_EC  					(0x021F)	- EC[4:0] field of the Status register                             */
+/*			IOXP_UNLOCK1_UNLOCK1  				(0x337F)	- UNLOCK1[6:0] field of the UNLOCK1 register                       */
+/*			IOXP_UNLOCK2_UNLOCK2  				(0x347F)	- UNLOCK2[6:0] field of the UNLOCK2 register                       */
+/*			IOXP_EXT_LOCK_EVENT_EXT_LOCK_EVENT	(0x357F)	- EXT_LOCK_EVENT[6:0] field of the EXT_LOCK_EVENT register         */				
+/*			IOXP_UNLOCK_TIMERS_INT_MASK_TIMER  	(0x36F8)	- INT_MASK_TIMER[4:0] field of the UNLOCK_TIMERS register          */
+/*			IOXP_UNLOCK_TIMERS_UNLOCK_TIMER  	(0x3607)	- UNLOCK_TIMER[2:0] field of the UNLOCK_TIMERS register            */
+/*			IOXP_RESET1_EVENT_A_RESET1_EVENT_A  (0x387F)	- RESET1_EVENT_A[6:0] field of the RESET1_EVENT_A register         */
+/*			IOXP_RESET1_EVENT_B_RESET1_EVENT_B  (0x397F)	- RESET1_EVENT_B[6:0] field of the RESET1_EVENT_B register         */
+/*			IOXP_RESET1_EVENT_C_RESET1_EVENT_C  (0x3A7F)	- RESET1_EVENT_C[6:0] field of the RESET1_EVENT_C register         */
+/*			IOXP_RESET2_EVENT_A_RESET2_EVENT_A  (0x3B7F)	- RESET2_EVENT_A[6:0] field of the RESET2_EVENT_A register         */
+/*			IOXP_RESET2_EVENT_B_RESET2_EVENT_B  (0x3C7F)	- RESET2_EVENT_B[6:0] field of the RESET2_EVENT_B register	       */				
 /*			IOXP_RESET_CFG_RESET_PULSE_WIDTH	(0x3D03)	- RESET_PULSE_WIDTH[1:0] field of the RESET_PULSE_WIDTH register   */
 /*			IOXP_RESET_CFG_RESET_TRIGGER_TIME	(0x3D1C)	- TRIGGER_TIME[2:0] field of the RESET_PULSE_WIDTH register        */
 /*			IOXP_CLOCK_DIV_CFG_CLK_DIV			(0X433E)	- CFG_CLK_DIV[4:0] field of the CLOCK_DIV register                 */
@@ -875,12 +1579,15 @@ void IOXP::SetRegisterBitsGroup(uint16_t wBitDef, uint8_t bBitsVal)
 /*		definition is made of two bytes: high byte is the register address, low byte is the mask corresponding to the          */
 /*		specified group of bits. Apart from the pre-defined values listed above, the user may use this function to access any  */
 /*		 register group of bits, by providing its specification.                                                               */ 
+/*		wBitDef is a run time value, so the shift of the group is computed at each call (Mask2Scale, one trailing zero         */
+/*		count). For a constant definition, SetField<IOXP_FIELD(wBitDef)> and GetField<IOXP_FIELD(wBitDef)> compute it at       */
+/*		compile time.                                                                                                          */
 /* --------------------------------------------------------------------------------------------------------------------------- */
 
 uint8_t IOXP::GetRegisterBitsGroup(uint16_t wBitDef)
 {
-	uint8_t bRegisterAddr = *((uint8_t *)&wBitDef + 1);
-	uint8_t bMask = *(uint8_t *)&wBitDef;
+	uint8_t bRegisterAddr = (uint8_t)(wBitDef >> 8);
+	uint8_t bMask = (uint8_t)wBitDef;
 	uint8_t bScale = Mask2Scale(bMask);
 	uint8_t bGroupVal = ReadMaskedRegisterValue(bRegisterAddr, bMask) >> bScale;
 	return bGroupVal;
@@ -1044,218 +1751,559 @@ void IOXP::SetKeyboardPinConfig(uint8_t bRowCfg, uint16_t wColCfg)
 
 void IOXP::ConfigureInterrupt(uint8_t bParExtIntNo, uint16_t wEventMask, void (*pfIntHandler)())
 {
-	int iDummyKeyVal;
-	
 	attachInterrupt(bParExtIntNo, pfIntHandler, FALLING);
 
 	uint8_t bVal = (uint8_t)(wEventMask & 0xFF);
 	WriteBytesI2C(IOXP_ADDR_INT_EN, 1, &bVal);
 }
 
-/* --------------------------------------------------------------------------------------------------------------------------- */
-/*	 IOXP::ReadFIFO                                                                                                            */
-/*                                                                                                                             */
-/*	Synopsis:                                                                                                                  */
-/*		ReadFIFO(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);            */
-/*	Parameters:                                                                                                                */  
-/*	 	int &iKeyVal	- key value - output parameter where the key value will be stored.                                     */
-/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.   */
-/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                              */
-/*						It contains 0xFF value if the event is not a keyboard event.                                           */
-/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                        */ 
-/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)   */
-/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                        */
-/*						It contains 0xFF value if the event is not a GPI event.                                                */
-/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                    */ 
-/*						It contains 0xFF value if the event is not a Logic event.                                              */
-/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                  */
-/*						For keys events:                                                                                       */
-/*								1 - key is pressed                                                                             */
-/*								0 - key is released                                                                            */
-/*						For GPI and Logic events:                                                                              */
-/*								1 - GPI/logic is active                                                                        */
-/*								0 - GPI/logic is inactive                                                                      */
-/*				                                                                                                               */
-/*  Return Value:                                                                                                              */
-/*		void                                                                                                                   */
-/*                                                                                                                             */
-/*	Errors:                                                                                                                    */
-/*                                                                                                                             */
-/*	Description:                                                                                                               */
-/*		   This function reads the last event on FIFO, decodes it and returns the specific information.                        */
-/*              If the event is a key event, key value, row and column the information corresponding to the key are stored     */
-/*			in output parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic)       */
-/*				are set to 0xFF. If the event is a GPI event, the GPI number is stored in bGPI while the other parameters      */
-/*			corresponding to key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF      */
-/*				respectively. If the event is a Logic event, the Logic number is stored in bLogic, while the parameters        */
-/*			corresponding to key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.   */ 
-/* --------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::ConfigureEventQueue                                           */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ConfigureEventQueue(bParExtIntNo, wEventMask, pQueue);          */
+/*	Parameters:                                                         */  
+/*		uint8_t bParExtIntNo	- the external interrupt number (0-4)   */
+/*								  where the INT pin is connected, see   */
+/*								  ConfigureInterrupt                    */
+/*		uint16_t wEventMask		- the interrupts to enable, see         */
+/*								  ConfigureInterrupt                    */
+/*		IOXPEventQueue *pQueue	- the queue that receives the events,   */
+/*								  usually an IOXPEventRing<N>           */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		Nothing is done if bParExtIntNo is larger than 4.               */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Sets up the interrupt driven event pipeline. The falling edge   */
+/*		of INT only marks the object as pending (no I2C traffic in the  */
+/*		interrupt handler); Service, called from loop(), then reads the */
+/*		FIFO, acknowledges INT_STATUS and pushes the decoded events to  */
+/*		pQueue, from where the application pops them.                   */
+/*		INT_CFG is set so that INT is pulsed again when an interrupt is */
+/*		still pending after the acknowledge. The object is marked as    */
+/*		pending, so the first Service call collects the events already  */
+/*		in the FIFO.                                                    */
+/* -------------------------------------------------------------------- */
 
-void IOXP::ReadFIFO(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+void IOXP::ConfigureEventQueue(uint8_t bParExtIntNo, uint16_t wEventMask, IOXPEventQueue *pQueue)
 {
-	uint8_t bEvent;
-	ReadBytesI2C(IOXP_ADDR_FIFO1, 1, &bEvent);
-	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	if(bParExtIntNo >= IOXP_EXT_INT_CNT)
+	{
+		return;
+	}
+	pEvtQueue = pQueue;
+	EnableEventInterrupts(wEventMask);
+	dwIntTimeUS = micros() - IOXP_NO_EDGE_AGE_US;	// not an edge, see IOXP_NO_EDGE_AGE_US
+	fIntPending = true;
+	AttachIntFlag(bParExtIntNo, &fIntPending, &dwIntTimeUS);
 }
 
-/* ------------------------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::SetLockEvent                                                                                                                               */
-/*                                                                                                                                                   */
-/*	Synopsis:                                                                                                                                        */
-/*		SetLockEvent(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);                                    */
-/*	Parameters:                                                                                                                                      */  
-/*		int iKeyVal	- key value                                                                                                                      */
-/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and column information.          */
-/*	    uint8_t bRow	- key row value                                                                                                              */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.                             */
-/*						This parameter has a default value of 0xFF.                                                                                  */
-/*		uint8_t bCol	- key column value                                                                                                           */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event or if the event corresponds  */
-/*						to (Rx, GND). This parameter has a default value of 0xFF.                                                                    */
-/*		uint8_t bGPI	- GPI number.                                                                                                                */
-/*						It contains 0xFF value if the event is not a GPI event.                                                                      */
-/*						This parameter has a default value of 0xFF.                                                                                  */
-/*		uint8_t bLogic	- Logic number.                                                                                                              */
-/*						It contains 0xFF value if the event is not a Logic event.                                                                    */
-/*						This parameter has a default value of 0xFF.                                                                                  */
-/*		uint8_t bEventState - Event state                                                                                                            */
-/*						For keys events:                                                                                                             */
-/*								1 - key is pressed                                                                                                   */
-/*								0 - key is released                                                                                                  */
-/*						For GPI and Logic events:                                                                                                    */
-/*								1 - GPI/logic is active                                                                                              */
-/*								0 - GPI/logic is inactive                                                                                            */
-/*						This parameter has a default value of 1. 	                                                                                 */
-/*		                                                                                                                                             */
-/*  Return Value:                                                                                                                                    */
-/*		 void                                                                                                                                        */
-/*                                                                                                                                                   */
-/*	Errors:                                                                                                                                          */
-/*                                                                                                                                                   */
-/*	Description:                                                                                                                                     */
-/*		This function sets the lock event according to the specified information.It encodes information in the event byte using EncodeEvent function.*/
-/*		When more keys have that same value associated, then only the first one of them will be identified with that value.                          */
-/*		If no key corresponds to the specified key value, no event will be created.                                                                  */
-/*		The last five parameters have default values.                                                                                                */ 
-/* ------------------------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::EnableEventInterrupts                                         */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		EnableEventInterrupts(wEventMask);                              */
+/*	Parameters:                                                         */  
+/*		uint16_t wEventMask	- the interrupts to enable, see             */
+/*							  ConfigureInterrupt                        */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Sets INT_CFG, so that INT is pulsed again when an interrupt is  */
+/*		still pending after the acknowledge, and writes INT_EN.         */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetLockEvent(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+void IOXP::EnableEventInterrupts(uint16_t wEventMask)
 {
-	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
-	if(bEvent != 0xFF)
-	{
-		WriteBytesI2C(IOXP_ADDR_EXT_LOCK_EVENT, 1, &bEvent);	
-	}
+	SetRegisterBit(IOXP_GENERAL_CFG_B_INT_CFG, 1);
+	uint8_t bVal = (uint8_t)(wEventMask & 0xFF);
+	WriteBytesI2C(IOXP_ADDR_INT_EN, 1, &bVal);
 }
 
-/* ------------------------------------------------------------------------------------------------------------------------------ */
-/*	 IOXP::GetLockEvent                                                                                                           */
-/*                                                                                                                                */
-/*	Synopsis:                                                                                                                     */
-/*		GetLockEvent(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);	          */
-/*	Parameters:                                                                                                                   */  
-/*		int &iKeyVal	- key value - output parameter where the key value will be stored.                                        */
-/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.      */
-/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                 */
-/*						It contains 0xFF value if the event is not a keyboard event.                                              */
-/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                           */
-/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)      */
-/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                           */
-/*						It contains 0xFF value if the event is not a GPI event.                                                   */
-/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                       */
-/*						It contains 0xFF value if the event is not a Logic event.                                                 */
-/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                     */
-/*						For keys events:                                                                                          */
-/*								1 - key is pressed                                                                                */
-/*								0 - key is released                                                                               */
-/*						For GPI and Logic events:                                                                                 */
-/*								1 - GPI/logic is active                                                                           */
-/*								0 - GPI/logic is inactive                                                                         */
-/*  Return Value:                                                                                                                 */
-/*		void                                                                                                                      */
-/*                                                                                                                                */
-/*	Errors:                                                                                                                       */
-/*                                                                                                                                */
-/*	Description:                                                                                                                  */
-/*		This function reads the lock event, decodes it and returns the specific information.  If the event is a key event,        */
-/*      key value, row and column the information corresponding to the key are stored in output parameters                        */
-/*		while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.                  */
-/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                 */
-/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                */
-/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                */
-/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.	                          */                                                 
-/* ------------------------------------------------------------------------------------------------------------------------------ */
+/* -------------------------------------------------------------------- */
+/*	IOXP::AttachIntFlag                                                 */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		AttachIntFlag(bParExtIntNo, pfPending, pdwTimeUS);              */
+/*	Parameters:                                                         */  
+/*		uint8_t bParExtIntNo	- the external interrupt number (0-4)   */
+/*		volatile bool *pfPending	- the flag set on each falling edge */
+/*		volatile uint32_t *pdwTimeUS	- receives micros() at the edge */
+/*										  that sets the flag            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Installs the library interrupt handler of bParExtIntNo. The     */
+/*		handler only sets *pfPending, and *pdwTimeUS if the flag was    */
+/*		clear.                                                          */
+/* -------------------------------------------------------------------- */
 
-void IOXP::GetLockEvent(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+void IOXP::AttachIntFlag(uint8_t bParExtIntNo, volatile bool *pfPending, volatile uint32_t *pdwTimeUS)
 {
-	uint8_t bEvent;
-	ReadBytesI2C(IOXP_ADDR_EXT_LOCK_EVENT, 1, &bEvent);
-	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	rgpfIntPending[bParExtIntNo] = NULL;
+	rgpdwIntTimeUS[bParExtIntNo] = pdwTimeUS;
+	rgpfIntPending[bParExtIntNo] = pfPending;
+	attachInterrupt(bParExtIntNo, rgpfIntHandler[bParExtIntNo], FALLING);
 }
 
-/* --------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::SetUnlock1Event                                                                                                      */
-/*  	                                                                                                                       */
-/*	Synopsis:                                                                                                                  */
-/*		SetUnlock1Event(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);           */
-/*	Parameters:                                                                                                                */  
-/*		int iKeyVal	- key value                                                                                                */
-/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and        */
-/*						column information.                                                                                    */
-/*		uint8_t bRow	- key row value                                                                                        */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.       */
-/*						This parameter has a default value of 0xFF.                                                            */
-/*		uint8_t bCol	- key column value                                                                                     */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event        */
-/*						or if the event corresponds to (Rx, GND).                                                              */
-/*						This parameter has a default value of 0xFF.                                                            */
-/*		uint8_t bGPI	- GPI number.                                                                                          */
-/*						It contains 0xFF value if the event is not a GPI event.                                                */
-/*						This parameter has a default value of 0xFF.                                                            */
-/*		uint8_t bLogic	- Logic number.                                                                                        */
-/*						It contains 0xFF value if the event is not a Logic event.                                              */
-/*						This parameter has a default value of 0xFF.                                                            */
-/*		uint8_t bEventState - Event state                                                                                      */
-/*						For keys events:                                                                                       */
-/*								1 - key is pressed                                                                             */
-/*								0 - key is released                                                                            */
-/*						For GPI and Logic events:                                                                              */
-/*								1 - GPI/logic is active                                                                        */
-/*								0 - GPI/logic is inactive                                                                      */
-/*  Return Value:                                                                                                              */
-/*		void                                                                                                                   */
-/*                                                                                                                             */
-/*	Errors:                                                                                                                    */
-/*                                                                                                                             */
-/*	Description:                                                                                                               */
-/*		This function sets the Unlock1 event according to the specified information. It encodes information in the event byte  */
-/*		using EncodeEvent function.	When more keys have that same value associated, then only the first one of them will be    */
-/*		identified with that value. If no key corresponds to the specified key value, no event will be created.                */
-/*		The last five parameters have default values.	                                                                       */ 
-/* --------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::Service                                                       */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		Service();                                                      */
+/*	Parameters:                                                         */  
+/*		bool fPoll	- true to read the device even if no interrupt is   */
+/*					  pending (INT not connected)                       */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - the number of events read from the FIFO               */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		On an I2C error the object stays pending.                       */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Does nothing unless an INT falling edge was seen since the last */
+/*		call, or fPoll is true. Otherwise the events are moved to the   */
+/*		queue given to ConfigureEventQueue, see ServiceDevice.          */
+/*		Call it from loop(), not from an interrupt handler.             */
+/*		The events are timestamped from the micros() value taken by the */
+/*		interrupt handler at the INT edge, which follows the queuing of */
+/*		the first event of the FIFO; the times are estimates with an    */
+/*		error bound, see StampEvent.                                    */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::Service(bool fPoll)
+{
+	uint8_t bCntEvents;
+	bool fEdge = fIntPending;
+	if(!fEdge && !fPoll)
+	{
+		return 0;
+	}
+	uint32_t dwEdgeUS = fEdge ? dwIntTimeUS : dwLastFifoUS;
+	// cleared first, so an edge during the transfers below schedules another pass
+	fIntPending = false;
+	if(ServiceDevice(pEvtQueue, 0, IOXP_SERVICE_PREFETCH, bCntEvents, dwEdgeUS, fEdge) != IOXP_I2C_OK)
+	{
+		fIntPending = true;
+	}
+	return bCntEvents;
+}
 
+/* -------------------------------------------------------------------- */
+/*	IOXP::ServiceDevice                                                 */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ServiceDevice(pQueue, bDevice, bCntPrefetch, bCntEvents,        */
+/*			dwEdgeUS, fExactEdge);                                      */
+/*	Parameters:                                                         */  
+/*		IOXPEventQueue *pQueue	- the queue receiving the events, may   */
+/*								  be NULL                               */
+/*		uint8_t bDevice			- the value of IOXPEvent::bDevice       */
+/*		uint8_t bCntPrefetch	- FIFO entries read together with       */
+/*								  INT_STATUS and STATUS                 */
+/*		uint8_t &bCntEvents		- output: the number of events read     */
+/*		uint32_t dwEdgeUS		- time of the INT edge, no event of the */
+/*								  FIFO is older                         */
+/*		bool fExactEdge			- true if the edge was raised by this   */
+/*								  device, when its first event was      */
+/*								  queued                                */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or the first I2C error encountered        */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		If the second burst fails, the events of the first one and      */
+/*		those of the second one received before the error (popped by    */
+/*		the device) are still delivered.                                */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Reads INT_STATUS, STATUS and the first bCntPrefetch FIFO        */
+/*		entries in one burst, and the other events counted by STATUS in */
+/*		a second one, then, if both reads succeeded, acknowledges the   */
+/*		INT_STATUS bits that were read: on an error the bits stay set   */
+/*		and the next pass reads the FIFO again. Prefetched entries past EC are events queued during the   */
+/*		burst and are kept, see KeepLateEvents. The decoded events are given to the dispatch table (see   */
+/*		SetDispatchTable), and those without a handler are pushed to    */
+/*		pQueue; events that do not fit are counted as dropped. The      */
+/*		events are stamped with StampEvent, between the edge (or the    */
+/*		previous FIFO read when it is later) and the end of the FIFO    */
+/*		read.                                                           */
+/*		A set OVERFLOW_INT is left set until every event counted by EC  */
+/*		was read, as in DrainFIFO. It is then counted as a device FIFO  */
+/*		overflow (in the queue and in the object), the key and GPI      */
+/*		states are resynchronized (see ResyncState) and only then is    */
+/*		the bit cleared. The corrections are delivered after the FIFO   */
+/*		events, as events with IOXP_EVENT_FLAG_RESYNC.                  */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetUnlock1Event(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+uint8_t IOXP::ServiceDevice(IOXPEventQueue *pQueue, uint8_t bDevice, uint8_t bCntPrefetch, uint8_t &bCntEvents,
+	uint32_t dwEdgeUS, bool fExactEdge)
 {
-	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
-	WriteBytesI2C(IOXP_ADDR_UNLOCK1, 1, &bEvent);	
+	uint32_t dwFromUS = dwLastFifoUS;
+	bool fExact = false;
+	if((int32_t)(dwEdgeUS - dwLastFifoUS) > 0)
+	{
+		dwFromUS = dwEdgeUS;
+		fExact = fExactEdge;
+	}
+	uint8_t rgbVals[2 + IOXP_FIFO_DEPTH];
+	bCntEvents = 0;
+	bLastIntStatus = 0;
+	uint8_t bStatus = ReadBytesI2C(IOXP_ADDR_INT_STATUS, 2 + bCntPrefetch, rgbVals);
+	if(bStatus != IOXP_I2C_OK)
+	{
+		return bStatus;
+	}
+	uint8_t bIntStatus = rgbVals[0];
+	bLastIntStatus = bIntStatus;
+	bCntEvents = rgbVals[1] & (uint8_t)IOXP_STATUS_EC;
+	if(bCntEvents > IOXP_FIFO_DEPTH)
+	{
+		bCntEvents = IOXP_FIFO_DEPTH;
+	}
+	uint8_t bCntRead = bCntPrefetch;		// FIFO registers read
+	if(bCntEvents < bCntPrefetch)
+	{
+		bCntEvents = KeepLateEvents(rgbVals + 2, bCntEvents, bCntPrefetch);
+	}
+	else if(bCntEvents > bCntPrefetch)
+	{
+		bStatus = ReadBytesI2C(IOXP_ADDR_FIFO1 + bCntPrefetch, bCntEvents - bCntPrefetch, rgbVals + 2 + bCntPrefetch);
+		bCntRead = bCntEvents;
+		if(bStatus != IOXP_I2C_OK)
+		{
+			// the bytes received were popped and are kept, the others read 0
+			bCntEvents = KeepLateEvents(rgbVals + 2, bCntPrefetch, bCntRead);
+		}
+	}
+	uint32_t dwToUS = micros();
+	// as in DrainFIFO: every event counted by EC was read
+	bool fEmpty = (bStatus == IOXP_I2C_OK && (rgbVals[1] & (uint8_t)IOXP_STATUS_EC) <= bCntRead);
+	if(fEmpty)
+	{
+		dwLastFifoUS = dwToUS;
+	}
+	// acknowledged once the events are read; OVERFLOW_INT is cleared after the resync below
+	uint8_t bAck = bIntStatus & ~(uint8_t)IOXP_INT_STATUS_OVERFLOW_INT;
+	if(bStatus == IOXP_I2C_OK && bAck != 0)
+	{
+		WriteBytesI2C(IOXP_ADDR_INT_STATUS, 1, &bAck);	// write 1 to clear
+	}
+	IOXPEvent evt;
+	for(uint8_t bIdx = 0; bIdx < bCntEvents; bIdx++)
+	{
+		if(!FillEvent(evt, rgbVals[2 + bIdx]))
+		{
+			continue;
+		}
+		StampEvent(evt, bIdx, dwFromUS, dwToUS, fExact);
+		evt.bDevice = bDevice;
+		DeliverEvent(pQueue, evt);
+	}
+	if(fEmpty && (bIntStatus & (uint8_t)IOXP_INT_STATUS_OVERFLOW_INT))
+	{
+		if(pQueue != NULL)
+		{
+			pQueue->dwOverflows++;
+		}
+		ResyncState(dwFromUS, dwToUS);
+		uint8_t bOverflow = (uint8_t)IOXP_INT_STATUS_OVERFLOW_INT;
+		WriteBytesI2C(IOXP_ADDR_INT_STATUS, 1, &bOverflow);	// write 1 to clear
+	}
+	while(NextResyncEvent(evt))
+	{
+		evt.bDevice = bDevice;
+		DeliverEvent(pQueue, evt);
+	}
+	return bStatus;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::DeliverEvent                                                  */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		DeliverEvent(pQueue, evt);                                      */
+/*	Parameters:                                                         */  
+/*		IOXPEventQueue *pQueue	- the queue, can be NULL                */
+/*		const IOXPEvent &evt	- the event                             */
+/*                                                                      */	                                                     
+/*	Description:                                                        */
+/*		Gives the event to the dispatch table, or pushes it to pQueue   */
+/*		if it has no handler. Dropped if there is neither.              */
+/* -------------------------------------------------------------------- */
+
+void IOXP::DeliverEvent(IOXPEventQueue *pQueue, const IOXPEvent &evt)
+{
+	if(pDispatch != NULL && pDispatch->Dispatch(evt))
+	{
+		return;
+	}
+	if(pQueue != NULL)
+	{
+		pQueue->Push(evt);
+	}
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::SetDispatchTable                                              */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		SetDispatchTable(pTable);                                       */
+/*	Parameters:                                                         */  
+/*		IOXPDispatchTable *pTable	- the handlers, NULL to stop the    */
+/*									  dispatch                          */
+/*                                                                      */	                                                     
+/*	Description:                                                        */
+/*		Service (and IOXPGroup::Service) gives each event to the        */
+/*		handler of its identifier and state in pTable. Only the events  */
+/*		without a handler are pushed to the event queue. The table      */
+/*		must be set before OnKey, OnKeyVal, OnGpi and OnLogic.          */
+/* -------------------------------------------------------------------- */
+
+void IOXP::SetDispatchTable(IOXPDispatchTable *pTable)
+{
+	pDispatch = pTable;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::OnKey                                                         */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		OnKey(bRow, bCol, pfnHandler, bStates);                         */
+/*	Parameters:                                                         */  
+/*		uint8_t bRow		- the row, 0 - 7                            */
+/*		uint8_t bCol		- the column, 0 - 10, or IOXP_KB_COL_GND    */
+/*							  for the key between the row and GND       */
+/*		IOXPEventHandler pfnHandler	- the handler, NULL to unsubscribe  */
+/*		uint8_t bStates		- IOXP_ON_PRESS, IOXP_ON_RELEASE or         */
+/*							  IOXP_ON_BOTH                              */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or IOXP_ERR_PARAM                         */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		IOXP_ERR_PARAM if there is no dispatch table or the key is out  */
+/*		of range.                                                       */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Registers the handler for the events of a key. Key events are   */
+/*		always written to the FIFO by the device, nothing is written.   */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::OnKey(uint8_t bRow, uint8_t bCol, IOXPEventHandler pfnHandler, uint8_t bStates)
+{
+	uint8_t bKeyIdx;
+	if(pDispatch == NULL || bRow >= IOXP_KB_ROWS || bCol > IOXP_KB_COL_GND)
+	{
+		return IOXP_ERR_PARAM;
+	}
+	bKeyIdx = (bCol == IOXP_KB_COL_GND) ? (IOXP_KEY_IDX_GND + bRow) : (bRow * IOXP_KB_COLS + bCol);
+	pDispatch->Set(IOXP_EVENT_ID_KEY + bKeyIdx, pfnHandler, bStates);
+	return IOXP_I2C_OK;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::OnKeyVal                                                      */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		OnKeyVal(iKeyVal, pfnHandler, bStates);                         */
+/*	Parameters:                                                         */  
+/*		int iKeyVal			- the value of the key in the key map       */
+/*		IOXPEventHandler pfnHandler	- the handler, NULL to unsubscribe  */
+/*		uint8_t bStates		- IOXP_ON_PRESS, IOXP_ON_RELEASE or         */
+/*							  IOXP_ON_BOTH                              */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or IOXP_ERR_PARAM                         */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		IOXP_ERR_PARAM if there is no dispatch table or no key has this */
+/*		value.                                                          */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Same as OnKey for the first key having iKeyVal in the key map.  */
+/*		The key is looked up once: a later SetKeyMap does not move the  */
+/*		subscription.                                                   */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::OnKeyVal(int iKeyVal, IOXPEventHandler pfnHandler, uint8_t bStates)
+{
+	uint8_t bKeyIdx = GetKeyIdxByVal(iKeyVal);
+	if(pDispatch == NULL || bKeyIdx == 0xFF)
+	{
+		return IOXP_ERR_PARAM;
+	}
+	pDispatch->Set(IOXP_EVENT_ID_KEY + bKeyIdx, pfnHandler, bStates);
+	return IOXP_I2C_OK;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::OnGpi                                                         */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		OnGpi(bGPI, pfnHandler, bStates);                               */
+/*	Parameters:                                                         */  
+/*		uint8_t bGPI		- the GPI number, 1 - 19                    */
+/*		IOXPEventHandler pfnHandler	- the handler, NULL to unsubscribe  */
+/*		uint8_t bStates		- IOXP_ON_PRESS (GPI active),               */
+/*							  IOXP_ON_RELEASE or IOXP_ON_BOTH           */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK, the I2C error of the register update, or */
+/*				  IOXP_ERR_PARAM                                        */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		IOXP_ERR_PARAM if there is no dispatch table or bGPI is out of  */
+/*		range.                                                          */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Registers the handler and sets the GPI_EVENT_EN bit of the GPI  */
+/*		when subscribed, clears it when unsubscribed, so the device     */
+/*		only writes the events of subscribed GPIs to its FIFO. The      */
+/*		other bits of the GPI_EVENT_EN registers are left unchanged.    */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::OnGpi(uint8_t bGPI, IOXPEventHandler pfnHandler, uint8_t bStates)
+{
+	if(pDispatch == NULL || bGPI < 1 || bGPI > IOXP_GPIOS)
+	{
+		return IOXP_ERR_PARAM;
+	}
+	uint16_t wRegBit = IOXP_GPI_EVENT_EN_GPI_EVENT_EN(bGPI);
+	bool fSubscribed = (pfnHandler != NULL && (bStates & IOXP_ON_BOTH));
+	pDispatch->Set(IOXP_EVENT_ID_GPI + bGPI - 1, pfnHandler, bStates);
+	bLastI2CStatus = IOXP_I2C_OK;
+	WriteMaskedRegisterValue(wRegBit >> 8, wRegBit & 0xFF, fSubscribed ? 0xFF : 0);
+	return bLastI2CStatus;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::OnLogic                                                       */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		OnLogic(bLogic, pfnHandler, bStates);                           */
+/*	Parameters:                                                         */  
+/*		uint8_t bLogic		- the logic block, 1 or 2                   */
+/*		IOXPEventHandler pfnHandler	- the handler, NULL to unsubscribe  */
+/*		uint8_t bStates		- IOXP_ON_PRESS (output active),            */
+/*							  IOXP_ON_RELEASE or IOXP_ON_BOTH           */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK, the I2C error of the register update, or */
+/*				  IOXP_ERR_PARAM                                        */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		IOXP_ERR_PARAM if there is no dispatch table or bLogic is out   */
+/*		of range.                                                       */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Same as OnGpi for the output of a logic block: the              */
+/*		LOGICx_EVENT_EN bit of LOGIC_INT_EVENT_EN follows the           */
+/*		subscription.                                                   */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::OnLogic(uint8_t bLogic, IOXPEventHandler pfnHandler, uint8_t bStates)
+{
+	if(pDispatch == NULL || bLogic < 1 || bLogic > IOXP_NO_LOGIC)
+	{
+		return IOXP_ERR_PARAM;
+	}
+	uint16_t wRegBit = (bLogic == 1) ? IOXP_LOGIC_INT_EVENT_EN_LOGIC1_EVENT_EN : IOXP_LOGIC_INT_EVENT_EN_LOGIC2_EVENT_EN;
+	bool fSubscribed = (pfnHandler != NULL && (bStates & IOXP_ON_BOTH));
+	pDispatch->Set(IOXP_EVENT_ID_LOGIC + bLogic - 1, pfnHandler, bStates);
+	bLastI2CStatus = IOXP_I2C_OK;
+	WriteMaskedRegisterValue(wRegBit >> 8, wRegBit & 0xFF, fSubscribed ? 0xFF : 0);
+	return bLastI2CStatus;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::IntHandler0 - IOXP::IntHandler4                               */
+/*                                                                      */
+/*	Description:                                                        */
+/*		External interrupt handlers installed by AttachIntFlag, see     */
+/*		SignalInt.                                                      */
+/* -------------------------------------------------------------------- */
+
+void IOXP::IntHandler0()
+{
+	SignalInt(0);
+}
+
+void IOXP::IntHandler1()
+{
+	SignalInt(1);
+}
+
+void IOXP::IntHandler2()
+{
+	SignalInt(2);
+}
+
+void IOXP::IntHandler3()
+{
+	SignalInt(3);
+}
+
+void IOXP::IntHandler4()
+{
+	SignalInt(4);
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::SignalInt                                                     */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		SignalInt(bParExtIntNo);                                        */
+/*	Parameters:                                                         */  
+/*		uint8_t bParExtIntNo	- the external interrupt number (0-4)   */
+/*                                                                      */	                                                     
+/*	Description:                                                        */
+/*		Interrupt context. Sets the pending flag attached to the        */
+/*		interrupt; the first edge after Service cleared the flag also   */
+/*		records micros(), the time base of the event timestamps.        */
+/* -------------------------------------------------------------------- */
+
+void IOXP::SignalInt(uint8_t bParExtIntNo)
+{
+	volatile bool *pfPending = rgpfIntPending[bParExtIntNo];
+	if(pfPending != NULL)
+	{
+		if(!*pfPending)
+		{
+			*rgpdwIntTimeUS[bParExtIntNo] = micros();
+		}
+		*pfPending = true;
+	}
 }
 
 /* --------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetUnlock1Event                                                                                                      */
+/*	 IOXP::ReadFIFO                                                                                                            */
 /*                                                                                                                             */
 /*	Synopsis:                                                                                                                  */
-/*		GetUnlock1Event(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);	   */
+/*		ReadFIFO(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);            */
 /*	Parameters:                                                                                                                */  
 /*	 	int &iKeyVal	- key value - output parameter where the key value will be stored.                                     */
 /*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.   */
 /*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                              */
 /*						It contains 0xFF value if the event is not a keyboard event.                                           */
-/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                        */
+/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                        */ 
 /*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)   */
 /*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                        */
 /*						It contains 0xFF value if the event is not a GPI event.                                                */
-/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                    */
+/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                    */ 
 /*						It contains 0xFF value if the event is not a Logic event.                                              */
 /*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                  */
 /*						For keys events:                                                                                       */
@@ -1263,224 +2311,1179 @@ void IOXP::SetUnlock1Event(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI
 /*								0 - key is released                                                                            */
 /*						For GPI and Logic events:                                                                              */
 /*								1 - GPI/logic is active                                                                        */
-/*								0 - GPI/logic is inactive                                                                      */                   
-/*		                                                                                                                       */
+/*								0 - GPI/logic is inactive                                                                      */
+/*				                                                                                                               */
 /*  Return Value:                                                                                                              */
 /*		void                                                                                                                   */
 /*                                                                                                                             */
 /*	Errors:                                                                                                                    */
 /*                                                                                                                             */
 /*	Description:                                                                                                               */
-/*		This function reads the Unlock1 event, decodes it and returns the specific information.                                */
-/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in          */
-/*		output parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to   */
-/*		0xFF. If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to        */
-/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.             */
-/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to             */
-/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.	                       */ 
+/*		   This function reads the last event on FIFO, decodes it and returns the specific information.                        */
+/*              If the event is a key event, key value, row and column the information corresponding to the key are stored     */
+/*			in output parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic)       */
+/*				are set to 0xFF. If the event is a GPI event, the GPI number is stored in bGPI while the other parameters      */
+/*			corresponding to key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF      */
+/*				respectively. If the event is a Logic event, the Logic number is stored in bLogic, while the parameters        */
+/*			corresponding to key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.   */ 
+/*			The real release of a key already released by a FIFO overflow resync is dropped (see TrackEventState): all the     */
+/*			fields are then returned as for an empty FIFO, -1 and 0xFF, with bEventState 0.                                    */
 /* --------------------------------------------------------------------------------------------------------------------------- */
 
-void IOXP::GetUnlock1Event(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+void IOXP::ReadFIFO(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
 {
 	uint8_t bEvent;
-	ReadBytesI2C(IOXP_ADDR_UNLOCK1, 1, &bEvent);
+	ReadBytesI2C(IOXP_ADDR_FIFO1, 1, &bEvent);
+	if(!TrackEventState(bEvent))
+	{
+		bEvent = 0;		// dropped: decoded as an empty entry
+	}
 	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
 }
 
-/* -------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::SetUnlock2Event                                                                                                     */
-/*                                                                                                                            */
-/*	Synopsis:                                                                                                                 */
-/*		SetUnlock2Event(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);          */
-/*	Parameters:                                                                                                               */  
-/*	 	int iKeyVal	- key value                                                                                               */
-/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and       */
-/*						column information.                                                                                   */
-/*		uint8_t bRow	- key row value                                                                                       */
-/*					    It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.      */
-/*						This parameter has a default value of 0xFF.                                                           */
-/*		uint8_t bCol	- key column value                                                                                    */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event or    */
-/*						if the event corresponds to (Rx, GND).                                                                */
-/*						This parameter has a default value of 0xFF.                                                           */
-/*		uint8_t bGPI	- GPI number.                                                                                         */
-/*						It contains 0xFF value if the event is not a GPI event.                                               */
-/*						This parameter has a default value of 0xFF.                                                           */
-/*		uint8_t bLogic	- Logic number.                                                                                       */
-/*						It contains 0xFF value if the event is not a Logic event.                                             */
-/*						This parameter has a default value of 0xFF.                                                           */
-/*		uint8_t bEventState - Event state                                                                                     */
-/*						For keys events:                                                                                      */
-/*								1 - key is pressed                                                                            */
-/*								0 - key is released                                                                           */
-/*						For GPI and Logic events:                                                                             */
-/*								1 - GPI/logic is active                                                                       */
-/*								0 - GPI/logic is inactive                                                                     */
-/*						This parameter has a default value of 1.                                                              */                                                                                                                   
-/*  Return Value:                                                                                                             */
-/*		void                                                                                                                  */
-/*                                                                                                                            */
-/*	Errors:                                                                                                                   */
-/*                                                                                                                            */
-/*	Description:                                                                                                              */
-/*		This function sets the Unlock2 event according to the specified information. It encodes information in the event      */
-/*		byte using EncodeEvent function. When more keys have that same value associated, then only the first one of them      */
-/*		will be identified with that value. If no key corresponds to the specified key value, no event will be created.       */
-/*      The last five parameters have default values.                                                                         */ 
-/* -------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::FillEvent                                                     */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		FillEvent(evt, bEvent);                                         */
+/*	Parameters:                                                         */  
+/*		IOXPEvent &evt	- the event structure to fill                   */
+/*		uint8_t bEvent	- the raw FIFO event byte                       */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		bool - false if the event must be dropped, see TrackEventState  */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Stores the raw event and its decoded fields in evt, and updates */
+/*		the key state.                                                  */
+/* -------------------------------------------------------------------- */
 
+bool IOXP::FillEvent(IOXPEvent &evt, uint8_t bEvent)
+{
+	evt.bEvent = bEvent;
+	evt.bDevice = 0;
+	evt.bFlags = 0;
+	evt.bKind = DecodeEvent(bEvent, evt.iKeyVal, evt.bRow, evt.bCol, evt.bGPI, evt.bLogic, evt.bEventState);
+	return TrackEventState(bEvent);
+}
 
-void IOXP::SetUnlock2Event(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+/* -------------------------------------------------------------------- */
+/*	IOXP::KeepLateEvents                                                */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		bCntEvents = KeepLateEvents(rgbFifo, bCntEvents, bCntRead);     */
+/*	Parameters:                                                         */  
+/*		uint8_t *rgbFifo	- the FIFO registers read in one burst      */
+/*		uint8_t bCntEvents	- the EC field of STATUS read before them   */
+/*		uint8_t bCntRead	- the number of FIFO registers read         */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - the number of events in rgbFifo                       */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Every FIFO register read pops an entry, so the registers read   */
+/*		past EC hold the events queued by the device after STATUS was   */
+/*		clocked out. An empty FIFO reads 0, which is not an event       */
+/*		identifier: the non-zero entries past EC are moved after the    */
+/*		first bCntEvents ones, instead of being lost.                   */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::KeepLateEvents(uint8_t *rgbFifo, uint8_t bCntEvents, uint8_t bCntRead)
 {
-	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
-	WriteBytesI2C(IOXP_ADDR_UNLOCK2, 1, &bEvent);	
+	for(uint8_t bIdx = bCntEvents; bIdx < bCntRead; bIdx++)
+	{
+		if(rgbFifo[bIdx] != 0)
+		{
+			rgbFifo[bCntEvents++] = rgbFifo[bIdx];
+		}
+	}
+	return bCntEvents;
 }
 
-/* -------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetUnlock2Event                                                                                                           */
-/*                                                                                                                                  */
-/*	Synopsis:                                                                                                                       */
-/*		GetUnlock2Event(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);          */
-/*	Parameters:                                                                                                                     */  
-/*	 	 int &iKeyVal	- key value - output parameter where the key value will be stored.                                          */
-/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.        */
-/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                   */
-/*						It contains 0xFF value if the event is not a keyboard event.                                                */
-/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                             */
-/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)        */
-/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                             */
-/*						It contains 0xFF value if the event is not a GPI event.                                                     */
-/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                         */
-/*						It contains 0xFF value if the event is not a Logic event.                                                   */
-/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                       */
-/*						For keys events:                                                                                            */
-/*								1 - key is pressed                                                                                  */
-/*								0 - key is released                                                                                 */
-/*						For GPI and Logic events:                                                                                   */
-/*								1 - GPI/logic is active                                                                             */
-/*								0 - GPI/logic is inactive                                                                           */
-/*						                                                                                                            */
-/*  Return Value:                                                                                                                   */
-/*		 void                                                                                                                       */
-/*                                                                                                                                  */
-/*	Errors:                                                                                                                         */
-/*                                                                                                                                  */
-/*	Description:                                                                                                                    */
-/*		This function reads the Unlock2 event, decodes it and returns the specific information.                                     */
-/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in output        */
-/*		parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.         */
-/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                   */
-/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                  */
-/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                  */
-/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.                             */ 
-/* -------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::StampEvent                                                    */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		StampEvent(evt, bIdx, dwFromUS, dwToUS, fExact);                */
+/*	Parameters:                                                         */  
+/*		IOXPEvent &evt		- the decoded event                         */
+/*		uint8_t bIdx		- position of the event in the FIFO read    */
+/*		uint32_t dwFromUS	- no event of the read is older             */
+/*		uint32_t dwToUS		- end of the FIFO read                      */
+/*		bool fExact			- dwFromUS is the INT edge raised by the    */
+/*							  first event of the read                   */
+/*                                                                      */	                                                     
+/*	Description:                                                        */
+/*		Sets dwTimeUS and dwTimeErrUS. The events of a read were queued */
+/*		in FIFO order between dwFromUS and dwToUS. Key events come from */
+/*		the scans of the matrix (KEY_POLL_TIME, from the register       */
+/*		shadow, 10 ms if unknown), but the FIFO does not tell which     */
+/*		events share a scan, so the spacing is only an estimate: event  */
+/*		bIdx is placed bIdx scan intervals after dwFromUS, but not      */
+/*		after dwToUS; the other events are placed at dwFromUS. The      */
+/*		error is the distance to the farthest end of the window, so it  */
+/*		holds whatever the real spacing was.                            */
+/*		With fExact the first event is placed at the edge, which only   */
+/*		follows its queuing by the interrupt latency; the device may    */
+/*		also have detected it up to one scan interval after the pin     */
+/*		changed (key debounce), so its error is one scan interval.      */
+/*		GPI events are debounced in a few core clock cycles (CORE_FREQ) */
+/*		and get the same bound.                                         */
+/* -------------------------------------------------------------------- */
 
+void IOXP::StampEvent(IOXPEvent &evt, uint8_t bIdx, uint32_t dwFromUS, uint32_t dwToUS, bool fExact)
+{
+	uint32_t dwWindowUS = dwToUS - dwFromUS;
+	uint32_t dwOffsetUS = 0;
+	uint32_t dwScanUS = 10000;
+	if(IsShadowValid(IOXP_ADDR_POLL_TIME_CFG))
+	{
+		dwScanUS = 10000UL * (1 + (rgbShadow[IOXP_ADDR_POLL_TIME_CFG] & IOXP_FIELD_KEY_POLL_TIME::bFieldMask));
+	}
+	if(fExact && bIdx == 0)
+	{
+		evt.dwTimeUS = dwFromUS;
+		evt.dwTimeErrUS = dwScanUS;
+		return;
+	}
+	if(evt.bKind == IOXP_EVENT_KIND_KEY || evt.bKind == IOXP_EVENT_KIND_GND)
+	{
+		dwOffsetUS = dwScanUS * bIdx;
+		if(dwOffsetUS > dwWindowUS)
+		{
+			dwOffsetUS = dwWindowUS;
+		}
+	}
+	evt.dwTimeUS = dwFromUS + dwOffsetUS;
+	evt.dwTimeErrUS = (dwOffsetUS > dwWindowUS - dwOffsetUS) ? dwOffsetUS : (dwWindowUS - dwOffsetUS);
+}
 
-void IOXP::GetUnlock2Event(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+/* -------------------------------------------------------------------- */
+/*	IOXP::TrackEventState                                               */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		TrackEventState(bEvent);                                        */
+/*	Parameters:                                                         */  
+/*		uint8_t bEvent	- the raw FIFO event byte                       */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		bool - false for the release of a key already released by a    */
+/*			   resync, which must not be delivered again                */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Updates the pressed-key bitmap with a key or row-to-GND event,  */
+/*		and the GPI states with a GPI event. Called for each event read */
+/*		from the FIFO or generated by the resync. An event of the FIFO  */
+/*		cancels the resync event not yet delivered for the same input,  */
+/*		it is newer. The first FIFO event of a key released by a resync */
+/*		(rgdwKeyResyncUp) is its real release, dropped, or a press,     */
+/*		which proves that the release was lost and counts it.           */
+/* -------------------------------------------------------------------- */
+
+bool IOXP::TrackEventState(uint8_t bEvent)
 {
-	uint8_t bEvent;
-	ReadBytesI2C(IOXP_ADDR_UNLOCK2, 1, &bEvent);
-	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	uint8_t bKeyIdx = (bEvent & 0x7F) - IOXP_EVENT_ID_KEY;
+	if(bKeyIdx >= IOXP_KEY_STATES)	// also an empty FIFO entry (0)
+	{
+		uint8_t bGpiIdx = (bEvent & 0x7F) - IOXP_EVENT_ID_GPI;
+		if(bGpiIdx < IOXP_GPIOS)
+		{
+			dwGpiResync &= ~((uint32_t)1 << bGpiIdx);
+			if(bEvent & 0x80)
+			{
+				dwGpiActive |= (uint32_t)1 << bGpiIdx;
+			}
+			else
+			{
+				dwGpiActive &= ~((uint32_t)1 << bGpiIdx);
+			}
+		}
+		return true;
+	}
+	uint32_t dwBit = (uint32_t)1 << (bKeyIdx & 31);
+	uint32_t &dwKeys = rgdwKeyDown[bKeyIdx >> 5];
+	uint32_t &dwResyncUp = rgdwKeyResyncUp[bKeyIdx >> 5];
+	rgdwKeyResync[bKeyIdx >> 5] &= ~dwBit;
+	if(dwResyncUp & dwBit)
+	{
+		dwResyncUp &= ~dwBit;
+		if(!(bEvent & 0x80))
+		{
+			return false;
+		}
+		dwLostEvents++;		// a press first: the release was lost in the overflow
+	}
+	if(bEvent & 0x80)
+	{
+		if(!(dwKeys & dwBit))
+		{
+			dwKeys |= dwBit;
+			bCntKeysDown++;
+		}
+	}
+	else if(dwKeys & dwBit)
+	{
+		dwKeys &= ~dwBit;
+		bCntKeysDown--;
+	}
+	return true;
 }
 
-/* ---------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::SetReset1EventA                                                                                                       */
-/*                                                                                                                              */
-/*	Synopsis:                                                                                                                   */
-/*		SetReset1EventA(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);            */
-/*	Parameters:                                                                                                                 */  
-/*		int iKeyVal	- key value                                                                                                 */
-/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and column  */
-/*						information.                                                                                            */
-/*		uint8_t bRow	- key row value                                                                                         */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.        */
-/*						This parameter has a default value of 0xFF.                                                             */
-/*		uint8_t bCol	- key column value                                                                                      */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event or if   */
-/*						the event corresponds to (Rx, GND).                                                                     */
-/*						This parameter has a default value of 0xFF.                                                             */
-/*		uint8_t bGPI	- GPI number.                                                                                           */
-/*						It contains 0xFF value if the event is not a GPI event.                                                 */
-/*						This parameter has a default value of 0xFF.                                                             */
-/*		uint8_t bLogic	- Logic number.                                                                                         */
-/*						It contains 0xFF value if the event is not a Logic event.                                               */
-/*						This parameter has a default value of 0xFF.                                                             */
-/*		uint8_t bEventState - Event state                                                                                       */
-/*						For keys events:                                                                                        */
-/*								1 - key is pressed                                                                              */
-/*								0 - key is released                                                                             */
-/*						For GPI and Logic events:                                                                               */
-/*								1 - GPI/logic is active                                                                         */
-/*								0 - GPI/logic is inactive                                                                       */
-/*						This parameter has a default value of 1.	                                                            */
-/*  Return Value:                                                                                                               */
-/*		void                                                                                                                    */
-/*                                                                                                                              */
-/*	Errors:                                                                                                                     */
-/*                                                                                                                              */
-/*	Description:                                                                                                                */
-/*		This function sets the Reset1EventA event according to the specified information. It encodes information in the event   */
-/*		byte using EncodeEvent function. When more keys have that same value associated, then only the first one of them will   */
-/*		be identified with that value. If no key corresponds to the specified key value, no event will be created.              */
-/*      The last five parameters have default values.                                                                           */ 
-/* ---------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::IsKeyDown                                                     */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		IsKeyDown(bRow, bCol);                                          */
+/*	Parameters:                                                         */  
+/*		uint8_t bRow	- the row, 0 - 7                                */
+/*		uint8_t bCol	- the column, 0 - 10, or IOXP_KB_COL_GND for    */
+/*						  the key between the row and GND               */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		bool - true if the last event of the key was a press           */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		false for a row or column out of range.                         */
+/*                                                                      */
+/*	Description:                                                        */
+/*		The state is kept from the events read by ReadFIFO, DrainFIFO   */
+/*		and Service, so it is only up to date when all the events are   */
+/*		read by the library. No I2C access.                             */
+/*		After a FIFO overflow the resync marks every key released (see  */
+/*		ResyncState): a key still held reads false until its next       */
+/*		press.                                                          */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetReset1EventA(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+bool IOXP::IsKeyDown(uint8_t bRow, uint8_t bCol)
 {
-	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
-	WriteBytesI2C(IOXP_ADDR_RESET1_EVENT_A, 1, &bEvent);	
+	uint8_t bKeyIdx;
+	if(bRow >= IOXP_KB_ROWS || bCol > IOXP_KB_COL_GND)
+	{
+		return false;
+	}
+	bKeyIdx = (bCol == IOXP_KB_COL_GND) ? (IOXP_KEY_IDX_GND + bRow) : (bRow * IOXP_KB_COLS + bCol);
+	return (rgdwKeyDown[bKeyIdx >> 5] >> (bKeyIdx & 31)) & 1;
 }
 
-/* ------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetReset1EventA                                                                                                          */
-/*                                                                                                                                 */
-/*	Synopsis:                                                                                                                      */
-/*		GetReset1EventA(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);         */
-/*	Parameters:                                                                                                                    */  
-/*	 	int &iKeyVal	- key value - output parameter where the key value will be stored.                                         */
-/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.       */
-/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                  */
-/*						It contains 0xFF value if the event is not a keyboard event.                                               */
-/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                            */
-/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)       */
-/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                            */
-/*						It contains 0xFF value if the event is not a GPI event.                                                    */
-/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                        */
-/*						It contains 0xFF value if the event is not a Logic event.                                                  */
-/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                      */
-/*						For keys events:                                                                                           */
-/*								1 - key is pressed                                                                                 */
-/*								0 - key is released                                                                                */
-/*						For GPI and Logic events:                                                                                  */
-/*								1 - GPI/logic is active                                                                            */
-/*								0 - GPI/logic is inactive                                                                          */
-/*  Return Value:                                                                                                                  */
-/*		void                                                                                                                       */
-/*                                                                                                                                 */
-/*	Errors:                                                                                                                        */
-/*                                                                                                                                 */
-/*	Description:                                                                                                                   */
-/*		This function reads the Reset1EventA event, decodes it and returns the specific information.                               */
-/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in output       */
-/*		parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.        */
-/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                  */
-/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                 */
-/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                 */
-/*	    key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.                            */ 
-/* ------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::IsKeyDownByVal                                                */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		IsKeyDownByVal(iKeyVal);                                        */
+/*	Parameters:                                                         */  
+/*		int iKeyVal	- the value of the key in the key map               */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		bool - true if the key is pressed                               */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		false if no key has this value.                                 */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Same as IsKeyDown, the key being found with the reverse index   */
+/*		of the key map (see GetKeyByVal).                               */
+/* -------------------------------------------------------------------- */
 
-void IOXP::GetReset1EventA(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+bool IOXP::IsKeyDownByVal(int iKeyVal)
 {
-	uint8_t bEvent;
-	ReadBytesI2C(IOXP_ADDR_RESET1_EVENT_A, 1, &bEvent);
-	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	uint8_t bKeyIdx = GetKeyIdxByVal(iKeyVal);
+	if(bKeyIdx == 0xFF)
+	{
+		return false;
+	}
+	return (rgdwKeyDown[bKeyIdx >> 5] >> (bKeyIdx & 31)) & 1;
 }
 
-/* -------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::SetReset1EventB                                                                                                     */
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetKeyDownCount                                               */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GetKeyDownCount();                                              */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - number of pressed keys, row-to-GND keys included      */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		The count is updated with the bitmap, no scan.                  */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::GetKeyDownCount()
+{
+	return bCntKeysDown;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetNextKeyDown                                                */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		for(b = GetNextKeyDown(0, bRow, bCol); b != IOXP_KEY_IDX_NONE;  */
+/*			b = GetNextKeyDown(b + 1, bRow, bCol))                      */
+/*	Parameters:                                                         */  
+/*		uint8_t bKeyIdx	- first key index to look at                    */
+/*		uint8_t &bRow	- receives the row of the key found             */
+/*		uint8_t &bCol	- receives the column of the key found, or      */
+/*						  IOXP_KB_COL_GND for a row-to-GND key          */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - key index of the first pressed key from bKeyIdx, or   */
+/*				  IOXP_KEY_IDX_NONE (bRow and bCol are then 0xFF)       */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Iterates over the pressed keys in key index order. Each call    */
+/*		skips 32 released keys at a time with a bit scan.               */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::GetNextKeyDown(uint8_t bKeyIdx, uint8_t &bRow, uint8_t &bCol)
+{
+	bRow = 0xFF;
+	bCol = 0xFF;
+	while(bKeyIdx < IOXP_KEY_STATES)
+	{
+		uint32_t dwKeys = rgdwKeyDown[bKeyIdx >> 5] >> (bKeyIdx & 31);
+		if(dwKeys != 0)
+		{
+			bKeyIdx += IOXP_CTZ(dwKeys);
+			if(bKeyIdx >= IOXP_KEY_IDX_GND)
+			{
+				bRow = bKeyIdx - IOXP_KEY_IDX_GND;
+				bCol = IOXP_KB_COL_GND;
+			}
+			else
+			{
+				bRow = bKeyIdx / IOXP_KB_COLS;
+				bCol = bKeyIdx % IOXP_KB_COLS;
+			}
+			return bKeyIdx;
+		}
+		bKeyIdx = (bKeyIdx | 31) + 1;
+	}
+	return IOXP_KEY_IDX_NONE;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::ClearKeyState                                                 */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ClearKeyState();                                                */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Marks all the keys released, and drops the key releases not yet */
+/*		delivered by a resync. Done by begin, which drops the events    */
+/*		left in the FIFO.                                               */
+/* -------------------------------------------------------------------- */
+
+void IOXP::ClearKeyState()
+{
+	memset(rgdwKeyDown, 0, sizeof(rgdwKeyDown));
+	memset(rgdwKeyResync, 0, sizeof(rgdwKeyResync));
+	memset(rgdwKeyResyncUp, 0, sizeof(rgdwKeyResyncUp));
+	bCntKeysDown = 0;
+}
+
+#if !defined(__GNUC__)
+/* -------------------------------------------------------------------- */
+/*	IOXP::BitScan                                                       */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		BitScan(dw);                                                    */
+/*	Parameters:                                                         */  
+/*		uint32_t dw	- a non-zero value                                  */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - index of the lowest set bit, see IOXP_CTZ             */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::BitScan(uint32_t dw)
+{
+	uint8_t bIdx = 0;
+	while(!(dw & 1))
+	{
+		dw >>= 1;
+		bIdx++;
+	}
+	return bIdx;
+}
+#endif
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::DrainFIFO                                                     */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		DrainFIFO(rgEvents, bMaxEvents);                                */
+/*	Parameters:                                                         */  
+/*		IOXPEvent *rgEvents	- array where the decoded events will be    */
+/*							  stored                                    */
+/*		uint8_t bMaxEvents	- the number of elements of rgEvents        */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - the number of events stored in rgEvents               */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		On an I2C error the FIFO entries received before it (popped by  */
+/*		the device) are still returned; the overflow is not handled     */
+/*		until a read without error empties the FIFO.                    */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Reads the INT_STATUS, STATUS and FIFO registers in a single     */
+/*		auto-incrementing I2C read, then decodes the events counted by  */
+/*		the EC field of STATUS, oldest first, and those queued during   */
+/*		the read (see KeepLateEvents). At most bMaxEvents               */
+/*		(and never more than IOXP_FIFO_DEPTH) FIFO registers are read;  */
+/*		the events left in the FIFO can be read by a subsequent call.   */
+/*		Each event is decoded as described for ReadFIFO.                */
+/*		When the FIFO is emptied and OVERFLOW_INT is set, the state is  */
+/*		resynchronized as done by Service, then the bit is cleared: the */
+/*		resync events (IOXP_EVENT_FLAG_RESYNC) follow the FIFO events,  */
+/*		those that do not fit are returned first by the next call.      */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::DrainFIFO(IOXPEvent *rgEvents, uint8_t bMaxEvents)
+{
+	uint8_t rgbVals[2 + IOXP_FIFO_DEPTH];
+	uint8_t bCntOut = 0;
+	// resync events left by the previous call are older than the FIFO content
+	while(bCntOut < bMaxEvents && NextResyncEvent(rgEvents[bCntOut]))
+	{
+		bCntOut++;
+	}
+	uint8_t bCntRead = bMaxEvents - bCntOut;
+	if(bCntRead > IOXP_FIFO_DEPTH)
+	{
+		bCntRead = IOXP_FIFO_DEPTH;
+	}
+	if(bCntRead == 0)
+	{
+		return bCntOut;
+	}
+	uint32_t dwFromUS = dwLastFifoUS;
+	uint8_t bStatus = ReadBytesI2C(IOXP_ADDR_INT_STATUS, 2 + bCntRead, rgbVals);
+	uint32_t dwToUS = micros();
+	uint8_t bCntEvents = rgbVals[1] & (uint8_t)IOXP_STATUS_EC;
+	bool fEmpty = (bStatus == IOXP_I2C_OK && bCntEvents <= bCntRead);
+	if(bStatus != IOXP_I2C_OK)
+	{
+		// the entries received were popped and are kept, the others read 0
+		bCntEvents = KeepLateEvents(rgbVals + 2, 0, bCntRead);
+	}
+	else if(fEmpty)
+	{
+		dwLastFifoUS = dwToUS;
+		bCntEvents = KeepLateEvents(rgbVals + 2, bCntEvents, bCntRead);
+	}
+	else
+	{
+		bCntEvents = bCntRead;
+	}
+	for(uint8_t bIdx = 0; bIdx < bCntEvents; bIdx++)
+	{
+		if(FillEvent(rgEvents[bCntOut], rgbVals[2 + bIdx]))
+		{
+			StampEvent(rgEvents[bCntOut], bIdx, dwFromUS, dwToUS, false);
+			bCntOut++;
+		}
+	}
+	// left set until the FIFO is empty, the resync must follow the last lost event
+	if(fEmpty && (rgbVals[0] & (uint8_t)IOXP_INT_STATUS_OVERFLOW_INT))
+	{
+		ResyncState(dwFromUS, dwToUS);
+		uint8_t bOverflow = (uint8_t)IOXP_INT_STATUS_OVERFLOW_INT;
+		WriteBytesI2C(IOXP_ADDR_INT_STATUS, 1, &bOverflow);	// write 1 to clear
+		while(bCntOut < bMaxEvents && NextResyncEvent(rgEvents[bCntOut]))
+		{
+			bCntOut++;
+		}
+	}
+	return bCntOut;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::ReadGpiState                                                  */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ReadGpiState(dwActive, dwEventEn);                              */
+/*	Parameters:                                                         */  
+/*		uint32_t &dwActive	- output: active GPIs, bit x - 1 for GPIO x */
+/*		uint32_t &dwEventEn	- output: GPIs with GPI_EVENT_EN set        */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or the I2C error, the outputs are not     */
+/*				  changed on error                                      */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Reads GPI_STATUS_A - GPI_EVENT_EN_C in one burst. A GPI is      */
+/*		active when its level matches GPI_INT_LEVEL (1: active high),   */
+/*		as the event state of its FIFO events.                          */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::ReadGpiState(uint32_t &dwActive, uint32_t &dwEventEn)
+{
+	uint8_t rgbVals[IOXP_ADDR_GPI_EVENT_EN_C - IOXP_ADDR_GPI_STATUS_A + 1];
+	uint8_t bStatus = ReadBytesI2C(IOXP_ADDR_GPI_STATUS_A, sizeof(rgbVals), rgbVals);
+	if(bStatus != IOXP_I2C_OK)
+	{
+		return bStatus;
+	}
+	const uint8_t *rgbLevel = rgbVals + (IOXP_ADDR_GPI_INT_LEVEL_A - IOXP_ADDR_GPI_STATUS_A);
+	const uint8_t *rgbEventEn = rgbVals + (IOXP_ADDR_GPI_EVENT_EN_A - IOXP_ADDR_GPI_STATUS_A);
+	uint32_t dwMask = ((uint32_t)1 << IOXP_GPIOS) - 1;
+	uint32_t dwStatus = rgbVals[0] | ((uint32_t)rgbVals[1] << 8) | ((uint32_t)rgbVals[2] << 16);
+	uint32_t dwLevel = rgbLevel[0] | ((uint32_t)rgbLevel[1] << 8) | ((uint32_t)rgbLevel[2] << 16);
+	dwActive = ~(dwStatus ^ dwLevel) & dwMask;
+	dwEventEn = (rgbEventEn[0] | ((uint32_t)rgbEventEn[1] << 8) | ((uint32_t)rgbEventEn[2] << 16)) & dwMask;
+	return IOXP_I2C_OK;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::ResyncState                                                   */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ResyncState(dwFromUS, dwToUS);                                  */
+/*	Parameters:                                                         */  
+/*		uint32_t dwFromUS	- previous FIFO read, the lost events are   */
+/*							  newer                                     */
+/*		uint32_t dwToUS		- end of the FIFO read that found the       */
+/*							  overflow                                  */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or the I2C error of the GPI state read    */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		If the GPI states cannot be read, only the keys are resynced.   */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Called once the FIFO is empty after an OVERFLOW_INT. Counts the */
+/*		overflow and computes the events returned by NextResyncEvent:   */
+/*		- the GPIs with event reporting enabled whose state (read in    */
+/*		  one burst with ReadGpiState) differs from the one given by    */
+/*		  their last event get an event with the current state.         */
+/*		- the ADP5589 has no key matrix status register, so every key   */
+/*		  still pressed gets a release event. A key that is really held */
+/*		  is reported again at its next press; its real release, when   */
+/*		  it comes, is dropped (see TrackEventState), so every press    */
+/*		  gets a single release. IsKeyDown reads false for such a key   */
+/*		  until then.                                                   */
+/*		The number of GPI corrections, at least 1, is added to the lost */
+/*		event estimate; a key released here is only counted when its    */
+/*		next FIFO event is a press (see TrackEventState), as a held key */
+/*		lost nothing. The estimate is a lower bound, since two lost     */
+/*		events of an input cancel out.                                  */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::ResyncState(uint32_t dwFromUS, uint32_t dwToUS)
+{
+	uint32_t dwActive;
+	uint32_t dwEventEn;
+	uint32_t dwPending;
+	uint8_t bCntFixes = 0;
+	uint8_t bStatus = ReadGpiState(dwActive, dwEventEn);
+	if(bStatus == IOXP_I2C_OK)
+	{
+		dwGpiResync = (dwActive ^ dwGpiActive) & dwEventEn;
+	}
+	for(dwPending = dwGpiResync; dwPending != 0; dwPending &= dwPending - 1)
+	{
+		bCntFixes++;
+	}
+	for(uint8_t bIdx = 0; bIdx < (IOXP_KEY_STATES + 31) >> 5; bIdx++)
+	{
+		rgdwKeyResync[bIdx] = rgdwKeyDown[bIdx];
+	}
+	dwResyncErrUS = (dwToUS - dwFromUS) >> 1;
+	dwResyncTimeUS = dwFromUS + dwResyncErrUS;
+	dwResyncErrUS = dwToUS - dwResyncTimeUS;
+	dwFifoOverflows++;
+	dwLostEvents += (bCntFixes != 0) ? bCntFixes : 1;
+	return bStatus;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::NextResyncEvent                                               */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		NextResyncEvent(evt);                                           */
+/*	Parameters:                                                         */  
+/*		IOXPEvent &evt	- output: the next resync event                 */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		bool - false if no resync event is pending                      */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the key releases first, then the GPI changes, and       */
+/*		updates the tracked state as for a FIFO event. The events have  */
+/*		IOXP_EVENT_FLAG_RESYNC set and are stamped in the middle of the */
+/*		window given to ResyncState, the error covering all of it.      */
+/* -------------------------------------------------------------------- */
+
+bool IOXP::NextResyncEvent(IOXPEvent &evt)
+{
+	uint8_t bEvent = 0;
+	for(uint8_t bIdx = 0; bIdx < (IOXP_KEY_STATES + 31) >> 5; bIdx++)
+	{
+		if(rgdwKeyResync[bIdx] != 0)
+		{
+			bEvent = IOXP_EVENT_ID_KEY + (bIdx << 5) + IOXP_CTZ(rgdwKeyResync[bIdx]);	// state 0: released
+			break;
+		}
+	}
+	if(bEvent == 0)
+	{
+		if(dwGpiResync == 0)
+		{
+			return false;
+		}
+		uint8_t bGpiIdx = IOXP_CTZ(dwGpiResync);
+		bEvent = IOXP_EVENT_ID_GPI + bGpiIdx;
+		if(!((dwGpiActive >> bGpiIdx) & 1))
+		{
+			bEvent |= 0x80;
+		}
+	}
+	FillEvent(evt, bEvent);		// also clears the pending bit
+	if((bEvent & 0x80) == 0 && (uint8_t)(bEvent - IOXP_EVENT_ID_KEY) < IOXP_KEY_STATES)
+	{	// the real release is still to come from the FIFO
+		uint8_t bKeyIdx = bEvent - IOXP_EVENT_ID_KEY;
+		rgdwKeyResyncUp[bKeyIdx >> 5] |= (uint32_t)1 << (bKeyIdx & 31);
+	}
+	evt.bFlags = IOXP_EVENT_FLAG_RESYNC;
+	evt.dwTimeUS = dwResyncTimeUS;
+	evt.dwTimeErrUS = dwResyncErrUS;
+	return true;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetFifoOverflowCount                                          */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the number of device FIFO overflows (OVERFLOW_INT) seen */
+/*		by Service, IOXPGroup::Service and DrainFIFO since the last     */
+/*		ResetOverflowCounters.                                          */
+/* -------------------------------------------------------------------- */
+
+uint32_t IOXP::GetFifoOverflowCount()
+{
+	return dwFifoOverflows;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetLostEventCount                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the estimated number of events lost in the FIFO         */
+/*		overflows, a lower bound, see ResyncState.                      */
+/* -------------------------------------------------------------------- */
+
+uint32_t IOXP::GetLostEventCount()
+{
+	return dwLostEvents;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::ResetOverflowCounters                                         */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Clears the overflow and lost event counters.                    */
+/* -------------------------------------------------------------------- */
+
+void IOXP::ResetOverflowCounters()
+{
+	dwFifoOverflows = 0;
+	dwLostEvents = 0;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::SetLockEvent                                                                                                                               */
+/*                                                                                                                                                   */
+/*	Synopsis:                                                                                                                                        */
+/*		SetLockEvent(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);                                    */
+/*	Parameters:                                                                                                                                      */  
+/*		int iKeyVal	- key value                                                                                                                      */
+/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and column information.          */
+/*	    uint8_t bRow	- key row value                                                                                                              */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.                             */
+/*						This parameter has a default value of 0xFF.                                                                                  */
+/*		uint8_t bCol	- key column value                                                                                                           */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event or if the event corresponds  */
+/*						to (Rx, GND). This parameter has a default value of 0xFF.                                                                    */
+/*		uint8_t bGPI	- GPI number.                                                                                                                */
+/*						It contains 0xFF value if the event is not a GPI event.                                                                      */
+/*						This parameter has a default value of 0xFF.                                                                                  */
+/*		uint8_t bLogic	- Logic number.                                                                                                              */
+/*						It contains 0xFF value if the event is not a Logic event.                                                                    */
+/*						This parameter has a default value of 0xFF.                                                                                  */
+/*		uint8_t bEventState - Event state                                                                                                            */
+/*						For keys events:                                                                                                             */
+/*								1 - key is pressed                                                                                                   */
+/*								0 - key is released                                                                                                  */
+/*						For GPI and Logic events:                                                                                                    */
+/*								1 - GPI/logic is active                                                                                              */
+/*								0 - GPI/logic is inactive                                                                                            */
+/*						This parameter has a default value of 1. 	                                                                                 */
+/*		                                                                                                                                             */
+/*  Return Value:                                                                                                                                    */
+/*		 void                                                                                                                                        */
+/*                                                                                                                                                   */
+/*	Errors:                                                                                                                                          */
+/*                                                                                                                                                   */
+/*	Description:                                                                                                                                     */
+/*		This function sets the lock event according to the specified information.It encodes information in the event byte using EncodeEvent function.*/
+/*		When more keys have that same value associated, then only the first one of them will be identified with that value.                          */
+/*		If no key corresponds to the specified key value, no event will be created.                                                                  */
+/*		The last five parameters have default values.                                                                                                */ 
+/* ------------------------------------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::SetLockEvent(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+{
+	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	if(bEvent != 0xFF)
+	{
+		WriteBytesI2C(IOXP_ADDR_EXT_LOCK_EVENT, 1, &bEvent);	
+	}
+}
+
+/* ------------------------------------------------------------------------------------------------------------------------------ */
+/*	 IOXP::GetLockEvent                                                                                                           */
+/*                                                                                                                                */
+/*	Synopsis:                                                                                                                     */
+/*		GetLockEvent(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);	          */
+/*	Parameters:                                                                                                                   */  
+/*		int &iKeyVal	- key value - output parameter where the key value will be stored.                                        */
+/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.      */
+/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                 */
+/*						It contains 0xFF value if the event is not a keyboard event.                                              */
+/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                           */
+/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)      */
+/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                           */
+/*						It contains 0xFF value if the event is not a GPI event.                                                   */
+/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                       */
+/*						It contains 0xFF value if the event is not a Logic event.                                                 */
+/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                     */
+/*						For keys events:                                                                                          */
+/*								1 - key is pressed                                                                                */
+/*								0 - key is released                                                                               */
+/*						For GPI and Logic events:                                                                                 */
+/*								1 - GPI/logic is active                                                                           */
+/*								0 - GPI/logic is inactive                                                                         */
+/*  Return Value:                                                                                                                 */
+/*		void                                                                                                                      */
+/*                                                                                                                                */
+/*	Errors:                                                                                                                       */
+/*                                                                                                                                */
+/*	Description:                                                                                                                  */
+/*		This function reads the lock event, decodes it and returns the specific information.  If the event is a key event,        */
+/*      key value, row and column the information corresponding to the key are stored in output parameters                        */
+/*		while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.                  */
+/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                 */
+/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                */
+/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                */
+/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.	                          */                                                 
+/* ------------------------------------------------------------------------------------------------------------------------------ */
+
+void IOXP::GetLockEvent(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+{
+	uint8_t bEvent;
+	ReadBytesI2C(IOXP_ADDR_EXT_LOCK_EVENT, 1, &bEvent);
+	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+}
+
+/* --------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::SetUnlock1Event                                                                                                      */
+/*  	                                                                                                                       */
+/*	Synopsis:                                                                                                                  */
+/*		SetUnlock1Event(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);           */
+/*	Parameters:                                                                                                                */  
+/*		int iKeyVal	- key value                                                                                                */
+/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and        */
+/*						column information.                                                                                    */
+/*		uint8_t bRow	- key row value                                                                                        */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.       */
+/*						This parameter has a default value of 0xFF.                                                            */
+/*		uint8_t bCol	- key column value                                                                                     */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event        */
+/*						or if the event corresponds to (Rx, GND).                                                              */
+/*						This parameter has a default value of 0xFF.                                                            */
+/*		uint8_t bGPI	- GPI number.                                                                                          */
+/*						It contains 0xFF value if the event is not a GPI event.                                                */
+/*						This parameter has a default value of 0xFF.                                                            */
+/*		uint8_t bLogic	- Logic number.                                                                                        */
+/*						It contains 0xFF value if the event is not a Logic event.                                              */
+/*						This parameter has a default value of 0xFF.                                                            */
+/*		uint8_t bEventState - Event state                                                                                      */
+/*						For keys events:                                                                                       */
+/*								1 - key is pressed                                                                             */
+/*								0 - key is released                                                                            */
+/*						For GPI and Logic events:                                                                              */
+/*								1 - GPI/logic is active                                                                        */
+/*								0 - GPI/logic is inactive                                                                      */
+/*  Return Value:                                                                                                              */
+/*		void                                                                                                                   */
+/*                                                                                                                             */
+/*	Errors:                                                                                                                    */
+/*                                                                                                                             */
+/*	Description:                                                                                                               */
+/*		This function sets the Unlock1 event according to the specified information. It encodes information in the event byte  */
+/*		using EncodeEvent function.	When more keys have that same value associated, then only the first one of them will be    */
+/*		identified with that value. If no key corresponds to the specified key value, no event will be created.                */
+/*		The last five parameters have default values.	                                                                       */ 
+/* --------------------------------------------------------------------------------------------------------------------------- */
+
+
+void IOXP::SetUnlock1Event(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+{
+	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	WriteBytesI2C(IOXP_ADDR_UNLOCK1, 1, &bEvent);	
+}
+
+/* --------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetUnlock1Event                                                                                                      */
+/*                                                                                                                             */
+/*	Synopsis:                                                                                                                  */
+/*		GetUnlock1Event(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);	   */
+/*	Parameters:                                                                                                                */  
+/*	 	int &iKeyVal	- key value - output parameter where the key value will be stored.                                     */
+/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.   */
+/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                              */
+/*						It contains 0xFF value if the event is not a keyboard event.                                           */
+/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                        */
+/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)   */
+/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                        */
+/*						It contains 0xFF value if the event is not a GPI event.                                                */
+/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                    */
+/*						It contains 0xFF value if the event is not a Logic event.                                              */
+/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                  */
+/*						For keys events:                                                                                       */
+/*								1 - key is pressed                                                                             */
+/*								0 - key is released                                                                            */
+/*						For GPI and Logic events:                                                                              */
+/*								1 - GPI/logic is active                                                                        */
+/*								0 - GPI/logic is inactive                                                                      */                   
+/*		                                                                                                                       */
+/*  Return Value:                                                                                                              */
+/*		void                                                                                                                   */
+/*                                                                                                                             */
+/*	Errors:                                                                                                                    */
+/*                                                                                                                             */
+/*	Description:                                                                                                               */
+/*		This function reads the Unlock1 event, decodes it and returns the specific information.                                */
+/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in          */
+/*		output parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to   */
+/*		0xFF. If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to        */
+/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.             */
+/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to             */
+/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.	                       */ 
+/* --------------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::GetUnlock1Event(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+{
+	uint8_t bEvent;
+	ReadBytesI2C(IOXP_ADDR_UNLOCK1, 1, &bEvent);
+	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+}
+
+/* -------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::SetUnlock2Event                                                                                                     */
+/*                                                                                                                            */
+/*	Synopsis:                                                                                                                 */
+/*		SetUnlock2Event(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);          */
+/*	Parameters:                                                                                                               */  
+/*	 	int iKeyVal	- key value                                                                                               */
+/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and       */
+/*						column information.                                                                                   */
+/*		uint8_t bRow	- key row value                                                                                       */
+/*					    It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.      */
+/*						This parameter has a default value of 0xFF.                                                           */
+/*		uint8_t bCol	- key column value                                                                                    */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event or    */
+/*						if the event corresponds to (Rx, GND).                                                                */
+/*						This parameter has a default value of 0xFF.                                                           */
+/*		uint8_t bGPI	- GPI number.                                                                                         */
+/*						It contains 0xFF value if the event is not a GPI event.                                               */
+/*						This parameter has a default value of 0xFF.                                                           */
+/*		uint8_t bLogic	- Logic number.                                                                                       */
+/*						It contains 0xFF value if the event is not a Logic event.                                             */
+/*						This parameter has a default value of 0xFF.                                                           */
+/*		uint8_t bEventState - Event state                                                                                     */
+/*						For keys events:                                                                                      */
+/*								1 - key is pressed                                                                            */
+/*								0 - key is released                                                                           */
+/*						For GPI and Logic events:                                                                             */
+/*								1 - GPI/logic is active                                                                       */
+/*								0 - GPI/logic is inactive                                                                     */
+/*						This parameter has a default value of 1.                                                              */                                                                                                                   
+/*  Return Value:                                                                                                             */
+/*		void                                                                                                                  */
+/*                                                                                                                            */
+/*	Errors:                                                                                                                   */
+/*                                                                                                                            */
+/*	Description:                                                                                                              */
+/*		This function sets the Unlock2 event according to the specified information. It encodes information in the event      */
+/*		byte using EncodeEvent function. When more keys have that same value associated, then only the first one of them      */
+/*		will be identified with that value. If no key corresponds to the specified key value, no event will be created.       */
+/*      The last five parameters have default values.                                                                         */ 
+/* -------------------------------------------------------------------------------------------------------------------------- */
+
+
+void IOXP::SetUnlock2Event(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+{
+	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	WriteBytesI2C(IOXP_ADDR_UNLOCK2, 1, &bEvent);	
+}
+
+/* -------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetUnlock2Event                                                                                                           */
+/*                                                                                                                                  */
+/*	Synopsis:                                                                                                                       */
+/*		GetUnlock2Event(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);          */
+/*	Parameters:                                                                                                                     */  
+/*	 	 int &iKeyVal	- key value - output parameter where the key value will be stored.                                          */
+/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.        */
+/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                   */
+/*						It contains 0xFF value if the event is not a keyboard event.                                                */
+/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                             */
+/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)        */
+/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                             */
+/*						It contains 0xFF value if the event is not a GPI event.                                                     */
+/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                         */
+/*						It contains 0xFF value if the event is not a Logic event.                                                   */
+/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                       */
+/*						For keys events:                                                                                            */
+/*								1 - key is pressed                                                                                  */
+/*								0 - key is released                                                                                 */
+/*						For GPI and Logic events:                                                                                   */
+/*								1 - GPI/logic is active                                                                             */
+/*								0 - GPI/logic is inactive                                                                           */
+/*						                                                                                                            */
+/*  Return Value:                                                                                                                   */
+/*		 void                                                                                                                       */
+/*                                                                                                                                  */
+/*	Errors:                                                                                                                         */
+/*                                                                                                                                  */
+/*	Description:                                                                                                                    */
+/*		This function reads the Unlock2 event, decodes it and returns the specific information.                                     */
+/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in output        */
+/*		parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.         */
+/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                   */
+/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                  */
+/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                  */
+/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.                             */ 
+/* -------------------------------------------------------------------------------------------------------------------------------- */
+
+
+void IOXP::GetUnlock2Event(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+{
+	uint8_t bEvent;
+	ReadBytesI2C(IOXP_ADDR_UNLOCK2, 1, &bEvent);
+	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+}
+
+/* ---------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::SetReset1EventA                                                                                                       */
+/*                                                                                                                              */
+/*	Synopsis:                                                                                                                   */
+/*		SetReset1EventA(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);            */
+/*	Parameters:                                                                                                                 */  
+/*		int iKeyVal	- key value                                                                                                 */
+/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and column  */
+/*						information.                                                                                            */
+/*		uint8_t bRow	- key row value                                                                                         */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.        */
+/*						This parameter has a default value of 0xFF.                                                             */
+/*		uint8_t bCol	- key column value                                                                                      */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event or if   */
+/*						the event corresponds to (Rx, GND).                                                                     */
+/*						This parameter has a default value of 0xFF.                                                             */
+/*		uint8_t bGPI	- GPI number.                                                                                           */
+/*						It contains 0xFF value if the event is not a GPI event.                                                 */
+/*						This parameter has a default value of 0xFF.                                                             */
+/*		uint8_t bLogic	- Logic number.                                                                                         */
+/*						It contains 0xFF value if the event is not a Logic event.                                               */
+/*						This parameter has a default value of 0xFF.                                                             */
+/*		uint8_t bEventState - Event state                                                                                       */
+/*						For keys events:                                                                                        */
+/*								1 - key is pressed                                                                              */
+/*								0 - key is released                                                                             */
+/*						For GPI and Logic events:                                                                               */
+/*								1 - GPI/logic is active                                                                         */
+/*								0 - GPI/logic is inactive                                                                       */
+/*						This parameter has a default value of 1.	                                                            */
+/*  Return Value:                                                                                                               */
+/*		void                                                                                                                    */
+/*                                                                                                                              */
+/*	Errors:                                                                                                                     */
+/*                                                                                                                              */
+/*	Description:                                                                                                                */
+/*		This function sets the Reset1EventA event according to the specified information. It encodes information in the event   */
+/*		byte using EncodeEvent function. When more keys have that same value associated, then only the first one of them will   */
+/*		be identified with that value. If no key corresponds to the specified key value, no event will be created.              */
+/*      The last five parameters have default values.                                                                           */ 
+/* ---------------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::SetReset1EventA(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+{
+	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	WriteBytesI2C(IOXP_ADDR_RESET1_EVENT_A, 1, &bEvent);	
+}
+
+/* ------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetReset1EventA                                                                                                          */
+/*                                                                                                                                 */
+/*	Synopsis:                                                                                                                      */
+/*		GetReset1EventA(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);         */
+/*	Parameters:                                                                                                                    */  
+/*	 	int &iKeyVal	- key value - output parameter where the key value will be stored.                                         */
+/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.       */
+/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                  */
+/*						It contains 0xFF value if the event is not a keyboard event.                                               */
+/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                            */
+/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)       */
+/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                            */
+/*						It contains 0xFF value if the event is not a GPI event.                                                    */
+/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                        */
+/*						It contains 0xFF value if the event is not a Logic event.                                                  */
+/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                      */
+/*						For keys events:                                                                                           */
+/*								1 - key is pressed                                                                                 */
+/*								0 - key is released                                                                                */
+/*						For GPI and Logic events:                                                                                  */
+/*								1 - GPI/logic is active                                                                            */
+/*								0 - GPI/logic is inactive                                                                          */
+/*  Return Value:                                                                                                                  */
+/*		void                                                                                                                       */
+/*                                                                                                                                 */
+/*	Errors:                                                                                                                        */
+/*                                                                                                                                 */
+/*	Description:                                                                                                                   */
+/*		This function reads the Reset1EventA event, decodes it and returns the specific information.                               */
+/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in output       */
+/*		parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.        */
+/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                  */
+/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                 */
+/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                 */
+/*	    key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.                            */ 
+/* ------------------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::GetReset1EventA(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+{
+	uint8_t bEvent;
+	ReadBytesI2C(IOXP_ADDR_RESET1_EVENT_A, 1, &bEvent);
+	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+}
+
+/* -------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::SetReset1EventB                                                                                                     */
+/*                                                                                                                            */
+/*	Synopsis:                                                                                                                 */
+/*		SetReset1EventB(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);          */
+/*	Parameters:                                                                                                               */  
+/*	 	int iKeyVal	- key value                                                                                               */
+/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and       */
+/*						column information.                                                                                   */
+/*		uint8_t bRow	- key row value                                                                                       */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.      */
+/*						This parameter has a default value of 0xFF.                                                           */
+/*		uint8_t bCol	- key column value                                                                                    */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event or    */
+/*						if the event corresponds to (Rx, GND).                                                                */
+/*						This parameter has a default value of 0xFF.                                                           */
+/*		uint8_t bGPI	- GPI number.                                                                                         */
+/*						It contains 0xFF value if the event is not a GPI event.                                               */
+/*						This parameter has a default value of 0xFF.                                                           */
+/*		uint8_t bLogic	- Logic number.                                                                                       */
+/*						It contains 0xFF value if the event is not a Logic event.                                             */
+/*						This parameter has a default value of 0xFF.                                                           */
+/*		uint8_t bEventState - Event state                                                                                     */
+/*						For keys events:                                                                                      */
+/*								1 - key is pressed                                                                            */
+/*								0 - key is released                                                                           */ 
+/*						For GPI and Logic events:                                                                             */
+/*								1 - GPI/logic is active                                                                       */
+/*								0 - GPI/logic is inactive                                                                     */
+/*						This parameter has a default value of 1.                                                              */
+/*						                                                                                                      */
+/*  Return Value:                                                                                                             */
+/*		void                                                                                                                  */
+/*                                                                                                                            */
+/*	Errors:                                                                                                                   */
+/*                                                                                                                            */
+/*	Description:                                                                                                              */
+/*		This function sets the Reset1EventB event according to the specified information. It encodes information in the event */
+/*		byte using EncodeEvent function. When more keys have that same value associated, then only the first one of them will */
+/*		be identified with that value. If no key corresponds to the specified key value, no event will be created.            */
+/*      The last five parameters have default values.	                                                                      */ 
+/* -------------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::SetReset1EventB(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+{
+	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	WriteBytesI2C(IOXP_ADDR_RESET1_EVENT_B, 1, &bEvent);	
+}
+
+/* -------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetReset1EventB                                                                                                           */
+/*                                                                                                                                  */
+/*	Synopsis:                                                                                                                       */
+/*		GetReset1EventB(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);          */
+/*	Parameters:                                                                                                                     */  
+/*	 	int &iKeyVal	- key value - output parameter where the key value will be stored.                                          */
+/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.        */
+/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                   */
+/*						It contains 0xFF value if the event is not a keyboard event.                                                */
+/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                             */
+/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)        */
+/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                             */
+/*						It contains 0xFF value if the event is not a GPI event.                                                     */
+/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                         */
+/*						It contains 0xFF value if the event is not a Logic event.                                                   */
+/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                       */
+/*						For keys events:                                                                                            */
+/*								1 - key is pressed                                                                                  */
+/*								0 - key is released                                                                                 */
+/*						For GPI and Logic events:                                                                                   */
+/*								1 - GPI/logic is active                                                                             */
+/*								0 - GPI/logic is inactive                                                                           */
+/*  Return Value:                                                                                                                   */
+/*		void                                                                                                                        */
+/*                                                                                                                                  */
+/*	Errors:                                                                                                                         */
+/*                                                                                                                                  */
+/*	Description:                                                                                                                    */
+/*		This function reads the Reset1EventB event, decodes it and returns the specific information.                                */
+/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in output        */
+/*		parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.         */
+/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                   */
+/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                  */
+/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                  */
+/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.                             */ 
+/* -------------------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::GetReset1EventB(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+{
+	uint8_t bEvent;
+	ReadBytesI2C(IOXP_ADDR_RESET1_EVENT_B, 1, &bEvent);
+	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+}
+
+/* -------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::SetReset1EventC                                                                                                     */
 /*                                                                                                                            */
 /*	Synopsis:                                                                                                                 */
-/*		SetReset1EventB(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);          */
+/*		SetReset1EventC(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);          */
 /*	Parameters:                                                                                                               */  
 /*	 	int iKeyVal	- key value                                                                                               */
 /*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and       */
@@ -1489,8 +3492,8 @@ void IOXP::GetReset1EventA(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &
 /*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.      */
 /*						This parameter has a default value of 0xFF.                                                           */
 /*		uint8_t bCol	- key column value                                                                                    */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event or    */
-/*						if the event corresponds to (Rx, GND).                                                                */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event       */
+/*						or if the event corresponds to (Rx, GND).                                                             */
 /*						This parameter has a default value of 0xFF.                                                           */
 /*		uint8_t bGPI	- GPI number.                                                                                         */
 /*						It contains 0xFF value if the event is not a GPI event.                                               */
@@ -1501,1453 +3504,3275 @@ void IOXP::GetReset1EventA(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &
 /*		uint8_t bEventState - Event state                                                                                     */
 /*						For keys events:                                                                                      */
 /*								1 - key is pressed                                                                            */
-/*								0 - key is released                                                                           */ 
+/*								0 - key is released                                                                           */
 /*						For GPI and Logic events:                                                                             */
 /*								1 - GPI/logic is active                                                                       */
 /*								0 - GPI/logic is inactive                                                                     */
 /*						This parameter has a default value of 1.                                                              */
-/*						                                                                                                      */
 /*  Return Value:                                                                                                             */
-/*		void                                                                                                                  */
+/*		 void                                                                                                                 */
 /*                                                                                                                            */
 /*	Errors:                                                                                                                   */
 /*                                                                                                                            */
 /*	Description:                                                                                                              */
-/*		This function sets the Reset1EventB event according to the specified information. It encodes information in the event */
+/*		This function sets the Reset1EventC event according to the specified information. It encodes information in the event */
 /*		byte using EncodeEvent function. When more keys have that same value associated, then only the first one of them will */
 /*		be identified with that value. If no key corresponds to the specified key value, no event will be created.            */
-/*      The last five parameters have default values.	                                                                      */ 
+/*      The last five parameters have default values.                                                                         */ 
 /* -------------------------------------------------------------------------------------------------------------------------- */
 
-void IOXP::SetReset1EventB(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+void IOXP::SetReset1EventC(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+{
+	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	WriteBytesI2C(IOXP_ADDR_RESET1_EVENT_C, 1, &bEvent);	
+}
+
+/* -------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetReset1EventC                                                                                                           */
+/*                                                                                                                                  */
+/*	Synopsis:                                                                                                                       */
+/*		GetReset1EventC(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);          */
+/*	Parameters:                                                                                                                     */  
+/*	 	int &iKeyVal	- key value - output parameter where the key value will be stored.                                          */
+/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.        */
+/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                   */
+/*						It contains 0xFF value if the event is not a keyboard event.                                                */
+/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                             */
+/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)        */
+/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                             */
+/*						It contains 0xFF value if the event is not a GPI event.                                                     */
+/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                         */
+/*						It contains 0xFF value if the event is not a Logic event.                                                   */
+/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                       */
+/*						For keys events:                                                                                            */
+/*								1 - key is pressed                                                                                  */
+/*								0 - key is released                                                                                 */
+/*						For GPI and Logic events:                                                                                   */
+/*								1 - GPI/logic is active                                                                             */
+/*								0 - GPI/logic is inactive                                                                           */
+/*  Return Value:                                                                                                                   */
+/*		 void                                                                                                                       */
+/*                                                                                                                                  */
+/*	Errors:                                                                                                                         */
+/*                                                                                                                                  */
+/*	Description:                                                                                                                    */
+/*		This function reads the Reset1EventC event, decodes it and returns the specific information.                                */
+/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in output        */
+/*		parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.         */
+/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                   */
+/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                  */
+/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                  */
+/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.                             */ 
+/* -------------------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::GetReset1EventC(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+{
+	uint8_t bEvent;
+	ReadBytesI2C(IOXP_ADDR_RESET1_EVENT_C, 1, &bEvent);
+	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------------------ */
+/*	IOXP::SetReset2EventA                                                                                                         */
+/*                                                                                                                                */
+/*	Synopsis:                                                                                                                     */
+/*		SetReset2EventA(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);	          */
+/*	Parameters:                                                                                                                   */  
+/*		int iKeyVal	- key value                                                                                                   */
+/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and column    */
+/*						information.                                                                                              */
+/*		uint8_t bRow	- key row value                                                                                           */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.          */
+/*						This parameter has a default value of 0xFF.                                                               */
+/*		uint8_t bCol	- key column value                                                                                        */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event or if     */
+/*						the event corresponds to (Rx, GND).                                                                       */
+/*						This parameter has a default value of 0xFF.                                                               */
+/*		uint8_t bGPI	- GPI number.                                                                                             */
+/*						It contains 0xFF value if the event is not a GPI event.                                                   */
+/*						This parameter has a default value of 0xFF.                                                               */
+/*		uint8_t bLogic	- Logic number.                                                                                           */
+/*						It contains 0xFF value if the event is not a Logic event.                                                 */
+/*						This parameter has a default value of 0xFF.                                                               */
+/*		uint8_t bEventState - Event state                                                                                         */
+/*						For keys events:                                                                                          */
+/*								1 - key is pressed                                                                                */
+/*								0 - key is released                                                                               */
+/*						For GPI and Logic events:                                                                                 */
+/*								1 - GPI/logic is active                                                                           */
+/*								0 - GPI/logic is inactive                                                                         */
+/*						This parameter has a default value of 1.                                                                  */
+/*  Return Value:                                                                                                                 */
+/*		void                                                                                                                      */
+/*                                                                                                                                */
+/*	Errors:                                                                                                                       */
+/*                                                                                                                                */
+/*	Description:                                                                                                                  */
+/*		This function sets the Reset2EventA event according to the specified information. It encodes information in the event     */
+/*		byte using EncodeEvent function. When more keys have that same value associated, then only the first one of them will     */
+/*		be identified with that value. If no key corresponds to the specified key value, no event will be created.                */
+/*      The last five parameters have default values.                                                                             */ 
+/* ------------------------------------------------------------------------------------------------------------------------------ */
+
+void IOXP::SetReset2EventA(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+{
+	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	WriteBytesI2C(IOXP_ADDR_RESET2_EVENT_A, 1, &bEvent);	
+}
+
+/* ------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetReset2EventA                                                                                                          */
+/*                                                                                                                                 */
+/*	Synopsis:                                                                                                                      */
+/*		GetReset2EventA(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);         */
+/*	Parameters:                                                                                                                    */  
+/*	 	int &iKeyVal	- key value - output parameter where the key value will be stored.                                         */
+/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.       */
+/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                  */
+/*						It contains 0xFF value if the event is not a keyboard event.                                               */
+/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                            */
+/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)       */
+/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                            */
+/*						It contains 0xFF value if the event is not a GPI event.                                                    */
+/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                        */ 
+/*						It contains 0xFF value if the event is not a Logic event.                                                  */
+/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                      */
+/*						For keys events:                                                                                           */
+/*								1 - key is pressed                                                                                 */
+/*								0 - key is released                                                                                */
+/*						For GPI and Logic events:                                                                                  */
+/*								1 - GPI/logic is active                                                                            */
+/*								0 - GPI/logic is inactive                                                                          */
+/*  Return Value:                                                                                                                  */
+/*		void                                                                                                                       */
+/*                                                                                                                                 */
+/*	Errors:                                                                                                                        */
+/*                                                                                                                                 */
+/*	Description:                                                                                                                   */
+/*		This function reads the Reset2EventA event, decodes it and returns the specific information.                               */ 
+/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in output       */
+/*		parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.        */
+/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                  */
+/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                 */
+/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                 */
+/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.                            */ 
+/* ------------------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::GetReset2EventA(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+{
+	uint8_t bEvent;
+	ReadBytesI2C(IOXP_ADDR_RESET2_EVENT_A, 1, &bEvent);
+	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+}
+
+/* --------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::SetReset2EventB                                                                                                      */
+/*                                                                                                                             */
+/*	Synopsis:                                                                                                                  */
+/*		SetReset2EventB(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);           */
+/*	Parameters:                                                                                                                */  
+/*	 	int iKeyVal	- key value                                                                                                */
+/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and column */
+/*						information.                                                                                           */
+/*		uint8_t bRow	- key row value                                                                                        */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.       */
+/*						This parameter has a default value of 0xFF.                                                            */
+/*		uint8_t bCol	- key column value                                                                                     */
+/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event or     */
+/*						if the event corresponds to (Rx, GND).                                                                 */
+/*						This parameter has a default value of 0xFF.                                                            */
+/*		uint8_t bGPI	- GPI number.                                                                                          */
+/*						It contains 0xFF value if the event is not a GPI event.                                                */
+/*						This parameter has a default value of 0xFF.                                                            */
+/*		uint8_t bLogic	- Logic number.                                                                                        */
+/*						It contains 0xFF value if the event is not a Logic event.                                              */
+/*						This parameter has a default value of 0xFF.                                                            */
+/*		uint8_t bEventState - Event state                                                                                      */
+/*						For keys events:                                                                                       */
+/*								1 - key is pressed                                                                             */
+/*								0 - key is released                                                                            */
+/*						For GPI and Logic events:                                                                              */
+/*								1 - GPI/logic is active                                                                        */
+/*								0 - GPI/logic is inactive                                                                      */
+/*						This parameter has a default value of 1.                                                               */
+/*  Return Value:                                                                                                              */
+/*		void                                                                                                                   */
+/*                                                                                                                             */
+/*	Errors:                                                                                                                    */
+/*                                                                                                                             */
+/*	Description:                                                                                                               */
+/*		This function sets the Reset2EventB event according to the specified information. It encodes information in the event  */
+/*		byte using EncodeEvent function. When more keys have that same value associated, then only the first one of them will  */
+/*		be identified with that value. If no key corresponds to the specified key value, no event will be created.             */
+/*      The last five parameters have default values.                                                                          */ 
+/* --------------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::SetReset2EventB(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+{
+	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	WriteBytesI2C(IOXP_ADDR_RESET2_EVENT_B, 1, &bEvent);	
+}
+
+/* -------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetReset2EventB                                                                                                           */
+/*                                                                                                                                  */
+/*	Synopsis:                                                                                                                       */
+/*		GetReset2EventB(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);          */
+/*	Parameters:                                                                                                                     */  
+/*	 	uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                   */
+/*						It contains 0xFF value if the event is not a keyboard event.                                                */
+/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                             */
+/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)        */
+/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                             */
+/*						It contains 0xFF value if the event is not a GPI event.                                                     */
+/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                         */
+/*						It contains 0xFF value if the event is not a Logic event.                                                   */
+/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                       */
+/*						For keys events:                                                                                            */
+/*								1 - key is pressed                                                                                  */
+/*								0 - key is released                                                                                 */
+/*						For GPI and Logic events:                                                                                   */
+/*								1 - GPI/logic is active                                                                             */
+/*								0 - GPI/logic is inactive                                                                           */
+/*  Return Value:                                                                                                                   */
+/*		void                                                                                                                        */
+/*                                                                                                                                  */
+/*	Errors:                                                                                                                         */
+/*                                                                                                                                  */
+/*	Description:                                                                                                                    */
+/*		This function reads the Reset2EventB event, decodes it and returns the specific information.                                */
+/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in output        */
+/*		parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.         */
+/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                   */
+/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                  */
+/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                  */
+/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.                             */
+/* -------------------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::GetReset2EventB(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+{
+	uint8_t bEvent;
+	ReadBytesI2C(IOXP_ADDR_RESET2_EVENT_B, 1, &bEvent);
+	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+}
+
+/* ---------------------------------------------------------------------------------------- */
+/*	 IOXP::SetIntMaskTimer                                                                  */
+/*                                                                                          */
+/*	Synopsis:                                                                               */
+/*		SetIntMaskTimer(uint8_t bIntMaskTimer);                                             */
+/*	Parameters:                                                                             */  
+/*	 	uint8_t bIntMaskTimer - the information to be set for INT_MASK_TIMER bits.          */
+/*					It can be one of the following time values:                             */
+/*		            IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_DIS		(0)		- disabled          */
+/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_1SEC	(1)		-  1 sec            */
+/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_2SEC	(2)		-  2 sec            */
+/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_30SEC	(0X1E)	- 30 sec            */
+/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_31SEC	(0X1F)	- 31 sec            */
+/*  Return Value:                                                                           */
+/*		void                                                                                */
+/*                                                                                          */
+/*	Errors:                                                                                 */
+/*                                                                                          */
+/*	Description:                                                                            */
+/*		This function sets the INT_MASK_TIMER information of the UNLOCK_TIMERS register.    */ 
+/* ---------------------------------------------------------------------------------------- */
+
+void IOXP::SetIntMaskTimer(uint8_t bIntMaskTimer)
+{
+	SetField<IOXP_FIELD_INT_MASK_TIMER>(bIntMaskTimer);	
+}
+
+/* ----------------------------------------------------------------------------------------- */
+/*	IOXP::GetIntMaskTimer                                                                    */
+/*                                                                                           */
+/*	Synopsis:                                                                                */
+/*		GetIntMaskTimer();                                                                   */
+/*	Parameters:                                                                              */  
+/*	 	uint8_t -  the information read from INT_MASK_TIMER bits.                            */
+/*					It can be one of the following:                                          */
+/*					IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_DIS		(0)		- disabled           */
+/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_1SEC	(1)		-  1 sec             */
+/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_2SEC	(2)		-  2 sec             */
+/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_30SEC	(0X1E)	- 30 sec             */
+/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_31SEC	(0X1F)	- 31 sec             */
+/*  Return Value:                                                                            */
+/*		 uint8_t  - the INT_MASK_TIMER information of the UNLOCK_TIMERS register             */
+/*                                                                                           */
+/*	Errors:                                                                                  */
+/*                                                                                           */
+/*	Description:                                                                             */
+/*		This function returns the INT_MASK_TIMER information of the UNLOCK_TIMERS register.  */ 
+/* ----------------------------------------------------------------------------------------- */
+
+uint8_t IOXP::GetIntMaskTimer()
+{
+	return GetField<IOXP_FIELD_INT_MASK_TIMER>();
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*	IOXP::SetUnlockTimer                                                               */
+/*                                                                                     */
+/*	Synopsis:                                                                          */
+/*		SetUnlockTimer(uint8_t bUnlockTimer);                                          */
+/*	Parameters:                                                                        */  
+/*	 	uint8_t bUnlockTimer	- the information to be set for UNLOCK_TIMER bits      */
+/*					It can be one of the following time values:                        */
+/*                        IOXP_UNLOCK_TIMER_DIS		- disabled                         */
+/*                        IOXP_UNLOCK_TIMER_1SEC	- 1 sec                            */
+/*                        IOXP_UNLOCK_TIMER_2SEC	- 2 sec                            */
+/*                        IOXP_UNLOCK_TIMER_3SEC	- 3 sec                            */
+/*                        IOXP_UNLOCK_TIMER_4SEC	- 4 sec                            */
+/*                        IOXP_UNLOCK_TIMER_5SEC	- 5 sec	                           */
+/*                        IOXP_UNLOCK_TIMER_6SEC	- 6 sec	                           */
+/*                        IOXP_UNLOCK_TIMER_7SEC	- 7 sec	                           */
+/*	Return Value:                                                                      */
+/*		void                                                                           */
+/*                                                                                     */
+/*	Errors:                                                                            */
+/*                                                                                     */
+/*	Description:                                                                       */
+/*		This function sets the UNLOCK_TIMER information of the UNLOCK_TIMERS register. */ 
+/* ----------------------------------------------------------------------------------- */
+
+void IOXP::SetUnlockTimer(uint8_t bUnlockTimer)
+{
+	SetField<IOXP_FIELD_UNLOCK_TIMER>(bUnlockTimer);	
+}
+
+/* -------------------------------------------------------------------------------------- */
+/*	IOXP::GetUnlockTimer                                                                  */
+/*                                                                                        */
+/*	Synopsis:                                                                             */
+/*		GetUnlockTimer();                                                                 */
+/*	Parameters:                                                                           */  
+/*	                                                                                      */
+/*  Return Value:                                                                         */
+/*		 uint8_t -  the information read from UNLOCK_TIMER bits                           */
+/*					It can be one of the following time values:                           */
+/*                        IOXP_UNLOCK_TIMER_DIS		- disabled                            */
+/*                        IOXP_UNLOCK_TIMER_1SEC	- 1 sec                               */
+/*                        IOXP_UNLOCK_TIMER_2SEC	- 2 sec                               */
+/*                        IOXP_UNLOCK_TIMER_3SEC	- 3 sec                               */
+/*                        IOXP_UNLOCK_TIMER_4SEC	- 4 sec                               */
+/*                        IOXP_UNLOCK_TIMER_5SEC	- 5 sec	                              */
+/*                        IOXP_UNLOCK_TIMER_6SEC	- 6 sec	                              */
+/*                        IOXP_UNLOCK_TIMER_7SEC	- 7 sec	                              */
+/*                                                                                        */
+/*	Errors:                                                                               */
+/*                                                                                        */
+/*	Description:                                                                          */
+/*		This function returns the UNLOCK_TIMER information of the UNLOCK_TIMERS register. */ 
+/* -------------------------------------------------------------------------------------- */
+
+uint8_t IOXP::GetUnlockTimer()
+{
+	return GetField<IOXP_FIELD_UNLOCK_TIMER>();
+}
+
+/* ---------------------------------------------------------------------------------------- */
+/*	IOXP::SetRPullConfig                                                                    */
+/*                                                                                          */
+/*	Synopsis:                                                                               */
+/*		SetRPullConfig(uint8_t *rgbVals);                                                   */
+/*	Parameters:                                                                             */  
+/*	 	uint8_t *rgbVals - 	the array containing five bytes corresponding to RPULL_CONFIG   */
+/*							registers. Each byte contains PULL UP / DOWN options for four   */
+/*							rows or columns, according to ADP5589 documentation.            */
+/*  Return Value:                                                                           */
+/*		void                                                                                */
+/*                                                                                          */
+/*	Errors:                                                                                 */
+/*                                                                                          */
+/*	Description:                                                                            */
+/*		This function sets the value for all five RPULL_CONFIG registers by providing an    */
+/*		array containing five bytes. Each byte contains PULL UP / DOWN options for four     */
+/*		rows or columns, according to ADP5589 documentation.                                */
+/*		The possible options for each row or column are:                                    */
+/*			IOXP_RPULL_CONFIG_300KPU		0	// enable 300 kΩ pull-up                    */
+/*			IOXP_RPULL_CONFIG_300KPD		1	// enable 300 kΩ pull-down                  */
+/*          IOXP_RPULL_CONFIG_100KPU		2	// enable 100 kΩ pull-up                    */
+/*          IOXP_RPULL_CONFIG_NONE			3	// disable all pull-up/pull-down resistors  */
+/*		Note that this information can be accessed for each row or column:                  */
+/*			- for rows using SetRegisterBitsGroup(IOXP_RPULL_CONFIG_R_PULL_CFG(bRowNo))     */
+/*				(bRowNo between 0 and 7).                                                   */
+/*			- for columns using SetRegisterBitsGroup(IOXP_RPULL_CONFIG_C_PULL_CFG(bColNo))  */
+/*				(bColNo between 0 and 10).                                                  */ 
+/* ---------------------------------------------------------------------------------------- */
+
+void IOXP::SetRPullConfig(uint8_t *rgbVals)
+{
+	WriteBytesI2C(IOXP_ADDR_RPULL_CONFIG_A, 5, rgbVals);
+}
+
+/* --------------------------------------------------------------------------------------- */
+/*	IOXP::GetRPullConfig                                                                   */
+/*                                                                                         */
+/*	Synopsis:                                                                              */
+/*		GetRPullConfig(uint8_t *rgbVals);                                                  */
+/*	Parameters:                                                                            */  
+/*	 	uint8_t *rgbVals  - the array containing five bytes corresponding to               */ 
+/*							RPULL_CONFIG registers.                                        */
+/*							Each byte contains PULL UP / DOWN options for four rows        */
+/*							or columns, according to ADP5589 documentation.                */
+/*  Return Value:                                                                          */
+/*		void                                                                               */
+/*                                                                                         */
+/*	Errors:                                                                                */
+/*                                                                                         */
+/*	Description:                                                                           */
+/*		This function retrieves the PULL UP / DOWN option for all rows and columns into an */
+/*		array containing five bytes. Each byte contains PULL UP / DOWN options for four    */
+/*		rows or columns, according to ADP5589 documentation. The possible options for each */
+/*		row or column are:                                                                 */
+/*			IOXP_RPULL_CONFIG_300KPU		0	// enable 300 kO pull-up                   */
+/*			IOXP_RPULL_CONFIG_300KPD		1	// enable 300 kO pull-down                 */
+/*          IOXP_RPULL_CONFIG_100KPU		2	// enable 100 kO pull-up                   */
+/*          IOXP_RPULL_CONFIG_NONE			3	// disable all pull-up/pull-down resistors */
+/*		Note that this information can be accessed for each row or column:                 */
+/*			- for rows using GetRegisterBitsGroup(IOXP_RPULL_CONFIG_R_PULL_CFG(bRowNo))    */
+/*				(bRowNo between 0 and 7).                                                  */
+/*			- for columns using GetRegisterBitsGroup(IOXP_RPULL_CONFIG_C_PULL_CFG(bColNo)) */
+/*				(bColNo between 0 and 10).                                                 */       
+/* --------------------------------------------------------------------------------------- */
+
+void IOXP::GetRPullConfig(uint8_t *rgbVals)
+{
+	ReadBytesI2C(IOXP_ADDR_RPULL_CONFIG_A, 5, rgbVals);
+}
+
+/* ----------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetGPIIntStat                                                                                                                */
+/*                                                                                                                                     */
+/*	Synopsis:                                                                                                                          */
+/*		GetGPIIntStat();                                                                                                               */
+/*	Parameters:                                                                                                                        */  
+/*      void                                                                                                                           */
+/*                                                                                                                                     */
+/*  Return Value:                                                                                                                      */
+/*	 	uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPI_INT bits, for each GPI pin. These bits are          */
+/*					grouped in the three GPI_INT_STAT 8-bit registers corresponding to each of the 19 GPIs.                            */
+/*	Errors:                                                                                                                            */
+/*                                                                                                                                     */
+/*	Description:                                                                                                                       */
+/*		This function returns a value containing in its 19 LSbs the value of the GPI_INT bits, for each GPI pin. These bits are        */
+/*		grouped in the three GPI_INT_STAT 8-bit registers corresponding to each of the 19 GPIs.	This is the function used to read      */
+/*		which of the GPI pin triggered an interrupt. Note that each GPI_INT bit can be accessed using the function                     */
+/*		GetRegisterBit(IOXP_GPI_INT_STAT_GPI_INT(bGPIONo)), where bGPIONo is in the 1 - 19 range.                                      */
+/* ----------------------------------------------------------------------------------------------------------------------------------- */
+
+uint32_t IOXP::GetGPIIntStat()
+{
+	uint32_t bResult = 0;
+	ReadBytesI2C(IOXP_ADDR_GPI_INT_STATUS_A, 3, (uint8_t *)&bResult);
+	return bResult;
+}
+
+/* ---------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetGPIStat                                                                                                                  */
+/*                                                                                                                                    */
+/*	Synopsis:                                                                                                                         */
+/*		GetGPIStat();                                                                                                                 */
+/*	Parameters:                                                                                                                       */  
+/*		void                                                                                                                          */
+/*  Return Value:                                                                                                                     */
+/*		uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPI_STAT bits, for each GPI pin. These bits are        */
+/*		grouped in the three GPI_STATUS 8-bit registers                                                                               */
+/*                                                                                                                                    */
+/*	Errors:                                                                                                                           */
+/*                                                                                                                                    */
+/*	Description:                                                                                                                      */
+/*		This function returns a value containing in its 19 LSbs the value of the GPI_STAT bits, for each GPI pin. These bits are      */
+/*		grouped in the three GPI_STATUS 8-bit registers. This is the function used to read the input value of the GPIOs defined       */
+/*		as inputs.                                                                                                                    */
+/*		Note that each GPI_STAT bit can be accessed using the function GetRegisterBit(IOXP_GPI_STATUS_GPI_STAT(bGPIONo)),             */
+/*		where bGPIONo is in the 1 - 19 range.                                                                                         */
+/* ---------------------------------------------------------------------------------------------------------------------------------- */
+
+uint32_t IOXP::GetGPIStat()
+{
+	uint32_t bResult = 0;
+	ReadBytesI2C(IOXP_ADDR_GPI_STATUS_A, 3, (uint8_t *)&bResult);
+	return bResult;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::ReadSnapshot                                                  */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ReadSnapshot(snap);                                             */
+/*	Parameters:                                                         */  
+/*		IOXPSnapshot &snap	- receives the input state                  */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or one of the IOXP_I2C_ERR_... codes      */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		The fields of snap that could not be read are set to 0.         */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Reads INT_STATUS and STATUS in one burst and the GPI_INT_STATUS */
+/*		and GPI_STATUS banks (0x13 - 0x18) in a second one, instead of  */
+/*		the four transactions of GetRegister, GetRegisterBitsGroup,     */
+/*		GetGPIIntStat and GetGPIStat. The FIFO registers between the    */
+/*		two ranges are not read, as reading them removes events from    */
+/*		the FIFO. Reading GPI_INT_STATUS clears the GPI interrupt       */
+/*		flags in the device; INT_STATUS is not acknowledged.            */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::ReadSnapshot(IOXPSnapshot &snap)
+{
+	uint8_t rgbVals[6];
+	memset(&snap, 0, sizeof(snap));
+	uint8_t bStatus = ReadBytesI2C(IOXP_ADDR_INT_STATUS, 2, rgbVals);
+	if(bStatus != IOXP_I2C_OK)
+	{
+		return bStatus;
+	}
+	snap.bIntStatus = rgbVals[0];
+	snap.bStatus = rgbVals[1];
+	snap.bEventCount = rgbVals[1] & (uint8_t)IOXP_STATUS_EC;
+	bStatus = ReadBytesI2C(IOXP_ADDR_GPI_INT_STATUS_A, 6, rgbVals);
+	if(bStatus != IOXP_I2C_OK)
+	{
+		return bStatus;
+	}
+	snap.dwGPIIntStat = (uint32_t)rgbVals[0] | ((uint32_t)rgbVals[1] << 8) | ((uint32_t)rgbVals[2] << 16);
+	snap.dwGPIStat = (uint32_t)rgbVals[3] | ((uint32_t)rgbVals[4] << 8) | ((uint32_t)rgbVals[5] << 16);
+	return bStatus;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::SetGPIIntLevel                                                                                                           */
+/*                                                                                                                                 */
+/*	Synopsis:                                                                                                                      */
+/*		SetGPIIntLevel(uint32_t dwBitMap);                                                                                         */
+/*	Parameters:                                                                                                                    */  
+/*	 	uint32_t dwBitMap	- the 32-bit value containing in its 19 LSbs the value of the GPI_INT_LEVEL bits, for each GPI pin.    */
+/*							  These bits are grouped in the three GPI_INT_LEVEL 8-bit registers                                    */
+/*                                                                                                                                 */
+/*  Return Value:                                                                                                                  */
+/*		void                                                                                                                       */
+/*                                                                                                                                 */
+/*	Errors:                                                                                                                        */
+/*                                                                                                                                 */
+/*	Description:                                                                                                                   */
+/*		This function sets the value of the GPI_INT_LEVEL bits from GPI_INT_LEVEL registers for all 19 pins by providing a 32-bit  */
+/*		value containing in its 19 bits the specified values.                                                                      */
+/*		Note that each GPI_INT_LEVEL bit can be accessed using the function SetRegisterBit(IOXP_INT_LEVEL_GPI_INT_LEVEL(bGPIONo)), */
+/*		where bGPIONo is in the 1 - 19 range.                                                                                      */
+/* ------------------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::SetGPIIntLevel(uint32_t dwBitMap)
+{
+	WriteBytesI2C(IOXP_ADDR_GPI_INT_LEVEL_A, 3, (uint8_t *)&dwBitMap);
+}
+
+/* -------------------------------------------------------------------------------------------------------------------------------------- */
+/*	 IOXP::GetGPIIntLevel                                                                                                                 */
+/*                                                                                                                                        */
+/*	Synopsis:                                                                                                                             */
+/*		GetGPIIntLevel();                                                                                                                 */
+/*	Parameters:                                                                                                                           */  
+/*	 	 void                                                                                                                             */
+/*		                                                                                                                                  */
+/*	Return Value:																														  */
+/*		 uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPI_INT_LEVEL bits, for each GPI pin. These bits are      */
+/*					grouped in the three GPI_INT_LEVEL 8-bit registers                                                                    */
+/*                                                                                                                                        */
+/*	Errors:                                                                                                                               */
+/*                                                                                                                                        */
+/*	Description:                                                                                                                          */
+/*		This function returns a value containing in its 19 LSbs the value of the GPI_INT_LEVEL bits, for each GPI pin. These bits are     */
+/*		grouped in the three GPI_INT_LEVEL 8-bit registers.                                                                               */
+/*		Note that each GPI_INT_LEVEL bit can be accessed using the function GetRegisterBit(IOXP_INT_LEVEL_GPI_INT_LEVEL(bGPIONo)),        */
+/*		where bGPIONo is in the 1 - 19 range.                                                                                             */
+/* -------------------------------------------------------------------------------------------------------------------------------------- */
+
+uint32_t IOXP::GetGPIIntLevel()
+{
+	uint32_t bResult = 0;
+	ReadBytesI2C(IOXP_ADDR_GPI_INT_LEVEL_A, 3, (uint8_t *)&bResult);
+	return bResult;
+}
+
+/* ---------------------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::SetGPIEventEn                                                                                                                           */
+/*                                                                                                                                                */
+/*	Synopsis:                                                                                                                                     */
+/*		SetGPIEventEn(uint32_t dwBitMap);                                                                                                         */
+/*	Parameters:                                                                                                                                   */  
+/*	 	uint32_t dwBitMap	- the 32-bit value containing in its 19 LSbs the value of the GPI_EVENT_EN bits, for each GPI pin. These bits are     */
+/*							  grouped in the three GPI_EVENT_EN 8-bit registers.                                                                  */
+/*                                                                                                                                                */
+/*  Return Value:                                                                                                                                 */
+/*		void                                                                                                                                      */
+/*                                                                                                                                                */
+/*	Errors:                                                                                                                                       */
+/*                                                                                                                                                */
+/*	Description:                                                                                                                                  */
+/*		This function sets the value of the GPI_EVENT_EN bits from GPI_EVENT_EN registers for all 19 pins by providing a 32-bit value containing  */
+/*		in its 19 bits the specified values.                                                                                                      */
+/*		Note that each GPI_EVENT_EN bit can be accessed using the function SetRegisterBit(IOXP_GPI_EVENT_EN_GPI_EVENT_EN(bGPIONo)),               */
+/*		where bGPIONo is in the 1 - 19 range.                                                                                                     */
+/* ---------------------------------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::SetGPIEventEn(uint32_t dwBitMap)
+{
+	WriteBytesI2C(IOXP_ADDR_GPI_EVENT_EN_A, 3, (uint8_t *)&dwBitMap);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetGPIEventEn                                                                                                                              */
+/*                                                                                                                                                   */
+/*	Synopsis:                                                                                                                                        */
+/*		GetGPIEventEn();                                                                                                                             */
+/*	Parameters:                                                                                                                                      */  
+/*	 	 void                                                                                                                                        */
+/*		                                                                                                                                             */
+/*  Return Value:                                                                                                                                    */
+/*		 uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPI_EVENT_EN bits, for each GPI pin. These bits are grouped in the   */
+/*					three GPI_EVENT_EN 8-bit registers.                                                                                              */
+/*                                                                                                                                                   */
+/*                                                                                                                                                   */
+/*	Errors:                                                                                                                                          */
+/*                                                                                                                                                   */
+/*	Description:                                                                                                                                     */
+/*		This function a value containing in its 19 LSbs the value of the GPI_EVENT_EN bits, for each GPI pin. These bits are grouped in the three    */
+/*		GPI_EVENT_EN 8-bit registers.                                                                                                                */
+/*		Note that each GPI_EVENT_EN bit can be accessed using the function GetRegisterBit(IOXP_GPI_EVENT_EN_GPI_EVENT_EN(bGPIONo)),                  */
+/*		where bGPIONo is in the 1 - 19 range.                                                                                                        */
+/* ------------------------------------------------------------------------------------------------------------------------------------------------- */
+
+uint32_t IOXP::GetGPIEventEn()
+{
+	uint32_t bResult = 0;
+	ReadBytesI2C(IOXP_ADDR_GPI_EVENT_EN_A, 3, (uint8_t *)&bResult);
+	return bResult;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------------------ */
+/*	IOXP::SetGPIDebounceDis                                                                                                       */
+/*                                                                                                                                */
+/*	Synopsis:                                                                                                                     */
+/*		SetGPIDebounceDis(uint32_t dwBitMap);                                                                                     */
+/*	Parameters:                                                                                                                   */  
+/*	 	uint32_t dwBitMap	- the 32-bit value containing in its 19 LSbs the value of the GPI_DEB_DIS bits, for each GPI pin.     */
+/*							  These bits are grouped in the three DEBOUNCE_DIS 8-bit registers.                                   */
+/*                                                                                                                                */
+/*  Return Value:                                                                                                                 */
+/*		 void                                                                                                                     */
+/*                                                                                                                                */
+/*	Errors:                                                                                                                       */
+/*                                                                                                                                */
+/*	Description:                                                                                                                  */
+/*		This function sets the value of the GPI_DEB_DIS bits from DEBOUNCE_DIS registers for all 19 pins by providing a 32-bit    */
+/*		value containing in its 19 bits the specified values.                                                                     */
+/*		Note that each GPI_DEB_DIS bit can be accessed using the function SetRegisterBit(IOXP_DEBOUNCE_DIS_GPI_DEB_DIS(bGPIONo)), */ 
+/*	    where bGPIONo is in the 1 - 19 range.                                                                                     */
+/* ------------------------------------------------------------------------------------------------------------------------------ */
+
+void IOXP::SetGPIDebounceDis(uint32_t dwBitMap)
+{
+	WriteBytesI2C(IOXP_ADDR_DEBOUNCE_DIS_A, 3, (uint8_t *)&dwBitMap);
+}
+
+/* -------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetGPIDebounceDis                                                                                                         */
+/*                                                                                                                                  */
+/*	Synopsis:                                                                                                                       */
+/*		GetGPIDebounceDis();                                                                                                        */
+/*	Parameters:                                                                                                                     */  
+/*	 	 void                                                                                                                       */
+/*  Return Value:                                                                                                                   */
+/*		 uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPI_DEB_DIS bits, for each GPI pin. These bits      */
+/*					are grouped in the three DEBOUNCE_DIS 8-bit registers.                                                          */
+/*                                                                                                                                  */
+/*                                                                                                                                  */
+/*	Errors:                                                                                                                         */
+/*                                                                                                                                  */
+/*	Description:                                                                                                                    */
+/*		This function returns a value containing in its 19 LSbs the value of the GPI_DEB_DIS bits, for each GPI pin. These bits     */
+/*		are grouped in the three DEBOUNCE_DIS 8-bit registers.                                                                      */
+/*		Note that each GPI_DEB_DIS bit can be accessed using the function GetRegisterBit(IOXP_DEBOUNCE_DIS_GPI_DEB_DIS(bGPIONo)),   */
+/*		where bGPIONo is in the 1 - 19 range.                                                                                       */
+/* -------------------------------------------------------------------------------------------------------------------------------- */
+
+uint32_t IOXP::GetGPIDebounceDis()
+{
+	uint32_t bResult = 0;
+	ReadBytesI2C(IOXP_ADDR_DEBOUNCE_DIS_A, 3, (uint8_t *)&bResult);
+	return bResult;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------------------ */
+/*	IOXP::SetGPODataOut                                                                                                           */
+/*                                                                                                                                */
+/*	Synopsis:                                                                                                                     */
+/*		SetGPODataOut(uint32_t dwBitMap);                                                                                         */
+/*	Parameters:                                                                                                                   */  
+/*		uint32_t dwBitMap	- the 32-bit value containing in its 19 LSbs the value of the GPO_DATA bits, for each GPI pin. These  */
+/*							  bits are grouped in the three GPO_DATA_OUT 8-bit registers.                                         */
+/*                                                                                                                                */
+/*  Return Value:                                                                                                                 */
+/*		  void                                                                                                                    */
+/*                                                                                                                                */
+/*	Errors:                                                                                                                       */
+/*                                                                                                                                */
+/*	Description:                                                                                                                  */
+/*		This function sets the value of the GPO_DATA bits from GPO_DATA_OUT registers for all 19 pins by providing a 32-bit value */
+/*		containing in its 19 bits the specified values.                                                                           */
+/*		Note that each GPO_DATA bit can be accessed using the function SetRegisterBit(IOXP_GPO_DATA_OUT_GPO_DATA(bGPIONo)), where */
+/*		bGPIONo is in the 1 - 19 range.                                                                                           */
+/* ------------------------------------------------------------------------------------------------------------------------------ */
+
+void IOXP::SetGPODataOut(uint32_t dwBitMap)
+{
+	WriteBytesI2C(IOXP_ADDR_GPO_DATA_OUT_A, 3, (uint8_t *)&dwBitMap);
+}
+
+/* ----------------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetGPODataOut                                                                                                                      */
+/*                                                                                                                                           */
+/*	Synopsis:                                                                                                                                */
+/*		GetGPODataOut()                                                                                                                      */
+/*	Parameters:                                                                                                                              */  
+/*	 	void                                                                                                                                 */
+/*		                                                                                                                                     */
+/*  Return Value:                                                                                                                            */
+/*		uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPO_DATA bits, for each GPI pin. These bits are grouped in    */
+/*				   the three GPO_DATA_OUT 8-bit registers.                                                                                   */
+/*                                                                                                                                           */
+/*                                                                                                                                           */
+/*	Errors:                                                                                                                                  */
+/*                                                                                                                                           */
+/*	Description:                                                                                                                             */
+/*		This function returns a value containing in its 19 LSbs the value of the GPI_DEB_DIS bits, for each GPI pin. These bits are          */
+/*		grouped in the three DEBOUNCE_DIS 8-bit registers.                                                                                   */
+/*		Note that each GPO_DATA bit can be accessed using the function GetRegisterBit(IOXP_GPO_DATA_OUT_GPO_DATA(bGPIONo)),                  */
+/*		where bGPIONo is in the 1 - 19 range.                                                                                                */
+/* ----------------------------------------------------------------------------------------------------------------------------------------- */
+
+uint32_t IOXP::GetGPODataOut()
+{
+	uint32_t bResult = 0;
+	ReadBytesI2C(IOXP_ADDR_GPO_DATA_OUT_A, 3, (uint8_t *)&bResult);
+	return bResult;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetGpoLatch                                                   */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GetGpoLatch(rgbLatch);                                          */
+/*	Parameters:                                                         */  
+/*		uint8_t *rgbLatch	- receives GPO_DATA_OUT_A, _B and _C        */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or the error of the initial read          */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		The output latch is the copy of the GPO_DATA_OUT registers kept */
+/*		with the register shadow (every write updates it). It is read   */
+/*		from the device only when the object does not know it yet       */
+/*		(after construction or InvalidateRegisterCache). Values staged  */
+/*		by an open batch are included.                                  */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::GetGpoLatch(uint8_t *rgbLatch)
+{
+	uint8_t bStatus = IOXP_I2C_OK;
+	for(uint8_t bIdx = 0; bIdx < 3; bIdx++)
+	{
+		uint8_t bAddr = IOXP_ADDR_GPO_DATA_OUT_A + bIdx;
+		if(!IsShadowValid(bAddr) && !(fBatch && rgbBatchMask[bAddr] == 0xFF))
+		{
+			bool fBatchSave = fBatch;
+			fBatch = false;		// the device value is needed, not the staged one
+			bStatus = ReadBytesI2C(IOXP_ADDR_GPO_DATA_OUT_A, 3, rgbLatch);
+			fBatch = fBatchSave;
+			if(bStatus != IOXP_I2C_OK)
+			{
+				return bStatus;
+			}
+			break;
+		}
+	}
+	for(uint8_t bIdx = 0; bIdx < 3; bIdx++)
+	{
+		uint8_t bAddr = IOXP_ADDR_GPO_DATA_OUT_A + bIdx;
+		uint8_t bMask = fBatch ? rgbBatchMask[bAddr] : 0;
+		rgbLatch[bIdx] = (rgbShadow[bAddr] & ~bMask) | (rgbBatchVal[bAddr] & bMask);
+	}
+	return bStatus;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::GpoUpdate                                                     */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GpoUpdate(dwClear, dwSet, dwToggle);                            */
+/*	Parameters:                                                         */  
+/*		uint32_t dwClear	- GPOs to set to 0                          */
+/*		uint32_t dwSet		- GPOs to set to 1, after dwClear           */
+/*		uint32_t dwToggle	- GPOs to invert, after dwSet               */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or one of the IOXP_I2C_ERR_... codes      */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Computes the new GPO_DATA_OUT bytes from the output latch and   */
+/*		writes only the changed ones (from the first to the last) in    */
+/*		one burst. Nothing is written if no output changes.             */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::GpoUpdate(uint32_t dwClear, uint32_t dwSet, uint32_t dwToggle)
+{
+	uint8_t rgbLatch[3];
+	uint8_t rgbNew[3];
+	uint8_t bFirst = 0xFF;
+	uint8_t bLast = 0;
+	uint8_t bStatus = GetGpoLatch(rgbLatch);
+	if(bStatus != IOXP_I2C_OK)
+	{
+		return bStatus;
+	}
+	for(uint8_t bIdx = 0; bIdx < 3; bIdx++)
+	{
+		uint8_t bShift = 8 * bIdx;
+		rgbNew[bIdx] = ((rgbLatch[bIdx] & ~(uint8_t)(dwClear >> bShift)) | (uint8_t)(dwSet >> bShift)) ^ (uint8_t)(dwToggle >> bShift);
+		if(bIdx == 2)
+		{
+			rgbNew[bIdx] &= 0x07;	// GPIO 17 - 19
+		}
+		if(rgbNew[bIdx] != rgbLatch[bIdx])
+		{
+			if(bFirst == 0xFF)
+			{
+				bFirst = bIdx;
+			}
+			bLast = bIdx;
+		}
+	}
+	if(bFirst == 0xFF)
+	{
+		return IOXP_I2C_OK;
+	}
+	return WriteBytesI2C(IOXP_ADDR_GPO_DATA_OUT_A + bFirst, bLast - bFirst + 1, rgbNew + bFirst);
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::GpoSet                                                        */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GpoSet(dwMask);                                                 */
+/*	Parameters:                                                         */  
+/*		uint32_t dwMask	- the GPOs to set, bit x - 1 for GPIO x         */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or one of the IOXP_I2C_ERR_... codes      */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Sets the GPO outputs of dwMask to 1, leaving the others         */
+/*		unchanged. Only the changed GPO_DATA_OUT registers are written, */
+/*		in one burst, without reading the device (see GetGpoLatch).     */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::GpoSet(uint32_t dwMask)
+{
+	return GpoUpdate(0, dwMask, 0);
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::GpoClear                                                      */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GpoClear(dwMask);                                               */
+/*	Parameters:                                                         */  
+/*		uint32_t dwMask	- the GPOs to clear, bit x - 1 for GPIO x       */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or one of the IOXP_I2C_ERR_... codes      */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Sets the GPO outputs of dwMask to 0, see GpoSet.                */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::GpoClear(uint32_t dwMask)
+{
+	return GpoUpdate(dwMask, 0, 0);
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::GpoToggle                                                     */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GpoToggle(dwMask);                                              */
+/*	Parameters:                                                         */  
+/*		uint32_t dwMask	- the GPOs to invert, bit x - 1 for GPIO x      */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or one of the IOXP_I2C_ERR_... codes      */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Inverts the GPO outputs of dwMask, see GpoSet.                  */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::GpoToggle(uint32_t dwMask)
+{
+	return GpoUpdate(0, 0, dwMask);
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::GpoWrite                                                      */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GpoWrite(dwMask, dwValue);                                      */
+/*	Parameters:                                                         */  
+/*		uint32_t dwMask		- the GPOs to write, bit x - 1 for GPIO x   */
+/*		uint32_t dwValue	- the new values of the GPOs of dwMask      */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or one of the IOXP_I2C_ERR_... codes      */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Copies the bits of dwValue selected by dwMask to the GPO        */
+/*		outputs, see GpoSet.                                            */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::GpoWrite(uint32_t dwMask, uint32_t dwValue)
+{
+	return GpoUpdate(dwMask, dwValue & dwMask, 0);
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::GpoRead                                                       */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GpoRead();                                                      */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint32_t - the output latch, bit x - 1 for GPIO x               */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		0 is returned if the latch could not be read.                   */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the GPO output values from the output latch, without    */
+/*		reading the device (see GetGpoLatch).                           */
+/* -------------------------------------------------------------------- */
+
+uint32_t IOXP::GpoRead()
+{
+	uint8_t rgbLatch[3];
+	if(GetGpoLatch(rgbLatch) != IOXP_I2C_OK)
+	{
+		return 0;
+	}
+	return (uint32_t)rgbLatch[0] | ((uint32_t)rgbLatch[1] << 8) | ((uint32_t)rgbLatch[2] << 16);
+}
+
+/* ---------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::SetGPOOutMode                                                                                                               */
+/*                                                                                                                                    */
+/*	Synopsis:                                                                                                                         */
+/*		SetGPOOutMode(uint32_t dwBitMap);                                                                                             */
+/*	Parameters:                                                                                                                       */  
+/*	 	uint32_t dwBitMap	- the 32-bit value containing in its 19 LSbs the value of the GPO_OUT_MODE bits, for each GPI pin.        */
+/*								  These bits are grouped in the three GPO_OUT_MODE 8-bit registers.                                   */
+/*	                                                                                                                                  */
+/*  Return Value:                                                                                                                     */
+/*		void                                                                                                                          */
+/*                                                                                                                                    */
+/*	Errors:                                                                                                                           */
+/*                                                                                                                                    */
+/*	Description:                                                                                                                      */
+/*		This function sets the value of the GPO_OUT_MODE bits from GPO_OUT_MODE registers for all 19 pins by providing a 32-bit value */
+/*		containing in its 19 bits the specified values.                                                                               */
+/*		Note that each GPO_OUT_MODE bit can be accessed using the function SetRegisterBit(IOXP_GPO_OUT_MODE_GPO_OUT_MODE(bGPIONo)),   */
+/*		where bGPIONo is in the 1 - 19 range.                                                                                         */
+/* ---------------------------------------------------------------------------------------------------------------------------------- */
+
+
+void IOXP::SetGPOOutMode(uint32_t dwBitMap)
+{
+	WriteBytesI2C(IOXP_ADDR_GPO_DATA_OUT_A, 3, (uint8_t *)&dwBitMap);
+}
+
+/* ------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetGPOOutMode                                                                                                            */
+/*                                                                                                                                 */
+/*	Synopsis:                                                                                                                      */
+/*		GetGPOOutMode()                                                                                                            */
+/*	Parameters:                                                                                                                    */  
+/*		void                                                                                                                       */
+/*		                                                                                                                           */
+/*  Return Value:                                                                                                                  */
+/*		 uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPO_OUT_MODE bits, for each GPI pin. These bits    */
+/*					are grouped in the three GPO_OUT_MODE 8-bit registers.                                                         */
+/*                                                                                                                                 */
+/*                                                                                                                                 */
+/*	Errors:                                                                                                                        */
+/*                                                                                                                                 */
+/*	Description:                                                                                                                   */
+/*		This function retrieves the value of the GPO_OUT_MODE bits from GPO_OUT_MODE registers for all 19 pins.                    */
+/*		Note that each GPO_OUT_MODE bit can be accessed using the function GetRegisterBit(IOXP_GPO_OUT_MODE_GPO_OUT_MODE(bGPIONo)),*/
+/*		where bGPIONo is in the 1 - 19 range.                                                                                      */
+/* ------------------------------------------------------------------------------------------------------------------------------- */
+
+
+uint32_t IOXP::GetGPOOutMode()
+{
+	uint32_t bResult = 0;
+	ReadBytesI2C(IOXP_ADDR_GPO_DATA_OUT_A, 3, (uint8_t *)&bResult);
+	return bResult;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::SetGPIODirection                                                                                                                     */
+/*                                                                                                                                             */
+/*	Synopsis:                                                                                                                                  */
+/*		SetGPIODirection(uint32_t dwBitMap);                                                                                                   */
+/*	Parameters:                                                                                                                                */  
+/*		uint32_t dwBitMap	- the 32-bit value containing in its 19 LSbs the value of the GPIO_DIR bits, for each GPI pin. These bits are      */
+/*							  grouped in the three GPIO_DIRECTION 8-bit registers                                                              */
+/*                                                                                                                                             */
+/*  Return Value:                                                                                                                              */
+/*		void                                                                                                                                   */
+/*                                                                                                                                             */
+/*	Errors:                                                                                                                                    */
+/*                                                                                                                                             */
+/*	Description:                                                                                                                               */
+/*		This function sets the value of the GPIO_DIR bits from GPIO_DIRECTION registers for all 19 pins by providing a 32-bit value containing */
+/*		in its 19 bits the specified values.                                                                                                   */
+/*		Note that each GPIO_DIR bit can be accessed using the function SetRegisterBit(IOXP_GPIO_DIRECTION_GPIO_DIR(bGPIONo)), where	bGPIONo    */
+/*		is in the 1 - 19 range.                                                                                                                */
+/* ------------------------------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::SetGPIODirection(uint32_t dwBitMap)
+{
+	WriteBytesI2C(IOXP_ADDR_GPIO_DIRECTION_A, 3, (uint8_t *)&dwBitMap);
+}
+
+/* ----------------------------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::GetGPIODirection                                                                                                                   */
+/*                                                                                                                                           */
+/*	Synopsis:                                                                                                                                */
+/*		GetGPIODirection();                                                                                                                  */
+/*	Parameters:                                                                                                                              */  
+/*		void                                                                                                                                 */
+/*		                                                                                                                                     */
+/*  Return Value:                                                                                                                            */
+/*		uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPIO_DIR bits, for each GPI pin. These bits are grouped in    */
+/*				   the three GPIO_DIRECTION 8-bit registers                                                                                  */
+/*                                                                                                                                           */
+/*                                                                                                                                           */
+/*	Errors:                                                                                                                                  */
+/*                                                                                                                                           */
+/*	Description:                                                                                                                             */
+/*		This function returns a value containing in its 19 LSbs the value of the GPIO_DIR bits, for each GPI pin. These bits are grouped     */
+/*		in the three GPIO_DIRECTION 8-bit registers.                                                                                         */
+/*		Note that each GPIO_DIR bit can be accessed using the function GetRegisterBit(IOXP_GPIO_DIRECTION_GPIO_DIR(bGPIONo)), where bGPIONo  */
+/*		is in the 1 - 19 range.                                                                                                              */
+/* ----------------------------------------------------------------------------------------------------------------------------------------- */
+
+uint32_t IOXP::GetGPIODirection()
+{
+	uint32_t bResult = 0;
+	ReadBytesI2C(IOXP_ADDR_GPIO_DIRECTION_A, 3, (uint8_t *)&bResult);
+	return bResult;
+}
+
+/* -------------------------------------------------------------------------------------------- */
+/*	IOXP::SetResetCfgResetTriggerTime                                                           */
+/*                                                                                              */
+/*	Synopsis:                                                                                   */
+/*		SetResetCfgResetTriggerTime(uint8_t bResetTriggerTime);                                 */
+/*	Parameters:                                                                                 */  
+/*	 	uint8_t bResetTriggerTime	- the information to be set for RESET_TRIGGER_TIME bits     */
+/*					It can be one of the following time values:                                 */
+/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_IMMED		0	// Immediate                */
+/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_1D0SEC	1	// 1.0 sec                  */
+/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_1D5SEC	2	// 1.5 sec                  */
+/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_2D0SEC	3	// 2.0 sec                  */
+/*				IOXP_RESET_CFG_RESET_TRIGGER_TIME_2D5SEC	4	// 2.5 sec                      */
+/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_3D0SEC	5	// 3.0 sec                  */
+/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_3D5SEC	6	// 3.5 sec                  */
+/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_4D0SEC	7	// 4.0 sec                  */
+/*	                                                                                            */
+/*  Return Value:                                                                               */
+/*		void                                                                                    */
+/*                                                                                              */
+/*	Errors:                                                                                     */
+/*                                                                                              */
+/*	Description:                                                                                */
+/*		This function sets the RESET_TRIGGER_TIME information of the RESET_CFG register.        */
+/* -------------------------------------------------------------------------------------------- */
+
+void IOXP::SetResetCfgResetTriggerTime(uint8_t bResetTriggerTime)
+{
+	SetField<IOXP_FIELD_RESET_TRIGGER_TIME>(bResetTriggerTime);	
+}
+
+/* ----------------------------------------------------------------------------------------- */
+/*	IOXP::GetResetCfgResetTriggerTime                                                        */
+/*                                                                                           */
+/*	Synopsis:                                                                                */
+/*		GetResetCfgResetTriggerTime();                                                       */
+/*	Parameters:                                                                              */  
+/*	 	void                                                                                 */
+/*		                                                                                     */
+/*  Return Value:                                                                            */
+/*		uint8_t -  the information read from RESET_TRIGGER_TIME bits                         */
+/* 					It can be one of the following time values:                              */
+/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_IMMED		0	// Immediate             */
+/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_1D0SEC	1	// 1.0 sec               */
+/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_1D5SEC	2	// 1.5 sec               */
+/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_2D0SEC	3	// 2.0 sec               */
+/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_2D5SEC	4	// 2.5 sec               */
+/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_3D0SEC	5	// 3.0 sec               */
+/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_3D5SEC	6	// 3.5 sec               */
+/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_4D0SEC	7	// 4.0 sec               */
+/*                                                                                           */
+/*	Errors:                                                                                  */
+/*                                                                                           */
+/*	Description:                                                                             */
+/*		This function returns the RESET_TRIGGER_TIME information of the RESET_CFG register.  */
+/* ----------------------------------------------------------------------------------------- */
+
+uint8_t IOXP::GetResetCfgResetTriggerTime()
+{
+	return GetField<IOXP_FIELD_RESET_TRIGGER_TIME>();
+}
+
+/* --------------------------------------------------------------------------------------- */
+/*	IOXP::SetResetCfgResetPulseWidth                                                       */
+/*                                                                                         */
+/*	Synopsis:                                                                              */
+/*		SetResetCfgResetPulseWidth(uint8_t bResetPulseWidth);                              */
+/*	Parameters:                                                                            */  
+/*	 	uint8_t bResetPulseWidth	- the information to be set for RESET_PULSE_WIDTH bits */
+/*					It can be one of the following time values:                            */
+/*						IOXP_RESET_CFG_RESET_PULSE_WIDTH_500US		0	- 500 us           */
+/*                      IOXP_RESET_CFG_RESET_PULSE_WIDTH_1MS		1	- 1 ms             */
+/*                    	 IOXP_RESET_CFG_RESET_PULSE_WIDTH_2MS		2	- 2 ms             */
+/*                      IOXP_RESET_CFG_RESET_PULSE_WIDTH_10MS		3	- 10 ms            */
+/*		                                                                                   */
+/*  Return Value:                                                                          */
+/*		void                                                                               */
+/*                                                                                         */
+/*	Errors:                                                                                */
+/*                                                                                         */
+/*	Description:                                                                           */
+/*		This function sets the RESET_PULSE_WIDTH information of the RESET_CFG register.    */
+/* --------------------------------------------------------------------------------------- */
+
+void IOXP::SetResetCfgResetPulseWidth(uint8_t bResetPulseWidth)
+{
+	SetField<IOXP_FIELD_RESET_PULSE_WIDTH>(bResetPulseWidth);	
+}
+
+/* ------------------------------------------------------------------------------------------- */
+/*	IOXP::GetResetCfgResetPulseWidth                                                           */
+/*                                                                                             */
+/*	Synopsis:                                                                                  */
+/*		GetResetCfgResetPulseWidth(uint8_t bResetPulseWidth)                                   */
+/*	Parameters:                                                                                */  
+/*	 	 uint8_t bResetPulseWidth	- the information read from RESET_PULSE_WIDTH bits         */
+/*					It can be one of the following time values:                                */
+/*						IOXP_RESET_CFG_RESET_PULSE_WIDTH_500US		0	- 500 us               */
+/*                      IOXP_RESET_CFG_RESET_PULSE_WIDTH_1MS		1	- 1 ms                 */
+/*                      IOXP_RESET_CFG_RESET_PULSE_WIDTH_2MS		2	- 2 ms                 */
+/*                      IOXP_RESET_CFG_RESET_PULSE_WIDTH_10MS		3	- 10 ms		           */			
+/*                                                                                             */
+/*  Return Value:                                                                              */
+/*		  uint8_t - returns RESET_PULSE_WIDTH information of the RESET_CFG register            */
+/*                                                                                             */
+/*	Errors:                                                                                    */
+/*                                                                                             */
+/*	Description:                                                                               */
+/*		 This function returns the RESET_PULSE_WIDTH information of the RESET_CFG register.    */
+/* ------------------------------------------------------------------------------------------- */
+
+uint8_t IOXP::GetResetCfgResetPulseWidth(uint8_t bResetPulseWidth)
+{
+	return GetField<IOXP_FIELD_RESET_PULSE_WIDTH>();
+}
+
+/* -------------------------------------------------------------------------------------------------------------------- */
+/*	IOXP::SetPWMOffTimeUS                                                                                               */
+/*                                                                                                                      */
+/*	Synopsis:                                                                                                           */
+/*		 SetPWMOffTimeUS(uint16_t wOffTime);                                                                            */
+/*	Parameters:                                                                                                         */  
+/*	 	 uint16_t wOffTime	- the 16 bits value containing the off time (in us)                                         */
+/*                                                                                                                      */
+/*  Return Value:                                                                                                       */
+/*		  void                                                                                                          */
+/*                                                                                                                      */
+/*	Errors:                                                                                                             */
+/*                                                                                                                      */
+/*	Description:                                                                                                        */
+/*		This function sets the PWM off time (expressed in micro seconds) by providing a 16 bits value corresponding to  */
+/*		PWM_OFFT_LOW and PWM_OFFT_HIGH registers                                                                        */
+/* -------------------------------------------------------------------------------------------------------------------- */
+
+void IOXP::SetPWMOffTimeUS(uint16_t wOffTime)
+{
+	WriteBytesI2C(IOXP_ADDR_PWM_OFFT_LOW, 2, (uint8_t *)&wOffTime);
+}
+
+/* ------------------------------------------------------------------------------ */
+/*	IOXP::GetPWMOffTimeUS                                                         */
+/*                                                                                */
+/*	Synopsis:                                                                     */
+/*		GetPWMOffTimeUS();                                                        */       
+/*	Parameters:                                                                   */  
+/*		void                                                                      */
+/*		                                                                          */
+/*  Return Value:                                                                 */
+/*		uint16_t - the 16 bits value containing the off time (in us)              */
+/*                                                                                */
+/*                                                                                */
+/*	Errors:                                                                       */
+/*                                                                                */
+/*	Description:                                                                  */
+/*		This function returns the PWM off time (expressed in micro seconds) as a  */
+/*		16 bits value contained in PWM_OFFT_LOW and PWM_OFFT_HIGH registers.      */
+/* ------------------------------------------------------------------------------ */
+
+
+uint16_t IOXP::GetPWMOffTimeUS()
+{
+	uint16_t wResult;
+	ReadBytesI2C(IOXP_ADDR_PWM_OFFT_LOW, 2, (uint8_t *)&wResult);
+	return wResult;
+}
+
+/* -------------------------------------------------------------------------------------------------- */
+/*	IOXP::SetPWMOnTimeUS                                                                              */
+/*                                                                                                    */
+/*	Synopsis:                                                                                         */
+/*		SetPWMOnTimeUS(uint16_t wOnTime)                                                              */
+/*	Parameters:                                                                                       */  
+/*		uint16_t wOnTime	- the 16 bits value containing the on time (in us)                        */
+/*                                                                                                    */
+/*  Return Value:                                                                                     */
+/*		void                                                                                          */
+/*                                                                                                    */
+/*                                                                                                    */
+/*	Errors:                                                                                           */
+/*                                                                                                    */
+/*	Description:                                                                                      */
+/*		This function sets the PWM on time (expressed in micro seconds) by providing a 16 bits value  */
+/*		corresponding to PWM_ONT_LOW and PWM_ONT_HIGH registers                                       */
+/* -------------------------------------------------------------------------------------------------- */
+
+
+void IOXP::SetPWMOnTimeUS(uint16_t wOnTime)
+{
+	WriteBytesI2C(IOXP_ADDR_PWM_ONT_LOW, 2, (uint8_t *)&wOnTime);
+}
+
+/* ----------------------------------------------------------------------------- */
+/*	IOXP::GetPWMOnTimeUS                                                         */
+/*                                                                               */
+/*	Synopsis:                                                                    */
+/*		GetPWMOnTimeUS()                                                         */
+/*	Parameters:                                                                  */  
+/*		void                                                                     */
+/*		                                                                         */
+/*  Return Value:                                                                */
+/*		uint16_t - the 16 bits value containing the on time (in us)              */
+/*                                                                               */
+/*	Errors:                                                                      */
+/*                                                                               */
+/*	Description:                                                                 */
+/*		This function returns the PWM on time (expressed in micro seconds)       */
+/*		as a 16 bits value contained in PWM_ONT_LOW and PWM_ONT_HIGH registers.  */
+/* ----------------------------------------------------------------------------- */
+
+
+uint16_t IOXP::GetPWMOnTimeUS()
+{
+	uint16_t wResult;
+	ReadBytesI2C(IOXP_ADDR_PWM_ONT_LOW, 2, (uint8_t *)&wResult);
+	return wResult;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*	IOXP::SetClkDivClkDiv                                                                        */
+/*                                                                                               */
+/*	Synopsis:                                                                                    */
+/*		SetClkDivClkDiv(uint8_t bClkDiv);                                                        */
+/*	Parameters:                                                                                  */  
+/*		uint8_t bClkDiv	- the information to be set for CLK_DIV                                  */
+/*				It can be one of the following:                                                  */
+/*					IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV1		(0X00)	// divide by 1 (pass-through).   */
+/*                  IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV2		(0X01)	// divide by 2.                  */
+/*                  IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV3		(0X02)	// divide by 3.                  */
+/*                    IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV4		(0X03)	// divide by 4.              */
+/*					IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV32	(0X1F)	// divide by 32.                 */
+/*                                                                                               */
+/*  Return Value:                                                                                */
+/*		void                                                                                     */
+/*                                                                                               */
+/*	Errors:                                                                                      */
+/*                                                                                               */
+/*	Description:                                                                                 */
+/*		This function sets the CLK_DIV information of the CLOCK_DIV_CFG register.                */
+/* --------------------------------------------------------------------------------------------- */
+
+
+void IOXP::SetClkDivClkDiv(uint8_t bClkDiv)
+{
+	SetField<IOXP_FIELD_CLK_DIV>(bClkDiv);	
+}
+
+
+/* ----------------------------------------------------------------------------------------------- */
+/*	IOXP::GetClkDivClkDiv                                                                          */
+/*                                                                                                 */
+/*	Synopsis:                                                                                      */
+/*		GetClkDivClkDiv()                                                                          */
+/*	Parameters:                                                                                    */  
+/*	 	 void                                                                                      */
+/*		                                                                                           */
+/*		 uint8_t -  the information read from CLK_DIV                                              */
+/*					It can be one of the following:                                                */
+/*					    IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV1		(0X00)	// divide by 1 (pass-through). */
+/*                      IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV2		(0X01)	// divide by 2.                */
+/*                      IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV3		(0X02)	// divide by 3.                */
+/*                      IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV4		(0X03)	// divide by 4.                */
+/*                      IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV32	(0X1F)	// divide by 32.               */
+/*                                                                                                 */
+/*                                                                                                 */
+/*	Errors:                                                                                        */
+/*                                                                                                 */
+/*	Description:                                                                                   */
+/*		This function returns the CLK_DIV information of the CLOCK_DIV_CFG register.               */
+/* ----------------------------------------------------------------------------------------------- */
+
+
+uint8_t IOXP::GetClkDivClkDiv()
+{
+	return GetField<IOXP_FIELD_CLK_DIV>();
+}
+
+
+/* ------------------------------------------------------------------------------ */
+/*	IOXP::SetLogicSel1                                                            */
+/*                                                                                */
+/*	Synopsis:                                                                     */
+/*		SetLogicSel1(uint8_t bLogicSel)                                           */
+/*	Parameters:                                                                   */  
+/*		uint8_t bLogicSel - the information to be set for LOGIC1_SEL              */
+/*			It can be one of the following:                                       */
+/*				IOXP_LOGIC_CFG_LOGIC_SEL_OFF		(0x00)	// off/disable        */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_AND		(0x01)	// AND                */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_OR			(0x02)	// OR                 */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_XOR		(0x03)	// XOR                */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_FF			(0x04)	// FF                 */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_IN_LA		(0x05)	// IN_LA              */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_IN_LB		(0x06)	// IN_LB              */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_IN_LC		(0x07)	// IN_LC              */
+/*                                                                                */
+/*  Return Value:                                                                 */
+/*		void                                                                      */
+/*                                                                                */
+/*	Errors:                                                                       */
+/*                                                                                */
+/*	Description:                                                                  */
+/*		This function sets the LOGIC1_SEL information of the LOGIC1_CFG register. */
+/* ------------------------------------------------------------------------------ */
+
+void IOXP::SetLogicSel1(uint8_t bLogicSel)
+{
+	SetField<IOXP_FIELD_LOGIC1_SEL>(bLogicSel);	
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*	IOXP::GetLogicSel1                                                                 */
+/*                                                                                     */
+/*	Synopsis:                                                                          */
+/*		  GetLogicSel1();                                                              */
+/*	Parameters:                                                                        */  
+/*	 	  void                                                                         */
+/*		                                                                               */
+/*  Return Value:                                                                      */
+/*		uint8_t -  the information read from LOGIC1_SEL                                */
+/*			It can be one of the following:                                            */
+/*				IOXP_LOGIC_CFG_LOGIC_SEL_OFF		(0x00)	// off/disable             */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_AND		(0x01)	// AND                     */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_OR			(0x02)	// OR                      */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_XOR		(0x03)	// XOR                     */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_FF			(0x04)	// FF                      */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_IN_LA		(0x05)	// IN_LA                   */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_IN_LB		(0x06)	// IN_LB                   */
+/*              IOXP_LOGIC_CFG_LOGIC_SEL_IN_LC		(0x07)	// IN_LC                   */
+/*                                                                                     */
+/*                                                                                     */
+/*	Errors:                                                                            */
+/*                                                                                     */
+/*	Description:                                                                       */
+/*		  This function returns the LOGIC1_SEL information of the LOGIC1_CFG register. */
+/* ----------------------------------------------------------------------------------- */
+
+uint8_t IOXP::GetLogicSel1()
+{
+	return GetField<IOXP_FIELD_LOGIC1_SEL>();
+}
+
+/* ------------------------------------------------------------------------------ */
+/*	IOXP::SetLogicSel2                                                            */
+/*                                                                                */
+/*	Synopsis:                                                                     */
+/*		SetLogicSel2(uint8_t bLogicSel);                                          */
+/*	Parameters:                                                                   */  
+/*		uint8_t bLogicSel - the information to be set for LOGIC2_SEL              */
+/*				It can be one of the following:                                   */
+/*					IOXP_LOGIC_CFG_LOGIC_SEL_OFF		(0x00)	// off/disable    */
+/*                  IOXP_LOGIC_CFG_LOGIC_SEL_AND		(0x01)	// AND            */
+/*                  IOXP_LOGIC_CFG_LOGIC_SEL_OR			(0x02)	// OR             */
+/*                  IOXP_LOGIC_CFG_LOGIC_SEL_XOR		(0x03)	// XOR            */
+/*                 IOXP_LOGIC_CFG_LOGIC_SEL_FF			(0x04)	// FF             */
+/*                  IOXP_LOGIC_CFG_LOGIC_SEL_IN_LA		(0x05)	// IN_LA          */
+/*                  IOXP_LOGIC_CFG_LOGIC_SEL_IN_LB		(0x06)	// IN_LB          */
+/*                  IOXP_LOGIC_CFG_LOGIC_SEL_IN_LC		(0x07)	// IN_LC          */
+/*                                                                                */
+/*  Return Value:                                                                 */
+/*		void                                                                      */
+/*                                                                                */
+/*	Errors:                                                                       */
+/*                                                                                */
+/*	Description:                                                                  */
+/*		This function sets the LOGIC2_SEL information of the LOGIC2_CFG register. */
+/* ------------------------------------------------------------------------------ */
+
+void IOXP::SetLogicSel2(uint8_t bLogicSel)
+{
+	SetField<IOXP_FIELD_LOGIC2_SEL>(bLogicSel);	
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*	IOXP::GetLogicSel2                                                                 */
+/*                                                                                     */
+/*	Synopsis:                                                                          */
+/*		GetLogicSel2();                                                                */
+/*	Parameters:                                                                        */  
+/*	 	void                                                                           */
+/*		                                                                               */
+/*  Return Value:                                                                      */
+/*		uint8_t -  the information read from LOGIC2_SEL                                */
+/*				It can be one of the following:                                        */
+/*		    		IOXP_LOGIC_CFG_LOGIC_SEL_OFF		(0x00)	// off/disable         */
+/*                  IOXP_LOGIC_CFG_LOGIC_SEL_AND		(0x01)	// AND                 */
+/*                  IOXP_LOGIC_CFG_LOGIC_SEL_OR			(0x02)	// OR                  */
+/*                  IOXP_LOGIC_CFG_LOGIC_SEL_XOR		(0x03)	// XOR                 */
+/*                  IOXP_LOGIC_CFG_LOGIC_SEL_FF			(0x04)	// FF                  */
+/*                  IOXP_LOGIC_CFG_LOGIC_SEL_IN_LA		(0x05)	// IN_LA               */
+/*                   IOXP_LOGIC_CFG_LOGIC_SEL_IN_LB		(0x06)	// IN_LB               */
+/*                  IOXP_LOGIC_CFG_LOGIC_SEL_IN_LC		(0x07)	// IN_LC               */
+/*                                                                                     */
+/*	Errors:                                                                            */
+/*                                                                                     */
+/*	Description:                                                                       */
+/*		This function returns the LOGIC2_SEL information of the LOGIC2_CFG register.   */
+/* ----------------------------------------------------------------------------------- */
+
+uint8_t IOXP::GetLogicSel2()
+{
+	return GetField<IOXP_FIELD_LOGIC2_SEL>();
+}
+
+/* ---------------------------------------------------------------------------------- */
+/* 	IOXP::SetPollTime                                                                 */
+/*                                                                                    */
+/*	Synopsis:                                                                         */
+/*		SetPollTime(uint8_t bPollTime)                                                */
+/*	Parameters:                                                                       */  
+/*	 	 uint8_t bPollTime	- the information to be set for POLL_TIME bits.           */
+/*				It can be one of the following time values::                          */
+/*					IOXP_POLL_TIME_CFG_KEY_POLL_TIME_10MS	(0x00)	- 10 ms           */
+/*					IOXP_POLL_TIME_CFG_KEY_POLL_TIME_20MS	(0x01)	- 20 ms           */
+/*					IOXP_POLL_TIME_CFG_KEY_POLL_TIME_30MS	(0x02)	- 30 ms           */
+/*					IOXP_POLL_TIME_CFG_KEY_POLL_TIME_40MS	(0x03)	- 40 ms           */                       
+/*		                                                                              */
+/*  Return Value:                                                                     */
+/*		 void                                                                         */
+/*                                                                                    */
+/*	Errors:                                                                           */
+/*                                                                                    */
+/*	Description:                                                                      */
+/*		 This function sets the POLL_TIME information of the POLL_TIME_CFG register.  */
+/* ---------------------------------------------------------------------------------- */
+
+void IOXP::SetPollTime(uint8_t bPollTime)
+{
+	SetField<IOXP_FIELD_KEY_POLL_TIME>(bPollTime);	
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*	IOXP::GetPollTime                                                                  */
+/*                                                                                     */
+/*	Synopsis:                                                                          */
+/*		GetPollTime();                                                                 */
+/*	Parameters:                                                                        */  
+/*		void                                                                           */
+/*		                                                                               */
+/*  Return Value:                                                                      */
+/*		uint8_t -  the information read from POLL_TIME bits                            */
+/*                                                                                     */
+/*                                                                                     */
+/*	Errors:                                                                            */
+/*                                                                                     */
+/*	Description:                                                                       */
+/*		This function returns the POLL_TIME information of the POLL_TIME_CFG register. */
+/* ----------------------------------------------------------------------------------- */
+
+uint8_t IOXP::GetPollTime()
+{
+	return GetField<IOXP_FIELD_KEY_POLL_TIME>();
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*	IOXP::SetCoreFreq                                                                  */
+/*                                                                                     */
+/*	Synopsis:                                                                          */
+/*		SetCoreFreq(uint8_t bCoreFreq);                                                */
+/*	Parameters:                                                                        */  
+/*		uint8_t bCoreFreq	- the information to be set for CORE_FREQ bits             */
+/*			It can be one of the following:                                            */
+/*				IOXP_GENERAL_CFG_B_CORE_FREQ_50K		(0x00)	-  50 kHz              */
+/*				IOXP_GENERAL_CFG_B_CORE_FREQ_100K		(0x01)	- 100 kHz              */
+/*				IOXP_GENERAL_CFG_B_CORE_FREQ_200K		(0x02)	- 200 kHz              */
+/*				IOXP_GENERAL_CFG_B_CORE_FREQ_500K	    (0x03)	- 500 kHz              */
+/*                                                                                     */
+/*  Return Value:                                                                      */
+/*		  void                                                                         */
+/*                                                                                     */
+/*	Errors:                                                                            */
+/*                                                                                     */
+/*	Description:                                                                       */
+/*		 This function sets the CORE_FREQ information of the GENERAL_CFG_B register.   */
+/* ----------------------------------------------------------------------------------- */
+
+void IOXP::SetCoreFreq(uint8_t bCoreFreq)
+{
+	SetField<IOXP_FIELD_CORE_FREQ>(bCoreFreq);	
+}
+
+/* ------------------------------------------------------------------------------------- */
+/*	IOXP::GetCoreFreq                                                                    */
+/*                                                                                       */
+/*	Synopsis:                                                                            */
+/*		GetCoreFreq();                                                                   */
+/*	Parameters:                                                                          */  
+/*	 	  void                                                                           */
+/*		                                                                                 */
+/*  Return Value:                                                                        */ 
+/*		  uint8_t - the information read from CORE_FREQ bits.                            */
+/*				It can be one of the following:                                          */
+/*					IOXP_GENERAL_CFG_B_CORE_FREQ_50K		(0x00)	-  50 kHz            */
+/*					IOXP_GENERAL_CFG_B_CORE_FREQ_100K		(0x01)	- 100 kHz            */
+/*					IOXP_GENERAL_CFG_B_CORE_FREQ_200K		(0x02)	- 200 kHz            */
+/*					IOXP_GENERAL_CFG_B_CORE_FREQ_500K		(0x03)	- 500 kHz            */
+/*                                                                                       */
+/*                                                                                       */
+/*	Errors:                                                                              */
+/*                                                                                       */
+/*	Description:                                                                         */
+/*		 This function returns the CORE_FREQ information of the GENERAL_CFG_B register.  */
+/* ------------------------------------------------------------------------------------- */
+
+uint8_t IOXP::GetCoreFreq()
+{
+	return GetField<IOXP_FIELD_CORE_FREQ>();
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/*	IOXP::SetKeyMapTable                                                                          */
+/*                                                                                                */
+/*	Synopsis:                                                                                     */
+/*		SetKeyMapTable(pvTable, bElemSize);                                                       */
+/*	Parameters:                                                                                   */  
+/*		const void *pvTable	- the table containing key mappings, IOXP_KB_ROWS x IOXP_KB_COLS      */
+/*							  signed values                                                       */
+/*		uint8_t bElemSize	- the size of the table elements: 1, 2 or 4 bytes                     */
+/*						                                                                          */
+/*  Return Value:                                                                                 */
+/*		uint8_t - the number of keys whose value (other than -1) is already used by a previous    */
+/*				  key of the table (row by row, column by column); 0 if all the values are unique */
+/*                                                                                                */
+/*	Errors:                                                                                       */
+/*                                                                                                */
+/*	Description:                                                                                  */
+/*		This function sets the value for keys using the values from specified table. It is called */
+/*		by the SetKeyMap template, which checks the element type at compile time.                 */
+/*		Mapping values on keys is optional, user may use keys just by specifying row and column.  */
+/*		The table is referenced, not copied. The function also builds the reverse index used by   */
+/*		GetKeyByVal and EncodeEvent. A value used by more keys is mapped to the first of them.    */
+/* ---------------------------------------------------------------------------------------------- */
+
+uint8_t IOXP::SetKeyMapTable(const void *pvTable, uint8_t bElemSize)
+{  
+	uint8_t bCntDup = 0;
+	pvKeyMap = pvTable;
+	bKeyMapElemSize = bElemSize;
+	memset(rgbKeyHash, 0xFF, sizeof(rgbKeyHash));
+	for(uint8_t bKeyIdx = 0; bKeyIdx < IOXP_KB_ROWS * IOXP_KB_COLS; bKeyIdx++)
+	{
+		int iKeyVal = GetKeyMapVal(bKeyIdx);
+		if(iKeyVal == -1)
+		{
+			continue;
+		}
+		uint8_t bSlot = KeyHash(iKeyVal);
+		while(rgbKeyHash[bSlot] != 0xFF && GetKeyMapVal(rgbKeyHash[bSlot]) != iKeyVal)
+		{
+			bSlot = (bSlot + 1) & (IOXP_KEY_HASH_SLOTS - 1);
+		}
+		if(rgbKeyHash[bSlot] != 0xFF)
+		{
+			// the value already belongs to a previous key
+			bCntDup++;
+		}
+		else
+		{
+			rgbKeyHash[bSlot] = bKeyIdx;
+		}
+	}
+	return bCntDup;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::EnableRegisterCache                                           */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		EnableRegisterCache(fEnable);                                   */
+/*	Parameters:                                                         */  
+/*		bool fEnable - true to enable the register cache, false to      */
+/*					   disable it                                       */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Enables or disables the write-through register cache. While it  */
+/*		is enabled, masked writes (SetRegisterBit, SetRegisterBitsGroup */
+/*		and the functions built on them) to cacheable registers take    */
+/*		the old value from the cache instead of reading the register,   */
+/*		and writes that do not change the register value are skipped.  */
+/*		The cache is invalidated when it is enabled, so it only holds   */
+/*		values that were transferred afterwards.                        */
+/*		The cache assumes that nothing but this object changes the      */
+/*		configuration registers. Call InvalidateRegisterCache after the */
+/*		device is reset.                                                */
+/* -------------------------------------------------------------------- */
+
+void IOXP::EnableRegisterCache(bool fEnable)
+{
+	if(fEnable && !fCacheEn)
+	{
+		InvalidateRegisterCache();
+	}
+	fCacheEn = fEnable;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::InvalidateRegisterCache                                       */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		InvalidateRegisterCache();                                      */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Marks all the cached register values as invalid, so the next    */
+/*		masked write to each register reads it from the device again.   */
+/* -------------------------------------------------------------------- */
+
+void IOXP::InvalidateRegisterCache()
+{
+	memset(rgbShadowValid, 0, sizeof(rgbShadowValid));
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetRegisterCacheStats                                         */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GetRegisterCacheStats(dwSavedReads, dwSavedWrites);             */
+/*	Parameters:                                                         */  
+/*		uint32_t &dwSavedReads  - output parameter where the number of  */
+/*								  register reads served from the cache  */
+/*								  will be stored                        */
+/*		uint32_t &dwSavedWrites - output parameter where the number of  */
+/*								  skipped register writes will be       */
+/*								  stored                                */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the number of I2C transactions saved by the register    */
+/*		cache since the object was created or the counters were reset.  */
+/* -------------------------------------------------------------------- */
+
+void IOXP::GetRegisterCacheStats(uint32_t &dwSavedReads, uint32_t &dwSavedWrites)
 {
-	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
-	WriteBytesI2C(IOXP_ADDR_RESET1_EVENT_B, 1, &bEvent);	
+	dwSavedReads = dwCacheSavedReads;
+	dwSavedWrites = dwCacheSavedWrites;
 }
 
-/* -------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetReset1EventB                                                                                                           */
-/*                                                                                                                                  */
-/*	Synopsis:                                                                                                                       */
-/*		GetReset1EventB(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);          */
-/*	Parameters:                                                                                                                     */  
-/*	 	int &iKeyVal	- key value - output parameter where the key value will be stored.                                          */
-/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.        */
-/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                   */
-/*						It contains 0xFF value if the event is not a keyboard event.                                                */
-/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                             */
-/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)        */
-/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                             */
-/*						It contains 0xFF value if the event is not a GPI event.                                                     */
-/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                         */
-/*						It contains 0xFF value if the event is not a Logic event.                                                   */
-/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                       */
-/*						For keys events:                                                                                            */
-/*								1 - key is pressed                                                                                  */
-/*								0 - key is released                                                                                 */
-/*						For GPI and Logic events:                                                                                   */
-/*								1 - GPI/logic is active                                                                             */
-/*								0 - GPI/logic is inactive                                                                           */
-/*  Return Value:                                                                                                                   */
-/*		void                                                                                                                        */
-/*                                                                                                                                  */
-/*	Errors:                                                                                                                         */
-/*                                                                                                                                  */
-/*	Description:                                                                                                                    */
-/*		This function reads the Reset1EventB event, decodes it and returns the specific information.                                */
-/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in output        */
-/*		parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.         */
-/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                   */
-/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                  */
-/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                  */
-/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.                             */ 
-/* -------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::ResetRegisterCacheStats                                       */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ResetRegisterCacheStats();                                      */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Clears the counters returned by GetRegisterCacheStats.          */
+/* -------------------------------------------------------------------- */
 
-void IOXP::GetReset1EventB(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+void IOXP::ResetRegisterCacheStats()
 {
-	uint8_t bEvent;
-	ReadBytesI2C(IOXP_ADDR_RESET1_EVENT_B, 1, &bEvent);
-	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	dwCacheSavedReads = 0;
+	dwCacheSavedWrites = 0;
 }
 
-/* -------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::SetReset1EventC                                                                                                     */
-/*                                                                                                                            */
-/*	Synopsis:                                                                                                                 */
-/*		SetReset1EventC(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);          */
-/*	Parameters:                                                                                                               */  
-/*	 	int iKeyVal	- key value                                                                                               */
-/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and       */
-/*						column information.                                                                                   */
-/*		uint8_t bRow	- key row value                                                                                       */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.      */
-/*						This parameter has a default value of 0xFF.                                                           */
-/*		uint8_t bCol	- key column value                                                                                    */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event       */
-/*						or if the event corresponds to (Rx, GND).                                                             */
-/*						This parameter has a default value of 0xFF.                                                           */
-/*		uint8_t bGPI	- GPI number.                                                                                         */
-/*						It contains 0xFF value if the event is not a GPI event.                                               */
-/*						This parameter has a default value of 0xFF.                                                           */
-/*		uint8_t bLogic	- Logic number.                                                                                       */
-/*						It contains 0xFF value if the event is not a Logic event.                                             */
-/*						This parameter has a default value of 0xFF.                                                           */
-/*		uint8_t bEventState - Event state                                                                                     */
-/*						For keys events:                                                                                      */
-/*								1 - key is pressed                                                                            */
-/*								0 - key is released                                                                           */
-/*						For GPI and Logic events:                                                                             */
-/*								1 - GPI/logic is active                                                                       */
-/*								0 - GPI/logic is inactive                                                                     */
-/*						This parameter has a default value of 1.                                                              */
-/*  Return Value:                                                                                                             */
-/*		 void                                                                                                                 */
-/*                                                                                                                            */
-/*	Errors:                                                                                                                   */
-/*                                                                                                                            */
-/*	Description:                                                                                                              */
-/*		This function sets the Reset1EventC event according to the specified information. It encodes information in the event */
-/*		byte using EncodeEvent function. When more keys have that same value associated, then only the first one of them will */
-/*		be identified with that value. If no key corresponds to the specified key value, no event will be created.            */
-/*      The last five parameters have default values.                                                                         */ 
-/* -------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::SubmitRead                                                    */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		SubmitRead(req, bAddress, bCntBytes, rgbBuf, pfnDone,           */
+/*				   pvContext);                                          */
+/*	Parameters:                                                         */  
+/*		IOXPRequest &req		- the request, not queued               */
+/*		uint8_t bAddress		- the first register                    */
+/*		uint8_t bCntBytes		- the number of registers, 1 or more    */
+/*		uint8_t *rgbBuf			- receives the values                   */
+/*		IOXPRequestHandler pfnDone	- called on completion, can be NULL */
+/*		void *pvContext			- stored in req for the handler         */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK if the request was queued, IOXP_ERR_PARAM */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		IOXP_ERR_PARAM if req is already queued, bCntBytes is 0 or the  */
+/*		range goes past the last register; req is not changed.          */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Queues the read and returns at once, the transfer is done by    */
+/*		PollRequests. See SubmitRequest.                                */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetReset1EventC(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+uint8_t IOXP::SubmitRead(IOXPRequest &req, uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbBuf,
+	IOXPRequestHandler pfnDone, void *pvContext)
 {
-	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
-	WriteBytesI2C(IOXP_ADDR_RESET1_EVENT_C, 1, &bEvent);	
+	return SubmitRequest(req, true, bAddress, bCntBytes, rgbBuf, pfnDone, pvContext);
 }
 
-/* -------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetReset1EventC                                                                                                           */
-/*                                                                                                                                  */
-/*	Synopsis:                                                                                                                       */
-/*		GetReset1EventC(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);          */
-/*	Parameters:                                                                                                                     */  
-/*	 	int &iKeyVal	- key value - output parameter where the key value will be stored.                                          */
-/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.        */
-/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                   */
-/*						It contains 0xFF value if the event is not a keyboard event.                                                */
-/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                             */
-/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)        */
-/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                             */
-/*						It contains 0xFF value if the event is not a GPI event.                                                     */
-/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                         */
-/*						It contains 0xFF value if the event is not a Logic event.                                                   */
-/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                       */
-/*						For keys events:                                                                                            */
-/*								1 - key is pressed                                                                                  */
-/*								0 - key is released                                                                                 */
-/*						For GPI and Logic events:                                                                                   */
-/*								1 - GPI/logic is active                                                                             */
-/*								0 - GPI/logic is inactive                                                                           */
-/*  Return Value:                                                                                                                   */
-/*		 void                                                                                                                       */
-/*                                                                                                                                  */
-/*	Errors:                                                                                                                         */
-/*                                                                                                                                  */
-/*	Description:                                                                                                                    */
-/*		This function reads the Reset1EventC event, decodes it and returns the specific information.                                */
-/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in output        */
-/*		parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.         */
-/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                   */
-/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                  */
-/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                  */
-/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.                             */ 
-/* -------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::SubmitWrite                                                   */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		SubmitWrite(req, bAddress, bCntBytes, rgbBuf, pfnDone,          */
+/*					pvContext);                                         */
+/*	Parameters:                                                         */  
+/*		IOXPRequest &req		- the request, not queued               */
+/*		uint8_t bAddress		- the first register                    */
+/*		uint8_t bCntBytes		- the number of registers, 1 or more    */
+/*		uint8_t *rgbBuf			- the values, not copied                */
+/*		IOXPRequestHandler pfnDone	- called on completion, can be NULL */
+/*		void *pvContext			- stored in req for the handler         */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK if the request was queued, IOXP_ERR_PARAM */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		Same as SubmitRead.                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Queues the write and returns at once, the transfer is done by   */
+/*		PollRequests. The values are read from rgbBuf when they are     */
+/*		sent, so the buffer must not be changed before completion.      */
+/* -------------------------------------------------------------------- */
 
-void IOXP::GetReset1EventC(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+uint8_t IOXP::SubmitWrite(IOXPRequest &req, uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbBuf,
+	IOXPRequestHandler pfnDone, void *pvContext)
 {
-	uint8_t bEvent;
-	ReadBytesI2C(IOXP_ADDR_RESET1_EVENT_C, 1, &bEvent);
-	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	return SubmitRequest(req, false, bAddress, bCntBytes, rgbBuf, pfnDone, pvContext);
 }
 
-/* ------------------------------------------------------------------------------------------------------------------------------ */
-/*	IOXP::SetReset2EventA                                                                                                         */
-/*                                                                                                                                */
-/*	Synopsis:                                                                                                                     */
-/*		SetReset2EventA(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);	          */
-/*	Parameters:                                                                                                                   */  
-/*		int iKeyVal	- key value                                                                                                   */
-/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and column    */
-/*						information.                                                                                              */
-/*		uint8_t bRow	- key row value                                                                                           */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.          */
-/*						This parameter has a default value of 0xFF.                                                               */
-/*		uint8_t bCol	- key column value                                                                                        */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event or if     */
-/*						the event corresponds to (Rx, GND).                                                                       */
-/*						This parameter has a default value of 0xFF.                                                               */
-/*		uint8_t bGPI	- GPI number.                                                                                             */
-/*						It contains 0xFF value if the event is not a GPI event.                                                   */
-/*						This parameter has a default value of 0xFF.                                                               */
-/*		uint8_t bLogic	- Logic number.                                                                                           */
-/*						It contains 0xFF value if the event is not a Logic event.                                                 */
-/*						This parameter has a default value of 0xFF.                                                               */
-/*		uint8_t bEventState - Event state                                                                                         */
-/*						For keys events:                                                                                          */
-/*								1 - key is pressed                                                                                */
-/*								0 - key is released                                                                               */
-/*						For GPI and Logic events:                                                                                 */
-/*								1 - GPI/logic is active                                                                           */
-/*								0 - GPI/logic is inactive                                                                         */
-/*						This parameter has a default value of 1.                                                                  */
-/*  Return Value:                                                                                                                 */
-/*		void                                                                                                                      */
-/*                                                                                                                                */
-/*	Errors:                                                                                                                       */
-/*                                                                                                                                */
-/*	Description:                                                                                                                  */
-/*		This function sets the Reset2EventA event according to the specified information. It encodes information in the event     */
-/*		byte using EncodeEvent function. When more keys have that same value associated, then only the first one of them will     */
-/*		be identified with that value. If no key corresponds to the specified key value, no event will be created.                */
-/*      The last five parameters have default values.                                                                             */ 
-/* ------------------------------------------------------------------------------------------------------------------------------ */
+/* -------------------------------------------------------------------- */
+/*	IOXP::SubmitRequest                                                 */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		SubmitRequest(req, fRead, bAddress, bCntBytes, rgbBuf, pfnDone, */
+/*					  pvContext);                                       */
+/*	Parameters:                                                         */  
+/*		bool fRead				- true for a read                       */
+/*		the others as for SubmitRead                                    */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK if the request was queued, IOXP_ERR_PARAM */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Fills req and links it at the end of the queue: the requests    */
+/*		are run in submission order. There is no allocation, the queue  */
+/*		is made of the requests themselves, so its size is bounded by   */
+/*		the number of IOXPRequest objects of the sketch.                */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetReset2EventA(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+uint8_t IOXP::SubmitRequest(IOXPRequest &req, bool fRead, uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbBuf,
+	IOXPRequestHandler pfnDone, void *pvContext)
 {
-	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
-	WriteBytesI2C(IOXP_ADDR_RESET2_EVENT_A, 1, &bEvent);	
+	if(req.bState == IOXP_REQ_QUEUED || bCntBytes == 0 || (uint16_t)bAddress + bCntBytes > IOXP_NO_REGS)
+	{
+		return IOXP_ERR_PARAM;
+	}
+	req.bAddress = bAddress;
+	req.bCntBytes = bCntBytes;
+	req.rgbBuf = rgbBuf;
+	req.pfnDone = pfnDone;
+	req.pvContext = pvContext;
+	req.bStatus = IOXP_I2C_OK;
+	req.bCntDone = 0;
+	req.fRead = fRead;
+	req.pNext = NULL;
+	req.bState = IOXP_REQ_QUEUED;
+	if(pReqHead == NULL)
+	{
+		pReqHead = &req;
+	}
+	else
+	{
+		pReqTail->pNext = &req;
+	}
+	pReqTail = &req;
+	return IOXP_I2C_OK;
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXP::PollRequests                                                  */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		PollRequests();                                                 */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - the number of requests still queued                   */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		A failed transfer completes its request with the I2C error in   */
+/*		bStatus; the next requests are run normally.                    */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Advances the first queued request by one I2C transaction of at  */
+/*		most SetRequestChunk bytes (IOXP_REQ_CHUNK by default). When    */
+/*		the request is complete its state becomes IOXP_REQ_DONE and its */
+/*		handler is called, so the handler can submit it again.          */
+/*		Wire transfers block until the STOP, so a call takes the time   */
+/*		of one short transaction: about 0.7 ms at 100 kHz and 0.2 ms at */
+/*		400 kHz with the default chunk, instead of the whole transfer.  */
+/*		Call it from loop() (or a timer) between the control work. The  */
+/*		steps use ReadBytesI2C and WriteBytesI2C: the register shadow,  */
+/*		the batch and the bus statistics see them like the other calls, */
+/*		and synchronous calls can be made between two steps.            */
+/* -------------------------------------------------------------------- */
+
+uint8_t IOXP::PollRequests()
+{
+	IOXPRequest *pReq = pReqHead;
+	if(pReq == NULL)
+	{
+		return 0;
+	}
+	uint8_t bCntChunk = pReq->bCntBytes - pReq->bCntDone;
+	if(bCntChunk > bReqChunk)
+	{
+		bCntChunk = bReqChunk;
+	}
+	uint8_t bAddress = pReq->bAddress + pReq->bCntDone;
+	uint8_t *rgbChunk = pReq->rgbBuf + pReq->bCntDone;
+	uint8_t bStatus = pReq->fRead ? ReadBytesI2C(bAddress, bCntChunk, rgbChunk) : WriteBytesI2C(bAddress, bCntChunk, rgbChunk);
+	if(bStatus == IOXP_I2C_OK)
+	{
+		pReq->bCntDone += bCntChunk;
+	}
+	if(bStatus != IOXP_I2C_OK || pReq->bCntDone == pReq->bCntBytes)
+	{
+		// unlinked first, the handler can submit it again
+		pReqHead = pReq->pNext;
+		if(pReqHead == NULL)
+		{
+			pReqTail = NULL;
+		}
+		pReq->bStatus = bStatus;
+		pReq->bState = IOXP_REQ_DONE;
+		if(pReq->pfnDone != NULL)
+		{
+			pReq->pfnDone(*pReq);
+		}
+	}
+	uint8_t bCntQueued = 0;
+	for(pReq = pReqHead; pReq != NULL; pReq = pReq->pNext)
+	{
+		bCntQueued++;
+	}
+	return bCntQueued;
 }
 
-/* ------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetReset2EventA                                                                                                          */
-/*                                                                                                                                 */
-/*	Synopsis:                                                                                                                      */
-/*		GetReset2EventA(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);         */
-/*	Parameters:                                                                                                                    */  
-/*	 	int &iKeyVal	- key value - output parameter where the key value will be stored.                                         */
-/*						It contains -1 value if the event is not a keyboard event or if the key map table contains -1 value.       */
-/*		uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                  */
-/*						It contains 0xFF value if the event is not a keyboard event.                                               */
-/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                            */
-/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)       */
-/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                            */
-/*						It contains 0xFF value if the event is not a GPI event.                                                    */
-/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                        */ 
-/*						It contains 0xFF value if the event is not a Logic event.                                                  */
-/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                      */
-/*						For keys events:                                                                                           */
-/*								1 - key is pressed                                                                                 */
-/*								0 - key is released                                                                                */
-/*						For GPI and Logic events:                                                                                  */
-/*								1 - GPI/logic is active                                                                            */
-/*								0 - GPI/logic is inactive                                                                          */
-/*  Return Value:                                                                                                                  */
-/*		void                                                                                                                       */
-/*                                                                                                                                 */
-/*	Errors:                                                                                                                        */
-/*                                                                                                                                 */
-/*	Description:                                                                                                                   */
-/*		This function reads the Reset2EventA event, decodes it and returns the specific information.                               */ 
-/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in output       */
-/*		parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.        */
-/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                  */
-/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                 */
-/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                 */
-/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.                            */ 
-/* ------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::SetRequestChunk                                               */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		SetRequestChunk(bCntBytes);                                     */
+/*	Parameters:                                                         */  
+/*		uint8_t bCntBytes	- register bytes per PollRequests call, 1   */
+/*							  or more                                   */
+/*                                                                      */	                                                     
+/*	Description:                                                        */
+/*		Trades the time of one PollRequests call against the number of  */
+/*		calls (each step repeats the START, device and register address */
+/*		bytes). 0 selects IOXP_REQ_CHUNK.                               */
+/* -------------------------------------------------------------------- */
 
-void IOXP::GetReset2EventA(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+void IOXP::SetRequestChunk(uint8_t bCntBytes)
 {
-	uint8_t bEvent;
-	ReadBytesI2C(IOXP_ADDR_RESET2_EVENT_A, 1, &bEvent);
-	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	bReqChunk = (bCntBytes != 0) ? bCntBytes : IOXP_REQ_CHUNK;
 }
 
-/* --------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::SetReset2EventB                                                                                                      */
-/*                                                                                                                             */
-/*	Synopsis:                                                                                                                  */
-/*		SetReset2EventB(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState);           */
-/*	Parameters:                                                                                                                */  
-/*	 	int iKeyVal	- key value                                                                                                */
-/*						It contains -1 value if the event is not a keyboard event or if the key is specified by row and column */
-/*						information.                                                                                           */
-/*		uint8_t bRow	- key row value                                                                                        */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event.       */
-/*						This parameter has a default value of 0xFF.                                                            */
-/*		uint8_t bCol	- key column value                                                                                     */
-/*						It contains 0xFF value if the iKeyVal specifies the key or if the event is not a keyboard event or     */
-/*						if the event corresponds to (Rx, GND).                                                                 */
-/*						This parameter has a default value of 0xFF.                                                            */
-/*		uint8_t bGPI	- GPI number.                                                                                          */
-/*						It contains 0xFF value if the event is not a GPI event.                                                */
-/*						This parameter has a default value of 0xFF.                                                            */
-/*		uint8_t bLogic	- Logic number.                                                                                        */
-/*						It contains 0xFF value if the event is not a Logic event.                                              */
-/*						This parameter has a default value of 0xFF.                                                            */
-/*		uint8_t bEventState - Event state                                                                                      */
-/*						For keys events:                                                                                       */
-/*								1 - key is pressed                                                                             */
-/*								0 - key is released                                                                            */
-/*						For GPI and Logic events:                                                                              */
-/*								1 - GPI/logic is active                                                                        */
-/*								0 - GPI/logic is inactive                                                                      */
-/*						This parameter has a default value of 1.                                                               */
-/*  Return Value:                                                                                                              */
-/*		void                                                                                                                   */
-/*                                                                                                                             */
-/*	Errors:                                                                                                                    */
-/*                                                                                                                             */
-/*	Description:                                                                                                               */
-/*		This function sets the Reset2EventB event according to the specified information. It encodes information in the event  */
-/*		byte using EncodeEvent function. When more keys have that same value associated, then only the first one of them will  */
-/*		be identified with that value. If no key corresponds to the specified key value, no event will be created.             */
-/*      The last five parameters have default values.                                                                          */ 
-/* --------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetLastI2CStatus                                              */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GetLastI2CStatus();                                             */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - the status of the last I2C transfer:                  */
+/*			IOXP_I2C_OK				(0)	- success                       */
+/*			IOXP_I2C_ERR_LENGTH		(1)	- data too long for Wire buffer */
+/*			IOXP_I2C_ERR_NACK_ADDR	(2)	- device address not acked      */
+/*			IOXP_I2C_ERR_NACK_DATA	(3)	- data byte not acked           */
+/*			IOXP_I2C_ERR_BUS		(4)	- other bus error               */
+/*			IOXP_I2C_ERR_SHORT_READ	(5)	- fewer bytes than requested    */
+/*			IOXP_I2C_ERR_TIMEOUT	(6)	- transfer did not complete     */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the status of the last register transfer performed by   */
+/*		any of the functions of the library, so that callers of the     */
+/*		functions that do not return a status can check the result.     */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetReset2EventB(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+uint8_t IOXP::GetLastI2CStatus()
 {
-	uint8_t bEvent = EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
-	WriteBytesI2C(IOXP_ADDR_RESET2_EVENT_B, 1, &bEvent);	
+	return bLastI2CStatus;
 }
 
-/* -------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetReset2EventB                                                                                                           */
-/*                                                                                                                                  */
-/*	Synopsis:                                                                                                                       */
-/*		GetReset2EventB(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);          */
-/*	Parameters:                                                                                                                     */  
-/*	 	uint8_t &bRow	- key row - output parameter where the keyboard row value will be stored.                                   */
-/*						It contains 0xFF value if the event is not a keyboard event.                                                */
-/*		uint8_t &bCol	- key column - output parameter where the keyboard column value will be stored.                             */
-/*						It contains 0xFF value if the event is not a keyboard event or if the event corresponds to (Rx, GND)        */
-/*		uint8_t &bGPI	- GPI no - output parameter where the GPI value will be stored.                                             */
-/*						It contains 0xFF value if the event is not a GPI event.                                                     */
-/*		uint8_t &bLogic	- Logic no - output parameter where the Logic value will be stored.                                         */
-/*						It contains 0xFF value if the event is not a Logic event.                                                   */
-/*		uint8_t &bEventState	- Event state - output parameter where the state of the event will be placed.                       */
-/*						For keys events:                                                                                            */
-/*								1 - key is pressed                                                                                  */
-/*								0 - key is released                                                                                 */
-/*						For GPI and Logic events:                                                                                   */
-/*								1 - GPI/logic is active                                                                             */
-/*								0 - GPI/logic is inactive                                                                           */
-/*  Return Value:                                                                                                                   */
-/*		void                                                                                                                        */
-/*                                                                                                                                  */
-/*	Errors:                                                                                                                         */
-/*                                                                                                                                  */
-/*	Description:                                                                                                                    */
-/*		This function reads the Reset2EventB event, decodes it and returns the specific information.                                */
-/*      If the event is a key event, key value, row and column the information corresponding to the key are stored in output        */
-/*		parameters while the other parameters corresponding to GPI events (bGPI) and Logic events (bLogic) are set to 0xFF.         */
-/*      If the event is a GPI event, the GPI number is stored in bGPI while the other parameters corresponding to                   */
-/*		key events (keyVal, bRow, bCol) and to Logic events (bLogic) are set to -1 (keyVal) and 0xFF respectively.                  */
-/*      If the event is a Logic event, the Logic number is stored in bLogic, while the parameters corresponding to                  */
-/*		key events (keyVal, bRow, bCol) and to Key events are set to -1 (keyVal) and 0xFF respectively.                             */
-/* -------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::SetRetryPolicy                                                */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		SetRetryPolicy(bRetries, wBackoffUS, dwTimeoutUS);              */
+/*	Parameters:                                                         */  
+/*		uint8_t bRetries	- retries of a failed transfer, 0 to return */
+/*							  the first error (default)                 */
+/*		uint16_t wBackoffUS	- wait before the first retry, doubled at   */
+/*							  each one (IOXP_RETRY_BACKOFF_US)          */
+/*		uint32_t dwTimeoutUS - time budget of a transfer: no retry      */
+/*							  starts after it (IOXP_CALL_TIMEOUT_US)    */
+/*                                                                      */	                                                     
+/*	Description:                                                        */
+/*		Applies to every register transfer of the object. The budget is */
+/*		per transfer (one ReadBytesI2C or WriteBytesI2C, one            */
+/*		PollRequests step): with errors, a transfer lasts at most       */
+/*		dwTimeoutUS plus one I2C cycle of at most IOXP_WIRE_BUFFER_LEN  */
+/*		bytes (3.5 ms at 100 kHz), plus a bus recovery if               */
+/*		SetBusRecoveryPins is used. A library call is bounded by that   */
+/*		times its number of transfers:                                  */
+/*		- register access functions: 1, 2 for a masked write of a       */
+/*		  register not in the cache.                                    */
+/*		- begin: 4 (ID and status read, INT_STATUS write, configuration */
+/*		  image write, GPI state read).                                 */
+/*		- Service / ServiceDevice, per device: 5 (status and FIFO read, */
+/*		  second FIFO read, INT_STATUS write, and on overflow the GPI   */
+/*		  state read and the OVERFLOW_INT write). DrainFIFO: 3.         */
+/*		- CommitBatch: one read per burst of partly written registers   */
+/*		  not cached, then one write per burst.                         */
+/*		- ApplyConfig: one write per burst of changed registers, at     */
+/*		  most 14 (IOXP_CFG_IMAGE_SIZE / (IOXP_BATCH_MAX_GAP + 2)).     */
+/* -------------------------------------------------------------------- */
 
-void IOXP::GetReset2EventB(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+void IOXP::SetRetryPolicy(uint8_t bRetries, uint16_t wBackoffUS, uint32_t dwTimeoutUS)
 {
-	uint8_t bEvent;
-	ReadBytesI2C(IOXP_ADDR_RESET2_EVENT_B, 1, &bEvent);
-	DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	this->bRetries = bRetries;
+	this->wBackoffUS = wBackoffUS;
+	this->dwTimeoutUS = dwTimeoutUS;
 }
 
-/* ---------------------------------------------------------------------------------------- */
-/*	 IOXP::SetIntMaskTimer                                                                  */
-/*                                                                                          */
-/*	Synopsis:                                                                               */
-/*		SetIntMaskTimer(uint8_t bIntMaskTimer);                                             */
-/*	Parameters:                                                                             */  
-/*	 	uint8_t bIntMaskTimer - the information to be set for INT_MASK_TIMER bits.          */
-/*					It can be one of the following time values:                             */
-/*		            IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_DIS		(0)		- disabled          */
-/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_1SEC	(1)		-  1 sec            */
-/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_2SEC	(2)		-  2 sec            */
-/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_30SEC	(0X1E)	- 30 sec            */
-/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_31SEC	(0X1F)	- 31 sec            */
-/*  Return Value:                                                                           */
-/*		void                                                                                */
-/*                                                                                          */
-/*	Errors:                                                                                 */
-/*                                                                                          */
-/*	Description:                                                                            */
-/*		This function sets the INT_MASK_TIMER information of the UNLOCK_TIMERS register.    */ 
-/* ---------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::SetBusRecoveryPins                                            */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		SetBusRecoveryPins(bSclPin, bSdaPin);                           */
+/*	Parameters:                                                         */  
+/*		uint8_t bSclPin	- the pin number of the SCL line of the bus     */
+/*		uint8_t bSdaPin	- the pin number of the SDA line, IOXP_NO_PIN   */
+/*						  to disable the recovery                       */
+/*                                                                      */	                                                     
+/*	Description:                                                        */
+/*		Enables the SDA check before each transfer and RecoverBus. The  */
+/*		pins are the ones of the I2C module used by the Wire object     */
+/*		(e.g. the SCL / SDA pins of the chipKIT board).                 */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetIntMaskTimer(uint8_t bIntMaskTimer)
+void IOXP::SetBusRecoveryPins(uint8_t bSclPin, uint8_t bSdaPin)
 {
-	SetRegisterBitsGroup(IOXP_UNLOCK_TIMERS_INT_MASK_TIMER, bIntMaskTimer);	
+	this->bSclPin = (bSdaPin != IOXP_NO_PIN) ? bSclPin : IOXP_NO_PIN;
+	this->bSdaPin = (bSclPin != IOXP_NO_PIN) ? bSdaPin : IOXP_NO_PIN;
 }
 
-/* ----------------------------------------------------------------------------------------- */
-/*	IOXP::GetIntMaskTimer                                                                    */
-/*                                                                                           */
-/*	Synopsis:                                                                                */
-/*		GetIntMaskTimer();                                                                   */
-/*	Parameters:                                                                              */  
-/*	 	uint8_t -  the information read from INT_MASK_TIMER bits.                            */
-/*					It can be one of the following:                                          */
-/*					IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_DIS		(0)		- disabled           */
-/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_1SEC	(1)		-  1 sec             */
-/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_2SEC	(2)		-  2 sec             */
-/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_30SEC	(0X1E)	- 30 sec             */
-/*                  IOXP_UNLOCK_TIMERS_INT_MASTER_TIMER_31SEC	(0X1F)	- 31 sec             */
-/*  Return Value:                                                                            */
-/*		 uint8_t  - the INT_MASK_TIMER information of the UNLOCK_TIMERS register             */
-/*                                                                                           */
-/*	Errors:                                                                                  */
-/*                                                                                           */
-/*	Description:                                                                             */
-/*		This function returns the INT_MASK_TIMER information of the UNLOCK_TIMERS register.  */ 
-/* ----------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::RecoverBus                                                    */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		RecoverBus();                                                   */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK if SDA is released, IOXP_I2C_ERR_BUS if   */
+/*				  it stays low or no pins were given                    */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Standard I2C bus clear: a slave interrupted in the middle of a  */
+/*		read (MCU reset, glitch) holds SDA low until it has clocked out */
+/*		its byte. SCL is pulsed up to 9 times at about 100 kHz until    */
+/*		SDA is high, then a STOP is generated and Wire.begin gives the  */
+/*		pins back to the I2C module. The lines are driven open-drain:   */
+/*		pulled low as outputs, released as inputs. Takes about 100 us.  */
+/* -------------------------------------------------------------------- */
 
-uint8_t IOXP::GetIntMaskTimer()
+uint8_t IOXP::RecoverBus()
 {
-	return GetRegisterBitsGroup(IOXP_UNLOCK_TIMERS_INT_MASK_TIMER);
+	if(bSdaPin == IOXP_NO_PIN)
+	{
+		return IOXP_I2C_ERR_BUS;
+	}
+	busErrors.dwRecoveries++;
+	pinMode(bSdaPin, INPUT);
+	pinMode(bSclPin, INPUT);
+	for(uint8_t bIdx = 0; bIdx < 9 && digitalRead(bSdaPin) == LOW; bIdx++)
+	{
+		digitalWrite(bSclPin, LOW);
+		pinMode(bSclPin, OUTPUT);
+		delayMicroseconds(5);
+		pinMode(bSclPin, INPUT);
+		delayMicroseconds(5);
+	}
+	// STOP: SDA rises while SCL is high
+	digitalWrite(bSclPin, LOW);
+	pinMode(bSclPin, OUTPUT);
+	digitalWrite(bSdaPin, LOW);
+	pinMode(bSdaPin, OUTPUT);
+	delayMicroseconds(5);
+	pinMode(bSclPin, INPUT);
+	delayMicroseconds(5);
+	pinMode(bSdaPin, INPUT);
+	delayMicroseconds(5);
+	uint8_t bStatus = (digitalRead(bSdaPin) == LOW) ? IOXP_I2C_ERR_BUS : IOXP_I2C_OK;
+	pWire->begin();
+	return bStatus;
 }
 
-/* ----------------------------------------------------------------------------------- */
-/*	IOXP::SetUnlockTimer                                                               */
-/*                                                                                     */
-/*	Synopsis:                                                                          */
-/*		SetUnlockTimer(uint8_t bUnlockTimer);                                          */
-/*	Parameters:                                                                        */  
-/*	 	uint8_t bUnlockTimer	- the information to be set for UNLOCK_TIMER bits      */
-/*					It can be one of the following time values:                        */
-/*                        IOXP_UNLOCK_TIMER_DIS		- disabled                         */
-/*                        IOXP_UNLOCK_TIMER_1SEC	- 1 sec                            */
-/*                        IOXP_UNLOCK_TIMER_2SEC	- 2 sec                            */
-/*                        IOXP_UNLOCK_TIMER_3SEC	- 3 sec                            */
-/*                        IOXP_UNLOCK_TIMER_4SEC	- 4 sec                            */
-/*                        IOXP_UNLOCK_TIMER_5SEC	- 5 sec	                           */
-/*                        IOXP_UNLOCK_TIMER_6SEC	- 6 sec	                           */
-/*                        IOXP_UNLOCK_TIMER_7SEC	- 7 sec	                           */
-/*	Return Value:                                                                      */
-/*		void                                                                           */
-/*                                                                                     */
-/*	Errors:                                                                            */
-/*                                                                                     */
-/*	Description:                                                                       */
-/*		This function sets the UNLOCK_TIMER information of the UNLOCK_TIMERS register. */ 
-/* ----------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetBusErrors                                                  */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the error counters since the last ResetBusErrors.       */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetUnlockTimer(uint8_t bUnlockTimer)
+const IOXPBusErrors &IOXP::GetBusErrors()
 {
-	SetRegisterBitsGroup(IOXP_UNLOCK_TIMERS_UNLOCK_TIMER, bUnlockTimer);	
+	return busErrors;
 }
 
-/* -------------------------------------------------------------------------------------- */
-/*	IOXP::GetUnlockTimer                                                                  */
-/*                                                                                        */
-/*	Synopsis:                                                                             */
-/*		GetUnlockTimer();                                                                 */
-/*	Parameters:                                                                           */  
-/*	                                                                                      */
-/*  Return Value:                                                                         */
-/*		 uint8_t -  the information read from UNLOCK_TIMER bits                           */
-/*					It can be one of the following time values:                           */
-/*                        IOXP_UNLOCK_TIMER_DIS		- disabled                            */
-/*                        IOXP_UNLOCK_TIMER_1SEC	- 1 sec                               */
-/*                        IOXP_UNLOCK_TIMER_2SEC	- 2 sec                               */
-/*                        IOXP_UNLOCK_TIMER_3SEC	- 3 sec                               */
-/*                        IOXP_UNLOCK_TIMER_4SEC	- 4 sec                               */
-/*                        IOXP_UNLOCK_TIMER_5SEC	- 5 sec	                              */
-/*                        IOXP_UNLOCK_TIMER_6SEC	- 6 sec	                              */
-/*                        IOXP_UNLOCK_TIMER_7SEC	- 7 sec	                              */
-/*                                                                                        */
-/*	Errors:                                                                               */
-/*                                                                                        */
-/*	Description:                                                                          */
-/*		This function returns the UNLOCK_TIMER information of the UNLOCK_TIMERS register. */ 
-/* -------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::ResetBusErrors                                                */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Clears the error counters.                                      */
+/* -------------------------------------------------------------------- */
 
-uint8_t IOXP::GetUnlockTimer()
+void IOXP::ResetBusErrors()
 {
-	return GetRegisterBitsGroup(IOXP_UNLOCK_TIMERS_UNLOCK_TIMER);
+	memset(&busErrors, 0, sizeof(busErrors));
 }
 
-/* ---------------------------------------------------------------------------------------- */
-/*	IOXP::SetRPullConfig                                                                    */
-/*                                                                                          */
-/*	Synopsis:                                                                               */
-/*		SetRPullConfig(uint8_t *rgbVals);                                                   */
-/*	Parameters:                                                                             */  
-/*	 	uint8_t *rgbVals - 	the array containing five bytes corresponding to RPULL_CONFIG   */
-/*							registers. Each byte contains PULL UP / DOWN options for four   */
-/*							rows or columns, according to ADP5589 documentation.            */
-/*  Return Value:                                                                           */
-/*		void                                                                                */
-/*                                                                                          */
-/*	Errors:                                                                                 */
-/*                                                                                          */
-/*	Description:                                                                            */
-/*		This function sets the value for all five RPULL_CONFIG registers by providing an    */
-/*		array containing five bytes. Each byte contains PULL UP / DOWN options for four     */
-/*		rows or columns, according to ADP5589 documentation.                                */
-/*		The possible options for each row or column are:                                    */
-/*			IOXP_RPULL_CONFIG_300KPU		0	// enable 300 kΩ pull-up                    */
-/*			IOXP_RPULL_CONFIG_300KPD		1	// enable 300 kΩ pull-down                  */
-/*          IOXP_RPULL_CONFIG_100KPD		2	// enable 100 kΩ pull-up.                   */
-/*          IOXP_RPULL_CONFIG_300KPD		3	// disable all pull-up/pull-down resistors  */
-/*		Note that this information can be accessed for each row or column:                  */
-/*			- for rows using SetRegisterBitsGroup(IOXP_RPULL_CONFIG_R_PULL_CFG(bRowNo))     */
-/*				(bRowNo between 0 and 7).                                                   */
-/*			- for columns using SetRegisterBitsGroup(IOXP_RPULL_CONFIG_C_PULL_CFG(bColNo))  */
-/*				(bColNo between 0 and 10).                                                  */ 
-/* ---------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetBusCost                                                    */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GetBusCost(dwBytes, dwConditions);                              */
+/*	Parameters:                                                         */  
+/*		uint32_t &dwBytes		- output parameter where the number of  */
+/*								  bytes clocked on the bus (including   */
+/*								  device and register address bytes)    */
+/*								  will be stored                        */
+/*		uint32_t &dwConditions	- output parameter where the number of  */
+/*								  START, repeated START and STOP        */
+/*								  conditions will be stored             */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the I2C traffic generated by this object since it was   */
+/*		created or since the last call of ResetBusCost. Call            */
+/*		ResetBusCost before and GetBusCost after a library function to  */
+/*		measure the bus cost of that function.                          */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetRPullConfig(uint8_t *rgbVals)
+void IOXP::GetBusCost(uint32_t &dwBytes, uint32_t &dwConditions)
 {
-	WriteBytesI2C(IOXP_ADDR_RPULL_CONFIG_A, 5, rgbVals);
+	dwBytes = dwBusBytes;
+	dwConditions = dwBusConditions;
 }
 
-/* --------------------------------------------------------------------------------------- */
-/*	IOXP::GetRPullConfig                                                                   */
-/*                                                                                         */
-/*	Synopsis:                                                                              */
-/*		GetRPullConfig(uint8_t *rgbVals);                                                  */
-/*	Parameters:                                                                            */  
-/*	 	uint8_t *rgbVals  - the array containing five bytes corresponding to               */ 
-/*							RPULL_CONFIG registers.                                        */
-/*							Each byte contains PULL UP / DOWN options for four rows        */
-/*							or columns, according to ADP5589 documentation.                */
-/*  Return Value:                                                                          */
-/*		void                                                                               */
-/*                                                                                         */
-/*	Errors:                                                                                */
-/*                                                                                         */
-/*	Description:                                                                           */
-/*		This function retrieves the PULL UP / DOWN option for all rows and columns into an */
-/*		array containing five bytes. Each byte contains PULL UP / DOWN options for four    */
-/*		rows or columns, according to ADP5589 documentation. The possible options for each */
-/*		row or column are:                                                                 */
-/*			IOXP_RPULL_CONFIG_300KPU		0	// enable 300 kO pull-up                   */
-/*			IOXP_RPULL_CONFIG_300KPD		1	// enable 300 kO pull-down                 */
-/*          IOXP_RPULL_CONFIG_100KPD		2	// enable 100 kO pull-up.                  */
-/*          IOXP_RPULL_CONFIG_300KPD		3	// disable all pull-up/pull-down resistors */
-/*		Note that this information can be accessed for each row or column:                 */
-/*			- for rows using GetRegisterBitsGroup(IOXP_RPULL_CONFIG_R_PULL_CFG(bRowNo))    */
-/*				(bRowNo between 0 and 7).                                                  */
-/*			- for columns using GetRegisterBitsGroup(IOXP_RPULL_CONFIG_C_PULL_CFG(bColNo)) */
-/*				(bColNo between 0 and 10).                                                 */       
-/* --------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetBusTimeUS                                                  */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		GetBusTimeUS(dwSclHz);                                          */
+/*	Parameters:                                                         */  
+/*		uint32_t dwSclHz - the SCL frequency in Hz, for example         */
+/*			IOXP_I2C_CLK_100K	(100000)	- standard mode             */
+/*			IOXP_I2C_CLK_400K	(400000)	- fast mode                 */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint32_t - the wire time in microseconds                        */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the time the traffic counted by GetBusCost occupies the  */
+/*		bus at the specified SCL frequency. Each byte takes 9 clocks    */
+/*		(8 data bits and the acknowledge) and each START, repeated      */
+/*		START or STOP condition is counted as one clock. Clock          */
+/*		stretching and the time spent between transfers are not        */
+/*		included.                                                       */
+/* -------------------------------------------------------------------- */
 
-void IOXP::GetRPullConfig(uint8_t *rgbVals)
+uint32_t IOXP::GetBusTimeUS(uint32_t dwSclHz)
 {
-	ReadBytesI2C(IOXP_ADDR_RPULL_CONFIG_A, 5, rgbVals);
+	uint64_t qwClocks = (uint64_t)dwBusBytes * 9 + dwBusConditions;
+	return (uint32_t)((qwClocks * 1000000 + dwSclHz / 2) / dwSclHz);
 }
 
-/* ----------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetGPIIntStat                                                                                                                */
-/*                                                                                                                                     */
-/*	Synopsis:                                                                                                                          */
-/*		GetGPIIntStat();                                                                                                               */
-/*	Parameters:                                                                                                                        */  
-/*      void                                                                                                                           */
-/*                                                                                                                                     */
-/*  Return Value:                                                                                                                      */
-/*	 	uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPI_INT bits, for each GPI pin. These bits are          */
-/*					grouped in the three GPI_INT_STAT 8-bit registers corresponding to each of the 19 GPIs.                            */
-/*	Errors:                                                                                                                            */
-/*                                                                                                                                     */
-/*	Description:                                                                                                                       */
-/*		This function returns a value containing in its 19 LSbs the value of the GPI_INT bits, for each GPI pin. These bits are        */
-/*		grouped in the three GPI_INT_STAT 8-bit registers corresponding to each of the 19 GPIs.	This is the function used to read      */
-/*		which of the GPI pin triggered an interrupt. Note that each GPI_INT bit can be accessed using the function                     */
-/*		GetRegisterBit(IOXP_GPI_INT_STAT_GPI_INT(bGPIONo)), where bGPIONo is in the 1 - 19 range.                                      */
-/* ----------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::ResetBusCost                                                  */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ResetBusCost();                                                 */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Clears the counters returned by GetBusCost.                     */
+/* -------------------------------------------------------------------- */
 
-uint32_t IOXP::GetGPIIntStat()
+void IOXP::ResetBusCost()
 {
-	uint32_t bResult = 0;
-	ReadBytesI2C(IOXP_ADDR_GPI_INT_STATUS_A, 3, (uint8_t *)&bResult);
-	return bResult;
+	dwBusBytes = 0;
+	dwBusConditions = 0;
 }
 
-/* ---------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetGPIStat                                                                                                                  */
-/*                                                                                                                                    */
-/*	Synopsis:                                                                                                                         */
-/*		GetGPIStat();                                                                                                                 */
-/*	Parameters:                                                                                                                       */  
-/*		void                                                                                                                          */
-/*  Return Value:                                                                                                                     */
-/*		uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPI_STAT bits, for each GPI pin. These bits are        */
-/*		grouped in the three GPI_STATUS 8-bit registers                                                                               */
-/*                                                                                                                                    */
-/*	Errors:                                                                                                                           */
-/*                                                                                                                                    */
-/*	Description:                                                                                                                      */
-/*		This function returns a value containing in its 19 LSbs the value of the GPI_STAT bits, for each GPI pin. These bits are      */
-/*		grouped in the three GPI_STATUS 8-bit registers. This is the function used to read the input value of the GPIOs defined       */
-/*		as inputs.                                                                                                                    */
-/*		Note that each GPI_STAT bit can be accessed using the function GetRegisterBit(IOXP_GPI_STATUS_GPI_STAT(bGPIONo)),             */
-/*		where bGPIONo is in the 1 - 19 range.                                                                                         */
-/* ---------------------------------------------------------------------------------------------------------------------------------- */
+#if defined(IOXP_PROFILE)
+/* -------------------------------------------------------------------- */
+/*	IOXP::GetStats                                                      */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		const IOXPStats &stats = GetStats();                            */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		const IOXPStats & - the bus traffic statistics                  */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the bus traffic statistics collected since the object   */
+/*		was created or since the last call of ResetStats. Every I2C     */
+/*		transaction is accounted to the address of its first register,  */
+/*		so a burst shows up once, under its start address.              */
+/*		Only available when IOXP_PROFILE is defined.                    */
+/* -------------------------------------------------------------------- */
 
-uint32_t IOXP::GetGPIStat()
+const IOXPStats &IOXP::GetStats()
 {
-	uint32_t bResult = 0;
-	ReadBytesI2C(IOXP_ADDR_GPI_STATUS_A, 3, (uint8_t *)&bResult);
-	return bResult;
+	return stats;
 }
 
-/* ------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::SetGPIIntLevel                                                                                                           */
-/*                                                                                                                                 */
-/*	Synopsis:                                                                                                                      */
-/*		SetGPIIntLevel(uint32_t dwBitMap);                                                                                         */
-/*	Parameters:                                                                                                                    */  
-/*	 	uint32_t dwBitMap	- the 32-bit value containing in its 19 LSbs the value of the GPI_INT_LEVEL bits, for each GPI pin.    */
-/*							  These bits are grouped in the three GPI_INT_LEVEL 8-bit registers                                    */
-/*                                                                                                                                 */
-/*  Return Value:                                                                                                                  */
-/*		void                                                                                                                       */
-/*                                                                                                                                 */
-/*	Errors:                                                                                                                        */
-/*                                                                                                                                 */
-/*	Description:                                                                                                                   */
-/*		This function sets the value of the GPI_INT_LEVEL bits from GPI_INT_LEVEL registers for all 19 pins by providing a 32-bit  */
-/*		value containing in its 19 bits the specified values.                                                                      */
-/*		Note that each GPI_INT_LEVEL bit can be accessed using the function SetRegisterBit(IOXP_INT_LEVEL_GPI_INT_LEVEL(bGPIONo)), */
-/*		where bGPIONo is in the 1 - 19 range.                                                                                      */
-/* ------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::ResetStats                                                    */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ResetStats();                                                   */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Clears the bus traffic statistics.                              */
+/*		Only available when IOXP_PROFILE is defined.                    */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetGPIIntLevel(uint32_t dwBitMap)
+void IOXP::ResetStats()
 {
-	WriteBytesI2C(IOXP_ADDR_GPI_INT_LEVEL_A, 3, (uint8_t *)&dwBitMap);
+	memset(&stats, 0, sizeof(stats));
 }
 
-/* -------------------------------------------------------------------------------------------------------------------------------------- */
-/*	 IOXP::GetGPIIntLevel                                                                                                                 */
-/*                                                                                                                                        */
-/*	Synopsis:                                                                                                                             */
-/*		GetGPIIntLevel();                                                                                                                 */
-/*	Parameters:                                                                                                                           */  
-/*	 	 void                                                                                                                             */
-/*		                                                                                                                                  */
-/*	Return Value:																														  */
-/*		 uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPI_INT_LEVEL bits, for each GPI pin. These bits are      */
-/*					grouped in the three GPI_INT_LEVEL 8-bit registers                                                                    */
-/*                                                                                                                                        */
-/*	Errors:                                                                                                                               */
-/*                                                                                                                                        */
-/*	Description:                                                                                                                          */
-/*		This function returns a value containing in its 19 LSbs the value of the GPI_INT_LEVEL bits, for each GPI pin. These bits are     */
-/*		grouped in the three GPI_INT_LEVEL 8-bit registers.                                                                               */
-/*		Note that each GPI_INT_LEVEL bit can be accessed using the function GetRegisterBit(IOXP_INT_LEVEL_GPI_INT_LEVEL(bGPIONo)),        */
-/*		where bGPIONo is in the 1 - 19 range.                                                                                             */
-/* -------------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::DumpStats                                                     */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		DumpStats(Serial);                                              */
+/*	Parameters:                                                         */  
+/*		Print &out - the stream where the statistics are printed        */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Prints the bus traffic statistics in a compact form. The first  */
+/*		line holds the totals:                                          */
+/*			T <wire time us> M <max bytes>@<addr> <max time us>         */
+/*		followed by one line for each register address that was        */
+/*		accessed, all values except the address in decimal:             */
+/*			<addr hex> R <reads> W <writes> B <bytes>                   */
+/*		Only available when IOXP_PROFILE is defined.                    */
+/* -------------------------------------------------------------------- */
 
-uint32_t IOXP::GetGPIIntLevel()
-{
-	uint32_t bResult = 0;
-	ReadBytesI2C(IOXP_ADDR_GPI_INT_LEVEL_A, 3, (uint8_t *)&bResult);
-	return bResult;
+void IOXP::DumpStats(Print &out)
+{
+	out.print("T ");
+	out.print((unsigned long)stats.dwWireTimeUS);
+	out.print(" M ");
+	out.print((unsigned int)stats.bMaxTransferBytes);
+	out.print("@");
+	out.print((unsigned int)stats.bMaxTransferAddr, HEX);
+	out.print(" ");
+	out.println((unsigned long)stats.dwMaxTransferUS);
+	for(int nAddr = 0; nAddr < IOXP_NO_REGS; nAddr++)
+	{
+		if(stats.rgdwReads[nAddr] == 0 && stats.rgdwWrites[nAddr] == 0)
+		{
+			continue;
+		}
+		if(nAddr < 0x10)
+		{
+			out.print("0");
+		}
+		out.print(nAddr, HEX);
+		out.print(" R ");
+		out.print((unsigned long)stats.rgdwReads[nAddr]);
+		out.print(" W ");
+		out.print((unsigned long)stats.rgdwWrites[nAddr]);
+		out.print(" B ");
+		out.println((unsigned long)stats.rgdwBytes[nAddr]);
+	}
 }
+#endif
 
-/* ---------------------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::SetGPIEventEn                                                                                                                           */
-/*                                                                                                                                                */
-/*	Synopsis:                                                                                                                                     */
-/*		SetGPIEventEn(uint32_t dwBitMap);                                                                                                         */
-/*	Parameters:                                                                                                                                   */  
-/*	 	uint32_t dwBitMap	- the 32-bit value containing in its 19 LSbs the value of the GPI_EVENT_EN bits, for each GPI pin. These bits are     */
-/*							  grouped in the three GPI_EVENT_EN 8-bit registers.                                                                  */
-/*                                                                                                                                                */
-/*  Return Value:                                                                                                                                 */
-/*		void                                                                                                                                      */
-/*                                                                                                                                                */
-/*	Errors:                                                                                                                                       */
-/*                                                                                                                                                */
-/*	Description:                                                                                                                                  */
-/*		This function sets the value of the GPI_EVENT_EN bits from GPI_EVENT_EN registers for all 19 pins by providing a 32-bit value containing  */
-/*		in its 19 bits the specified values.                                                                                                      */
-/*		Note that each GPI_EVENT_EN bit can be accessed using the function SetRegisterBit(IOXP_GPI_EVENT_EN_GPI_EVENT_EN(bGPIONo)),               */
-/*		where bGPIONo is in the 1 - 19 range.                                                                                                     */
-/* ---------------------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::BeginBatch                                                    */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		BeginBatch();                                                   */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Starts recording register writes. Until CommitBatch is called,  */
+/*		writes to configuration registers (whole or masked, from any    */
+/*		function of the library) are only staged in the object, and    */
+/*		reads of those registers return the staged values. Writes to    */
+/*		the volatile registers (for example INT_STATUS) are still       */
+/*		performed immediately. Calling BeginBatch while a batch is open */
+/*		keeps the staged writes.                                        */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetGPIEventEn(uint32_t dwBitMap)
+void IOXP::BeginBatch()
 {
-	WriteBytesI2C(IOXP_ADDR_GPI_EVENT_EN_A, 3, (uint8_t *)&dwBitMap);
+	if(!fBatch)
+	{
+		memset(rgbBatchMask, 0, sizeof(rgbBatchMask));
+		fBatch = true;
+	}
 }
 
-/* ------------------------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetGPIEventEn                                                                                                                              */
-/*                                                                                                                                                   */
-/*	Synopsis:                                                                                                                                        */
-/*		GetGPIEventEn();                                                                                                                             */
-/*	Parameters:                                                                                                                                      */  
-/*	 	 void                                                                                                                                        */
-/*		                                                                                                                                             */
-/*  Return Value:                                                                                                                                    */
-/*		 uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPI_EVENT_EN bits, for each GPI pin. These bits are grouped in the   */
-/*					three GPI_EVENT_EN 8-bit registers.                                                                                              */
-/*                                                                                                                                                   */
-/*                                                                                                                                                   */
-/*	Errors:                                                                                                                                          */
-/*                                                                                                                                                   */
-/*	Description:                                                                                                                                     */
-/*		This function a value containing in its 19 LSbs the value of the GPI_EVENT_EN bits, for each GPI pin. These bits are grouped in the three    */
-/*		GPI_EVENT_EN 8-bit registers.                                                                                                                */
-/*		Note that each GPI_EVENT_EN bit can be accessed using the function GetRegisterBit(IOXP_GPI_EVENT_EN_GPI_EVENT_EN(bGPIONo)),                  */
-/*		where bGPIONo is in the 1 - 19 range.                                                                                                        */
-/* ------------------------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::CommitBatch                                                   */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		CommitBatch();                                                  */
+/*	Parameters:                                                         */  
+/*		void                                                            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or the first I2C error encountered        */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		See GetLastI2CStatus. The batch is closed even on error.        */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Writes the registers staged since BeginBatch and ends the batch. */
+/*		Registers that were only partly written (masked writes) are     */
+/*		completed from the register cache when it holds them, otherwise */
+/*		they are read from the device in auto-increment bursts. The     */
+/*		staged registers are then written in auto-increment bursts of   */
+/*		adjacent addresses. With the register cache enabled, unchanged  */
+/*		registers are skipped, and up to IOXP_BATCH_MAX_GAP cached      */
+/*		registers between two bursts are rewritten to join them.        */
+/* -------------------------------------------------------------------- */
 
-uint32_t IOXP::GetGPIEventEn()
+uint8_t IOXP::CommitBatch()
 {
-	uint32_t bResult = 0;
-	ReadBytesI2C(IOXP_ADDR_GPI_EVENT_EN_A, 3, (uint8_t *)&bResult);
-	return bResult;
+	uint8_t bStatus = IOXP_I2C_OK;
+	uint8_t rgbVals[IOXP_NO_REGS];
+	int nAddr, nNext, nFirst, nLast;
+	int nLastRead = -1;
+	if(!fBatch)
+	{
+		return IOXP_I2C_OK;
+	}
+	fBatch = false;
+
+	// complete the masked writes, reading the registers that are not cached
+	for(nAddr = 0; nAddr < IOXP_NO_REGS; nAddr++)
+	{
+		uint8_t bMask = rgbBatchMask[nAddr];
+		if(bMask == 0 || bMask == 0xFF)
+		{
+			continue;
+		}
+		if(nAddr > nLastRead && !(fCacheEn && IsShadowValid(nAddr)))
+		{
+			// read this register and the next partly written ones in one burst
+			nLast = nAddr;
+			for(nNext = nAddr + 1; nNext <= nLast + 1 + IOXP_BATCH_MAX_GAP && IOXP_IS_ADDR_CACHEABLE(nNext); nNext++)
+			{
+				if(rgbBatchMask[nNext] != 0 && rgbBatchMask[nNext] != 0xFF)
+				{
+					nLast = nNext;
+				}
+			}
+			bStatus = ReadBytesI2C(nAddr, nLast - nAddr + 1, rgbVals);	// also loads the shadow
+			if(bStatus != IOXP_I2C_OK)
+			{
+				return bStatus;
+			}
+			nLastRead = nLast;
+		}
+		rgbBatchVal[nAddr] = (rgbShadow[nAddr] & ~bMask) | (rgbBatchVal[nAddr] & bMask);
+		rgbBatchMask[nAddr] = 0xFF;
+	}
+
+	// drop the writes that do not change the register
+	if(fCacheEn)
+	{
+		for(nAddr = 0; nAddr < IOXP_NO_REGS; nAddr++)
+		{
+			if(rgbBatchMask[nAddr] != 0 && IsShadowValid(nAddr) && rgbShadow[nAddr] == rgbBatchVal[nAddr])
+			{
+				rgbBatchMask[nAddr] = 0;
+				dwCacheSavedWrites++;
+			}
+		}
+	}
+
+	// write the staged registers in auto-increment bursts
+	for(nAddr = 0; nAddr < IOXP_NO_REGS; nAddr++)
+	{
+		if(rgbBatchMask[nAddr] == 0)
+		{
+			continue;
+		}
+		nFirst = nAddr;
+		nLast = nAddr;
+		for(nNext = nAddr + 1; nNext < IOXP_NO_REGS && nNext <= nLast + 1 + IOXP_BATCH_MAX_GAP; nNext++)
+		{
+			if(rgbBatchMask[nNext] != 0)
+			{
+				nLast = nNext;
+			}
+			else if(!(fCacheEn && IsShadowValid(nNext)))
+			{
+				// the register value is unknown, the burst cannot cross it
+				break;
+			}
+		}
+		for(nAddr = nFirst; nAddr <= nLast; nAddr++)
+		{
+			if(rgbBatchMask[nAddr] == 0)
+			{
+				rgbBatchVal[nAddr] = rgbShadow[nAddr];
+			}
+		}
+		bStatus = WriteBytesI2C(nFirst, nLast - nFirst + 1, rgbBatchVal + nFirst);
+		if(bStatus != IOXP_I2C_OK)
+		{
+			return bStatus;
+		}
+		nAddr = nLast;
+	}
+	return bStatus;
 }
 
-/* ------------------------------------------------------------------------------------------------------------------------------ */
-/*	IOXP::SetGPIDebounceDis                                                                                                       */
-/*                                                                                                                                */
-/*	Synopsis:                                                                                                                     */
-/*		SetGPIDebounceDis(uint32_t dwBitMap);                                                                                     */
-/*	Parameters:                                                                                                                   */  
-/*	 	uint32_t dwBitMap	- the 32-bit value containing in its 19 LSbs the value of the GPI_DEB_DIS bits, for each GPI pin.     */
-/*							  These bits are grouped in the three DEBOUNCE_DIS 8-bit registers.                                   */
-/*                                                                                                                                */
-/*  Return Value:                                                                                                                 */
-/*		 void                                                                                                                     */
-/*                                                                                                                                */
-/*	Errors:                                                                                                                       */
-/*                                                                                                                                */
-/*	Description:                                                                                                                  */
-/*		This function sets the value of the GPI_DEB_DIS bits from DEBOUNCE_DIS registers for all 19 pins by providing a 32-bit    */
-/*		value containing in its 19 bits the specified values.                                                                     */
-/*		Note that each GPI_DEB_DIS bit can be accessed using the function SetRegisterBit(IOXP_DEBOUNCE_DIS_GPI_DEB_DIS(bGPIONo)), */ 
-/*	    where bGPIONo is in the 1 - 19 range.                                                                                     */
-/* ------------------------------------------------------------------------------------------------------------------------------ */
+/* -------------------------------------------------------------------- */
+/*	IOXP::InitConfig                                                    */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		InitConfig(cfg);                                                */
+/*	Parameters:                                                         */  
+/*		IOXPConfig &cfg	- the configuration to initialize               */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Sets cfg to the reset state of the device: all registers 0, so  */
+/*		300 kO pull-ups, GPIO inputs, no key matrix, oscillator off.    */
+/*		The application then only sets the fields it needs.            */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetGPIDebounceDis(uint32_t dwBitMap)
+void IOXP::InitConfig(IOXPConfig &cfg)
 {
-	WriteBytesI2C(IOXP_ADDR_DEBOUNCE_DIS_A, 3, (uint8_t *)&dwBitMap);
+	memset(&cfg, 0, sizeof(cfg));
 }
 
-/* -------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetGPIDebounceDis                                                                                                         */
-/*                                                                                                                                  */
-/*	Synopsis:                                                                                                                       */
-/*		GetGPIDebounceDis();                                                                                                        */
-/*	Parameters:                                                                                                                     */  
-/*	 	 void                                                                                                                       */
-/*  Return Value:                                                                                                                   */
-/*		 uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPI_DEB_DIS bits, for each GPI pin. These bits      */
-/*					are grouped in the three DEBOUNCE_DIS 8-bit registers.                                                          */
-/*                                                                                                                                  */
-/*                                                                                                                                  */
-/*	Errors:                                                                                                                         */
-/*                                                                                                                                  */
-/*	Description:                                                                                                                    */
-/*		This function returns a value containing in its 19 LSbs the value of the GPI_DEB_DIS bits, for each GPI pin. These bits     */
-/*		are grouped in the three DEBOUNCE_DIS 8-bit registers.                                                                      */
-/*		Note that each GPI_DEB_DIS bit can be accessed using the function GetRegisterBit(IOXP_DEBOUNCE_DIS_GPI_DEB_DIS(bGPIONo)),   */
-/*		where bGPIONo is in the 1 - 19 range.                                                                                       */
-/* -------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::BuildConfigImage                                              */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		BuildConfigImage(cfg, rgbImage);                                */
+/*	Parameters:                                                         */  
+/*		const IOXPConfig &cfg	- the configuration                     */
+/*		uint8_t *rgbImage		- receives IOXP_CFG_IMAGE_SIZE bytes,   */
+/*								  the values of the registers           */
+/*								  IOXP_CFG_FIRST - IOXP_CFG_LAST        */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Converts the configuration to register values. No I2C access.   */
+/* -------------------------------------------------------------------- */
 
-uint32_t IOXP::GetGPIDebounceDis()
+void IOXP::BuildConfigImage(const IOXPConfig &cfg, uint8_t *rgbImage)
 {
-	uint32_t bResult = 0;
-	ReadBytesI2C(IOXP_ADDR_DEBOUNCE_DIS_A, 3, (uint8_t *)&bResult);
-	return bResult;
+	// GPI_INT_LEVEL - GPIO_DIRECTION: seven consecutive groups of three registers
+	const uint32_t rgdwMaps[7] = {cfg.dwGpiIntLevel, cfg.dwGpiEventEn, cfg.dwGpiIntEn, cfg.dwDebounceDis,
+		cfg.dwGpoOut, cfg.dwGpoOutMode, cfg.dwDirection};
+	uint8_t *pbMaps = rgbImage + (IOXP_ADDR_GPI_INT_LEVEL_A - IOXP_CFG_FIRST);
+	int i;
+	memset(rgbImage, 0, IOXP_CFG_IMAGE_SIZE);
+	for(i = 0; i < IOXP_GPIOS; i++)
+	{
+		// rows in RPULL_CONFIG_A - B, columns in RPULL_CONFIG_C - E, 2 bits per pin
+		int iPin = (i < IOXP_KB_ROWS) ? i : (i - IOXP_KB_ROWS);
+		int iReg = ((i < IOXP_KB_ROWS) ? IOXP_ADDR_RPULL_CONFIG_A : IOXP_ADDR_RPULL_CONFIG_C) - IOXP_CFG_FIRST + div4(iPin);
+		rgbImage[iReg] |= (cfg.rgbPull[i] & 3) << (mod4(iPin) << 1);
+	}
+	for(i = 0; i < 7 * 3; i++)
+	{
+		pbMaps[i] = (uint8_t)(rgdwMaps[i / 3] >> ((i % 3) << 3));
+	}
+	memcpy(rgbImage + (IOXP_ADDR_UNLOCK1 - IOXP_CFG_FIRST), cfg.rgbLockCfg, sizeof(cfg.rgbLockCfg));
+	memcpy(rgbImage + (IOXP_ADDR_RESET1_EVENT_A - IOXP_CFG_FIRST), cfg.rgbResetCfg, sizeof(cfg.rgbResetCfg));
+	rgbImage[IOXP_ADDR_PWM_OFFT_LOW - IOXP_CFG_FIRST] = (uint8_t)cfg.wPwmOffTime;
+	rgbImage[IOXP_ADDR_PWM_OFFT_HIGH - IOXP_CFG_FIRST] = (uint8_t)(cfg.wPwmOffTime >> 8);
+	rgbImage[IOXP_ADDR_PWM_ONT_LOW - IOXP_CFG_FIRST] = (uint8_t)cfg.wPwmOnTime;
+	rgbImage[IOXP_ADDR_PWM_ONT_HIGH - IOXP_CFG_FIRST] = (uint8_t)(cfg.wPwmOnTime >> 8);
+	rgbImage[IOXP_ADDR_PWM_CFG - IOXP_CFG_FIRST] = cfg.bPwmCfg;
+	rgbImage[IOXP_ADDR_CLOCK_DIV_CFG - IOXP_CFG_FIRST] = cfg.bClockDivCfg;
+	rgbImage[IOXP_ADDR_LOGIC_1_CFG - IOXP_CFG_FIRST] = cfg.bLogic1Cfg;
+	rgbImage[IOXP_ADDR_LOGIC_2_CFG - IOXP_CFG_FIRST] = cfg.bLogic2Cfg;
+	rgbImage[IOXP_ADDR_LOGIC_FF_CFG - IOXP_CFG_FIRST] = cfg.bLogicFFCfg;
+	rgbImage[IOXP_ADDR_LOGIC_INT_EVENT - IOXP_CFG_FIRST] = cfg.bLogicIntEvent;
+	rgbImage[IOXP_ADDR_POLL_TIME_CFG - IOXP_CFG_FIRST] = cfg.bPollTime & IOXP_FIELD_KEY_POLL_TIME::bFieldMask;
+	rgbImage[IOXP_ADDR_PIN_CONFIG_A - IOXP_CFG_FIRST] = cfg.bRowCfg;
+	rgbImage[IOXP_ADDR_PIN_CONFIG_B - IOXP_CFG_FIRST] = (uint8_t)cfg.wColCfg;
+	rgbImage[IOXP_ADDR_PIN_CONFIG_C - IOXP_CFG_FIRST] = (uint8_t)((cfg.wColCfg >> 8) & 0x07);
+	rgbImage[IOXP_ADDR_PIN_CONFIG_D - IOXP_CFG_FIRST] = cfg.bPinConfigD;
+	rgbImage[IOXP_ADDR_GENERAL_CFG_B - IOXP_CFG_FIRST] = (cfg.bGeneralCfgB & ~IOXP_FIELD_CORE_FREQ::bFieldMask) | 
+		((cfg.bCoreFreq << IOXP_FIELD_CORE_FREQ::bShift) & IOXP_FIELD_CORE_FREQ::bFieldMask);
+	rgbImage[IOXP_ADDR_INT_EN - IOXP_CFG_FIRST] = cfg.bIntEn;
 }
 
-/* ------------------------------------------------------------------------------------------------------------------------------ */
-/*	IOXP::SetGPODataOut                                                                                                           */
-/*                                                                                                                                */
-/*	Synopsis:                                                                                                                     */
-/*		SetGPODataOut(uint32_t dwBitMap);                                                                                         */
-/*	Parameters:                                                                                                                   */  
-/*		uint32_t dwBitMap	- the 32-bit value containing in its 19 LSbs the value of the GPO_DATA bits, for each GPI pin. These  */
-/*							  bits are grouped in the three GPO_DATA_OUT 8-bit registers.                                         */
-/*                                                                                                                                */
-/*  Return Value:                                                                                                                 */
-/*		  void                                                                                                                    */
-/*                                                                                                                                */
-/*	Errors:                                                                                                                       */
-/*                                                                                                                                */
-/*	Description:                                                                                                                  */
-/*		This function sets the value of the GPO_DATA bits from GPO_DATA_OUT registers for all 19 pins by providing a 32-bit value */
-/*		containing in its 19 bits the specified values.                                                                           */
-/*		Note that each GPO_DATA bit can be accessed using the function SetRegisterBit(IOXP_GPO_DATA_OUT_GPO_DATA(bGPIONo)), where */
-/*		bGPIONo is in the 1 - 19 range.                                                                                           */
-/* ------------------------------------------------------------------------------------------------------------------------------ */
+/* -------------------------------------------------------------------- */
+/*	IOXP::ParseConfigImage                                              */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ParseConfigImage(rgbImage, cfg);                                */
+/*	Parameters:                                                         */  
+/*		const uint8_t *rgbImage	- IOXP_CFG_IMAGE_SIZE register values   */
+/*		IOXPConfig &cfg			- receives the configuration            */
+/*                                                                      */	                                                     
+/*	Description:                                                        */
+/*		Reverse of BuildConfigImage, used by ReadConfig.                */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetGPODataOut(uint32_t dwBitMap)
+void IOXP::ParseConfigImage(const uint8_t *rgbImage, IOXPConfig &cfg)
 {
-	WriteBytesI2C(IOXP_ADDR_GPO_DATA_OUT_A, 3, (uint8_t *)&dwBitMap);
+	uint32_t *rgpdwMaps[7] = {&cfg.dwGpiIntLevel, &cfg.dwGpiEventEn, &cfg.dwGpiIntEn, &cfg.dwDebounceDis,
+		&cfg.dwGpoOut, &cfg.dwGpoOutMode, &cfg.dwDirection};
+	const uint8_t *pbMaps = rgbImage + (IOXP_ADDR_GPI_INT_LEVEL_A - IOXP_CFG_FIRST);
+	int i;
+	for(i = 0; i < IOXP_GPIOS; i++)
+	{
+		int iPin = (i < IOXP_KB_ROWS) ? i : (i - IOXP_KB_ROWS);
+		int iReg = ((i < IOXP_KB_ROWS) ? IOXP_ADDR_RPULL_CONFIG_A : IOXP_ADDR_RPULL_CONFIG_C) - IOXP_CFG_FIRST + div4(iPin);
+		cfg.rgbPull[i] = (rgbImage[iReg] >> (mod4(iPin) << 1)) & 3;
+	}
+	for(i = 0; i < 7; i++)
+	{
+		*rgpdwMaps[i] = (uint32_t)pbMaps[3 * i] | ((uint32_t)pbMaps[3 * i + 1] << 8) | ((uint32_t)pbMaps[3 * i + 2] << 16);
+	}
+	memcpy(cfg.rgbLockCfg, rgbImage + (IOXP_ADDR_UNLOCK1 - IOXP_CFG_FIRST), sizeof(cfg.rgbLockCfg));
+	memcpy(cfg.rgbResetCfg, rgbImage + (IOXP_ADDR_RESET1_EVENT_A - IOXP_CFG_FIRST), sizeof(cfg.rgbResetCfg));
+	cfg.wPwmOffTime = rgbImage[IOXP_ADDR_PWM_OFFT_LOW - IOXP_CFG_FIRST] | (rgbImage[IOXP_ADDR_PWM_OFFT_HIGH - IOXP_CFG_FIRST] << 8);
+	cfg.wPwmOnTime = rgbImage[IOXP_ADDR_PWM_ONT_LOW - IOXP_CFG_FIRST] | (rgbImage[IOXP_ADDR_PWM_ONT_HIGH - IOXP_CFG_FIRST] << 8);
+	cfg.bPwmCfg = rgbImage[IOXP_ADDR_PWM_CFG - IOXP_CFG_FIRST];
+	cfg.bClockDivCfg = rgbImage[IOXP_ADDR_CLOCK_DIV_CFG - IOXP_CFG_FIRST];
+	cfg.bLogic1Cfg = rgbImage[IOXP_ADDR_LOGIC_1_CFG - IOXP_CFG_FIRST];
+	cfg.bLogic2Cfg = rgbImage[IOXP_ADDR_LOGIC_2_CFG - IOXP_CFG_FIRST];
+	cfg.bLogicFFCfg = rgbImage[IOXP_ADDR_LOGIC_FF_CFG - IOXP_CFG_FIRST];
+	cfg.bLogicIntEvent = rgbImage[IOXP_ADDR_LOGIC_INT_EVENT - IOXP_CFG_FIRST];
+	cfg.bPollTime = rgbImage[IOXP_ADDR_POLL_TIME_CFG - IOXP_CFG_FIRST] & IOXP_FIELD_KEY_POLL_TIME::bFieldMask;
+	cfg.bRowCfg = rgbImage[IOXP_ADDR_PIN_CONFIG_A - IOXP_CFG_FIRST];
+	cfg.wColCfg = rgbImage[IOXP_ADDR_PIN_CONFIG_B - IOXP_CFG_FIRST] | ((rgbImage[IOXP_ADDR_PIN_CONFIG_C - IOXP_CFG_FIRST] & 0x07) << 8);
+	cfg.bPinConfigD = rgbImage[IOXP_ADDR_PIN_CONFIG_D - IOXP_CFG_FIRST];
+	cfg.bGeneralCfgB = rgbImage[IOXP_ADDR_GENERAL_CFG_B - IOXP_CFG_FIRST] & ~IOXP_FIELD_CORE_FREQ::bFieldMask;
+	cfg.bCoreFreq = (rgbImage[IOXP_ADDR_GENERAL_CFG_B - IOXP_CFG_FIRST] & IOXP_FIELD_CORE_FREQ::bFieldMask) >> IOXP_FIELD_CORE_FREQ::bShift;
+	cfg.bIntEn = rgbImage[IOXP_ADDR_INT_EN - IOXP_CFG_FIRST];
 }
 
-/* ----------------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetGPODataOut                                                                                                                      */
-/*                                                                                                                                           */
-/*	Synopsis:                                                                                                                                */
-/*		GetGPODataOut()                                                                                                                      */
-/*	Parameters:                                                                                                                              */  
-/*	 	void                                                                                                                                 */
-/*		                                                                                                                                     */
-/*  Return Value:                                                                                                                            */
-/*		uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPO_DATA bits, for each GPI pin. These bits are grouped in    */
-/*				   the three GPO_DATA_OUT 8-bit registers.                                                                                   */
-/*                                                                                                                                           */
-/*                                                                                                                                           */
-/*	Errors:                                                                                                                                  */
-/*                                                                                                                                           */
-/*	Description:                                                                                                                             */
-/*		This function returns a value containing in its 19 LSbs the value of the GPI_DEB_DIS bits, for each GPI pin. These bits are          */
-/*		grouped in the three DEBOUNCE_DIS 8-bit registers.                                                                                   */
-/*		Note that each GPO_DATA bit can be accessed using the function GetRegisterBit(IOXP_GPO_DATA_OUT_GPO_DATA(bGPIONo)),                  */
-/*		where bGPIONo is in the 1 - 19 range.                                                                                                */
-/* ----------------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::ReadConfig                                                    */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ReadConfig(cfg);                                                */
+/*	Parameters:                                                         */  
+/*		IOXPConfig &cfg	- receives the configuration of the device      */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or the I2C error                          */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		See GetLastI2CStatus. cfg is not changed on error.              */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Reads the configuration registers in auto-increment bursts      */
+/*		(served from the register cache when enabled). Useful to change */
+/*		a few fields of the running configuration and ApplyConfig it.   */
+/* -------------------------------------------------------------------- */
 
-uint32_t IOXP::GetGPODataOut()
+uint8_t IOXP::ReadConfig(IOXPConfig &cfg)
 {
-	uint32_t bResult = 0;
-	ReadBytesI2C(IOXP_ADDR_GPO_DATA_OUT_A, 3, (uint8_t *)&bResult);
-	return bResult;
+	uint8_t rgbImage[IOXP_CFG_IMAGE_SIZE];
+	uint8_t bStatus = ReadBytesI2C(IOXP_CFG_FIRST, IOXP_CFG_IMAGE_SIZE, rgbImage);
+	if(bStatus == IOXP_I2C_OK)
+	{
+		ParseConfigImage(rgbImage, cfg);
+	}
+	return bStatus;
 }
 
-/* ---------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::SetGPOOutMode                                                                                                               */
-/*                                                                                                                                    */
-/*	Synopsis:                                                                                                                         */
-/*		SetGPOOutMode(uint32_t dwBitMap);                                                                                             */
-/*	Parameters:                                                                                                                       */  
-/*	 	uint32_t dwBitMap	- the 32-bit value containing in its 19 LSbs the value of the GPO_OUT_MODE bits, for each GPI pin.        */
-/*								  These bits are grouped in the three GPO_OUT_MODE 8-bit registers.                                   */
-/*	                                                                                                                                  */
-/*  Return Value:                                                                                                                     */
-/*		void                                                                                                                          */
-/*                                                                                                                                    */
-/*	Errors:                                                                                                                           */
-/*                                                                                                                                    */
-/*	Description:                                                                                                                      */
-/*		This function sets the value of the GPO_OUT_MODE bits from GPO_OUT_MODE registers for all 19 pins by providing a 32-bit value */
-/*		containing in its 19 bits the specified values.                                                                               */
-/*		Note that each GPO_OUT_MODE bit can be accessed using the function SetRegisterBit(IOXP_GPO_OUT_MODE_GPO_OUT_MODE(bGPIONo)),   */
-/*		where bGPIONo is in the 1 - 19 range.                                                                                         */
-/* ---------------------------------------------------------------------------------------------------------------------------------- */
-
+/* -------------------------------------------------------------------- */
+/*	IOXP::ApplyConfig                                                   */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ApplyConfig(cfg);                                               */
+/*	Parameters:                                                         */  
+/*		const IOXPConfig &cfg	- the configuration to apply            */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or the first I2C error encountered        */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		See GetLastI2CStatus.                                           */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Builds the register image of cfg and writes it with             */
+/*		ApplyConfigImage: only the registers that differ from the      */
+/*		values last written are sent.                                   */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetGPOOutMode(uint32_t dwBitMap)
+uint8_t IOXP::ApplyConfig(const IOXPConfig &cfg)
 {
-	WriteBytesI2C(IOXP_ADDR_GPO_DATA_OUT_A, 3, (uint8_t *)&dwBitMap);
+	uint8_t rgbImage[IOXP_CFG_IMAGE_SIZE];
+	BuildConfigImage(cfg, rgbImage);
+	return ApplyConfigImage(rgbImage);
 }
 
-/* ------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetGPOOutMode                                                                                                            */
-/*                                                                                                                                 */
-/*	Synopsis:                                                                                                                      */
-/*		GetGPOOutMode()                                                                                                            */
-/*	Parameters:                                                                                                                    */  
-/*		void                                                                                                                       */
-/*		                                                                                                                           */
-/*  Return Value:                                                                                                                  */
-/*		 uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPO_OUT_MODE bits, for each GPI pin. These bits    */
-/*					are grouped in the three GPO_OUT_MODE 8-bit registers.                                                         */
-/*                                                                                                                                 */
-/*                                                                                                                                 */
-/*	Errors:                                                                                                                        */
-/*                                                                                                                                 */
-/*	Description:                                                                                                                   */
-/*		This function retrieves the value of the GPO_OUT_MODE bits from GPO_OUT_MODE registers for all 19 pins.                    */
-/*		Note that each GPO_OUT_MODE bit can be accessed using the function GetRegisterBit(IOXP_GPO_OUT_MODE_GPO_OUT_MODE(bGPIONo)),*/
-/*		where bGPIONo is in the 1 - 19 range.                                                                                      */
-/* ------------------------------------------------------------------------------------------------------------------------------- */
-
+/* -------------------------------------------------------------------- */
+/*	IOXP::ApplyConfigImage                                              */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ApplyConfigImage(rgbImage);                                     */
+/*	Parameters:                                                         */  
+/*		const uint8_t *rgbImage	- IOXP_CFG_IMAGE_SIZE values of the     */
+/*								  registers IOXP_CFG_FIRST -            */
+/*								  IOXP_CFG_LAST                         */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or the first I2C error encountered        */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		See GetLastI2CStatus.                                           */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Compares the image with the register shadow (the values last    */
+/*		written or read by the library, whether or not the register     */
+/*		cache is enabled) and writes only the registers that differ or  */
+/*		were never accessed, in auto-increment bursts. Up to            */
+/*		IOXP_BATCH_MAX_GAP unchanged registers are rewritten to join    */
+/*		two bursts. The first call after power-up or                    */
+/*		InvalidateRegisterCache writes the whole range (two bursts);    */
+/*		later calls only write what changed. Inside BeginBatch /        */
+/*		CommitBatch the registers are staged with the rest of the      */
+/*		batch instead of being written.                                 */
+/* -------------------------------------------------------------------- */
 
-uint32_t IOXP::GetGPOOutMode()
+uint8_t IOXP::ApplyConfigImage(const uint8_t *rgbImage)
 {
-	uint32_t bResult = 0;
-	ReadBytesI2C(IOXP_ADDR_GPO_DATA_OUT_A, 3, (uint8_t *)&bResult);
-	return bResult;
+	bool fOpenBatch = fBatch;
+	int nAddr, nGap;
+	int nPrev = -1;
+	BeginBatch();
+	for(nAddr = IOXP_CFG_FIRST; nAddr <= IOXP_CFG_LAST; nAddr++)
+	{
+		uint8_t bVal = rgbImage[nAddr - IOXP_CFG_FIRST];
+		if(rgbBatchMask[nAddr] == 0 && IsShadowValid(nAddr) && rgbShadow[nAddr] == bVal)
+		{
+			continue;
+		}
+		if(nPrev >= 0 && nAddr - nPrev - 1 <= IOXP_BATCH_MAX_GAP)
+		{
+			// the skipped registers hold their image values, rewrite them to join the bursts
+			for(nGap = nPrev + 1; nGap < nAddr; nGap++)
+			{
+				rgbBatchVal[nGap] = rgbImage[nGap - IOXP_CFG_FIRST];
+				rgbBatchMask[nGap] = 0xFF;
+			}
+		}
+		rgbBatchVal[nAddr] = bVal;
+		rgbBatchMask[nAddr] = 0xFF;
+		nPrev = nAddr;
+	}
+	if(fOpenBatch)
+	{
+		return IOXP_I2C_OK;
+	}
+	return CommitBatch();
 }
 
-/* ------------------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::SetGPIODirection                                                                                                                     */
-/*                                                                                                                                             */
-/*	Synopsis:                                                                                                                                  */
-/*		SetGPIODirection(uint32_t dwBitMap);                                                                                                   */
-/*	Parameters:                                                                                                                                */  
-/*		uint32_t dwBitMap	- the 32-bit value containing in its 19 LSbs the value of the GPIO_DIR bits, for each GPI pin. These bits are      */
-/*							  grouped in the three GPIO_DIRECTION 8-bit registers                                                              */
-/*                                                                                                                                             */
-/*  Return Value:                                                                                                                              */
-/*		void                                                                                                                                   */
-/*                                                                                                                                             */
-/*	Errors:                                                                                                                                    */
-/*                                                                                                                                             */
-/*	Description:                                                                                                                               */
-/*		This function sets the value of the GPIO_DIR bits from GPIO_DIRECTION registers for all 19 pins by providing a 32-bit value containing */
-/*		in its 19 bits the specified values.                                                                                                   */
-/*		Note that each GPIO_DIR bit can be accessed using the function SetRegisterBit(IOXP_GPIO_DIRECTION_GPIO_DIR(bGPIONo)), where	bGPIONo    */
-/*		is in the 1 - 19 range.                                                                                                                */
-/* ------------------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXP::WriteConfigRanges                                             */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		WriteConfigRanges(rgbImage, rgRanges, bCntRanges);              */
+/*	Parameters:                                                         */  
+/*		const uint8_t *rgbImage		- IOXP_CFG_IMAGE_SIZE values of the */
+/*									  registers IOXP_CFG_FIRST -        */
+/*									  IOXP_CFG_LAST                     */
+/*		const IOXPRange *rgRanges	- the ranges of rgbImage to write   */
+/*		uint8_t bCntRanges			- number of ranges                  */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or the first I2C error encountered        */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		See GetLastI2CStatus. The remaining ranges are not written.    */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Writes each range in one auto-increment burst, without any      */
+/*		comparison. Used by WriteConfig with the tables of IOXPImage,   */
+/*		which skip the registers left at their reset value, so the      */
+/*		device must be in its reset state; otherwise use                */
+/*		ApplyConfigImage(IOXPImage<Cfg>::rgbImage). The register shadow */
+/*		is then loaded with the whole image, so a later ApplyConfig     */
+/*		only writes the differences.                                    */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetGPIODirection(uint32_t dwBitMap)
+uint8_t IOXP::WriteConfigRanges(const uint8_t *rgbImage, const IOXPRange *rgRanges, uint8_t bCntRanges)
 {
-	WriteBytesI2C(IOXP_ADDR_GPIO_DIRECTION_A, 3, (uint8_t *)&dwBitMap);
+	uint8_t bStatus = IOXP_I2C_OK;
+	uint8_t bIdx;
+	for(bIdx = 0; bIdx < bCntRanges; bIdx++)
+	{
+		bStatus = WriteBytesI2C(rgRanges[bIdx].bFirst, rgRanges[bIdx].bCount, 
+			(uint8_t *)rgbImage + (rgRanges[bIdx].bFirst - IOXP_CFG_FIRST));
+		if(bStatus != IOXP_I2C_OK)
+		{
+			return bStatus;
+		}
+	}
+	if(!fBatch)
+	{
+		// the registers that were not written hold their image values
+		UpdateShadow(IOXP_CFG_FIRST, IOXP_CFG_IMAGE_SIZE, (uint8_t *)rgbImage);
+	}
+	return bStatus;
 }
 
-/* ----------------------------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::GetGPIODirection                                                                                                                   */
-/*                                                                                                                                           */
-/*	Synopsis:                                                                                                                                */
-/*		GetGPIODirection();                                                                                                                  */
-/*	Parameters:                                                                                                                              */  
-/*		void                                                                                                                                 */
-/*		                                                                                                                                     */
-/*  Return Value:                                                                                                                            */
-/*		uint32_t - the 32-bit value containing in its 19 LSbs the value of the GPIO_DIR bits, for each GPI pin. These bits are grouped in    */
-/*				   the three GPIO_DIRECTION 8-bit registers                                                                                  */
-/*                                                                                                                                           */
-/*                                                                                                                                           */
-/*	Errors:                                                                                                                                  */
-/*                                                                                                                                           */
-/*	Description:                                                                                                                             */
-/*		This function returns a value containing in its 19 LSbs the value of the GPIO_DIR bits, for each GPI pin. These bits are grouped     */
-/*		in the three GPIO_DIRECTION 8-bit registers.                                                                                         */
-/*		Note that each GPIO_DIR bit can be accessed using the function GetRegisterBit(IOXP_GPIO_DIRECTION_GPIO_DIR(bGPIONo)), where bGPIONo  */
-/*		is in the 1 - 19 range.                                                                                                              */
-/* ----------------------------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXPEventQueue::IOXPEventQueue                                      */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		IOXPEventQueue(rgEvtStorage, wCapacity);                        */
+/*	Parameters:                                                         */  
+/*		IOXPEvent *rgEvtStorage	- storage for wCapacity events          */
+/*		uint16_t wCapacity		- the capacity, a power of 2            */
+/*                                                                      */	                                                     
+/*	Description:                                                        */
+/*		Creates an empty queue. Used by IOXPEventRing, which checks the */
+/*		capacity at compile time.                                       */
+/* -------------------------------------------------------------------- */
 
-uint32_t IOXP::GetGPIODirection()
+IOXPEventQueue::IOXPEventQueue(IOXPEvent *rgEvtStorage, uint16_t wCapacity)
 {
-	uint32_t bResult = 0;
-	ReadBytesI2C(IOXP_ADDR_GPIO_DIRECTION_A, 3, (uint8_t *)&bResult);
-	return bResult;
+	rgEvt = rgEvtStorage;
+	wMask = wCapacity - 1;
+	wHead = 0;
+	wTail = 0;
+	ResetCounters();
 }
 
-/* -------------------------------------------------------------------------------------------- */
-/*	IOXP::SetResetCfgResetTriggerTime                                                           */
-/*                                                                                              */
-/*	Synopsis:                                                                                   */
-/*		SetResetCfgResetTriggerTime(uint8_t bResetTriggerTime);                                 */
-/*	Parameters:                                                                                 */  
-/*	 	uint8_t bResetTriggerTime	- the information to be set for RESET_TRIGGER_TIME bits     */
-/*					It can be one of the following time values:                                 */
-/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_IMMED		0	// Immediate                */
-/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_1D0SEC	1	// 1.0 sec                  */
-/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_1D5SEC	2	// 1.5 sec                  */
-/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_2D0SEC	3	// 2.0 sec                  */
-/*				IOXP_RESET_CFG_RESET_TRIGGER_TIME_2D5SEC	4	// 2.5 sec                      */
-/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_3D0SEC	5	// 3.0 sec                  */
-/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_3D5SEC	6	// 3.5 sec                  */
-/*					IOXP_RESET_CFG_RESET_TRIGGER_TIME_4D0SEC	7	// 4.0 sec                  */
-/*	                                                                                            */
-/*  Return Value:                                                                               */
-/*		void                                                                                    */
-/*                                                                                              */
-/*	Errors:                                                                                     */
-/*                                                                                              */
-/*	Description:                                                                                */
-/*		This function sets the RESET_TRIGGER_TIME information of the RESET_CFG register.        */
-/* -------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXPEventQueue::Push                                                */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		Push(evt);                                                      */
+/*	Parameters:                                                         */  
+/*		const IOXPEvent &evt	- the event to add                      */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		bool - false if the queue is full and the event was dropped     */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Producer side, only called by IOXP::Service. The event is       */
+/*		stored before the head index is published.                      */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetResetCfgResetTriggerTime(uint8_t bResetTriggerTime)
+bool IOXPEventQueue::Push(const IOXPEvent &evt)
 {
-	SetRegisterBitsGroup(IOXP_RESET_CFG_RESET_TRIGGER_TIME, bResetTriggerTime);	
+	uint16_t wIdx = wHead;
+	if((uint16_t)(wIdx - wTail) > wMask)
+	{
+		dwDropped++;
+		return false;
+	}
+	rgEvt[wIdx & wMask] = evt;
+	IOXP_COMPILER_BARRIER();
+	wHead = wIdx + 1;
+	return true;
 }
 
-/* ----------------------------------------------------------------------------------------- */
-/*	IOXP::GetResetCfgResetTriggerTime                                                        */
-/*                                                                                           */
-/*	Synopsis:                                                                                */
-/*		GetResetCfgResetTriggerTime();                                                       */
-/*	Parameters:                                                                              */  
-/*	 	void                                                                                 */
-/*		                                                                                     */
-/*  Return Value:                                                                            */
-/*		uint8_t -  the information read from RESET_TRIGGER_TIME bits                         */
-/* 					It can be one of the following time values:                              */
-/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_IMMED		0	// Immediate             */
-/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_1D0SEC	1	// 1.0 sec               */
-/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_1D5SEC	2	// 1.5 sec               */
-/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_2D0SEC	3	// 2.0 sec               */
-/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_2D5SEC	4	// 2.5 sec               */
-/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_3D0SEC	5	// 3.0 sec               */
-/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_3D5SEC	6	// 3.5 sec               */
-/* 					IOXP_RESET_CFG_RESET_TRIGGER_TIME_4D0SEC	7	// 4.0 sec               */
-/*                                                                                           */
-/*	Errors:                                                                                  */
-/*                                                                                           */
-/*	Description:                                                                             */
-/*		This function returns the RESET_TRIGGER_TIME information of the RESET_CFG register.  */
-/* ----------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXPEventQueue::Pop                                                 */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		Pop(evt);                                                       */
+/*	Parameters:                                                         */  
+/*		IOXPEvent &evt	- receives the oldest event                     */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		bool - false if the queue is empty                              */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Consumer side: removes the oldest event from the queue. The     */
+/*		slot is copied before the tail index releases it.               */
+/* -------------------------------------------------------------------- */
 
-uint8_t IOXP::GetResetCfgResetTriggerTime()
+bool IOXPEventQueue::Pop(IOXPEvent &evt)
 {
-	return GetRegisterBitsGroup(IOXP_RESET_CFG_RESET_PULSE_WIDTH);	
+	uint16_t wIdx = wTail;
+	if(wIdx == wHead)
+	{
+		return false;
+	}
+	IOXP_COMPILER_BARRIER();
+	evt = rgEvt[wIdx & wMask];
+	IOXP_COMPILER_BARRIER();
+	wTail = wIdx + 1;
+	return true;
 }
 
-/* --------------------------------------------------------------------------------------- */
-/*	IOXP::SetResetCfgResetPulseWidth                                                       */
-/*                                                                                         */
-/*	Synopsis:                                                                              */
-/*		SetResetCfgResetPulseWidth(uint8_t bResetPulseWidth);                              */
-/*	Parameters:                                                                            */  
-/*	 	uint8_t bResetPulseWidth	- the information to be set for RESET_PULSE_WIDTH bits */
-/*					It can be one of the following time values:                            */
-/*						IOXP_RESET_CFG_RESET_PULSE_WIDTH_500US		0	- 500 us           */
-/*                      IOXP_RESET_CFG_RESET_PULSE_WIDTH_1MS		1	- 1 ms             */
-/*                    	 IOXP_RESET_CFG_RESET_PULSE_WIDTH_2MS		2	- 2 ms             */
-/*                      IOXP_RESET_CFG_RESET_PULSE_WIDTH_10MS		3	- 10 ms            */
-/*		                                                                                   */
-/*  Return Value:                                                                          */
-/*		void                                                                               */
-/*                                                                                         */
-/*	Errors:                                                                                */
-/*                                                                                         */
-/*	Description:                                                                           */
-/*		This function sets the RESET_PULSE_WIDTH information of the RESET_CFG register.    */
-/* --------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXPEventQueue::GetCount                                            */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the number of events waiting in the queue.              */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetResetCfgResetPulseWidth(uint8_t bResetPulseWidth)
+uint16_t IOXPEventQueue::GetCount()
 {
-	SetRegisterBitsGroup(IOXP_RESET_CFG_RESET_PULSE_WIDTH, bResetPulseWidth);	
+	return (uint16_t)(wHead - wTail);
 }
 
-/* ------------------------------------------------------------------------------------------- */
-/*	IOXP::GetResetCfgResetPulseWidth                                                           */
-/*                                                                                             */
-/*	Synopsis:                                                                                  */
-/*		GetResetCfgResetPulseWidth(uint8_t bResetPulseWidth)                                   */
-/*	Parameters:                                                                                */  
-/*	 	 uint8_t bResetPulseWidth	- the information read from RESET_PULSE_WIDTH bits         */
-/*					It can be one of the following time values:                                */
-/*						IOXP_RESET_CFG_RESET_PULSE_WIDTH_500US		0	- 500 us               */
-/*                      IOXP_RESET_CFG_RESET_PULSE_WIDTH_1MS		1	- 1 ms                 */
-/*                      IOXP_RESET_CFG_RESET_PULSE_WIDTH_2MS		2	- 2 ms                 */
-/*                      IOXP_RESET_CFG_RESET_PULSE_WIDTH_10MS		3	- 10 ms		           */			
-/*                                                                                             */
-/*  Return Value:                                                                              */
-/*		  uint8_t - returns RESET_PULSE_WIDTH information of the RESET_CFG register            */
-/*                                                                                             */
-/*	Errors:                                                                                    */
-/*                                                                                             */
-/*	Description:                                                                               */
-/*		 This function returns the RESET_PULSE_WIDTH information of the RESET_CFG register.    */
-/* ------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXPEventQueue::GetCapacity                                         */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the number of events the queue can hold.                */
+/* -------------------------------------------------------------------- */
 
-uint8_t IOXP::GetResetCfgResetPulseWidth(uint8_t bResetPulseWidth)
+uint16_t IOXPEventQueue::GetCapacity()
 {
-	return GetRegisterBitsGroup(IOXP_RESET_CFG_RESET_PULSE_WIDTH);	
+	return wMask + 1;
 }
 
-/* -------------------------------------------------------------------------------------------------------------------- */
-/*	IOXP::SetPWMOffTimeUS                                                                                               */
-/*                                                                                                                      */
-/*	Synopsis:                                                                                                           */
-/*		 SetPWMOffTimeUS(uint16_t wOffTime);                                                                            */
-/*	Parameters:                                                                                                         */  
-/*	 	 uint16_t wOffTime	- the 16 bits value containing the off time (in us)                                         */
-/*                                                                                                                      */
-/*  Return Value:                                                                                                       */
-/*		  void                                                                                                          */
-/*                                                                                                                      */
-/*	Errors:                                                                                                             */
-/*                                                                                                                      */
-/*	Description:                                                                                                        */
-/*		This function sets the PWM off time (expressed in micro seconds) by providing a 16 bits value corresponding to  */
-/*		PWM_OFFT_LOW and PWM_OFFT_HIGH registers                                                                        */
-/* -------------------------------------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXPEventQueue::GetDropCount                                        */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the number of events dropped because the queue was full */
+/*		since the last ResetCounters.                                   */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetPWMOffTimeUS(uint16_t wOffTime)
+uint32_t IOXPEventQueue::GetDropCount()
 {
-	WriteBytesI2C(IOXP_ADDR_PWM_OFFT_LOW, 2, (uint8_t *)&wOffTime);
+	return dwDropped;
 }
 
-/* ------------------------------------------------------------------------------ */
-/*	IOXP::GetPWMOffTimeUS                                                         */
-/*                                                                                */
-/*	Synopsis:                                                                     */
-/*		GetPWMOffTimeUS();                                                        */       
-/*	Parameters:                                                                   */  
-/*		void                                                                      */
-/*		                                                                          */
-/*  Return Value:                                                                 */
-/*		uint16_t - the 16 bits value containing the off time (in us)              */
-/*                                                                                */
-/*                                                                                */
-/*	Errors:                                                                       */
-/*                                                                                */
-/*	Description:                                                                  */
-/*		This function returns the PWM off time (expressed in micro seconds) as a  */
-/*		16 bits value contained in PWM_OFFT_LOW and PWM_OFFT_HIGH registers.      */
-/* ------------------------------------------------------------------------------ */
-
+/* -------------------------------------------------------------------- */
+/*	IOXPEventQueue::GetOverflowCount                                    */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the number of device FIFO overflows (events lost inside */
+/*		the ADP5589) reported by OVERFLOW_INT since the last            */
+/*		ResetCounters.                                                  */
+/* -------------------------------------------------------------------- */
 
-uint16_t IOXP::GetPWMOffTimeUS()
+uint32_t IOXPEventQueue::GetOverflowCount()
 {
-	uint16_t wResult;
-	ReadBytesI2C(IOXP_ADDR_PWM_OFFT_LOW, 2, (uint8_t *)&wResult);
-	return wResult;
+	return dwOverflows;
 }
 
-/* -------------------------------------------------------------------------------------------------- */
-/*	IOXP::SetPWMOnTimeUS                                                                              */
-/*                                                                                                    */
-/*	Synopsis:                                                                                         */
-/*		SetPWMOnTimeUS(uint16_t wOnTime)                                                              */
-/*	Parameters:                                                                                       */  
-/*		uint16_t wOnTime	- the 16 bits value containing the on time (in us)                        */
-/*                                                                                                    */
-/*  Return Value:                                                                                     */
-/*		void                                                                                          */
-/*                                                                                                    */
-/*                                                                                                    */
-/*	Errors:                                                                                           */
-/*                                                                                                    */
-/*	Description:                                                                                      */
-/*		This function sets the PWM on time (expressed in micro seconds) by providing a 16 bits value  */
-/*		corresponding to PWM_ONT_LOW and PWM_ONT_HIGH registers                                       */
-/* -------------------------------------------------------------------------------------------------- */
-
+/* -------------------------------------------------------------------- */
+/*	IOXPEventQueue::ResetCounters                                       */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Clears the drop and overflow counters.                          */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetPWMOnTimeUS(uint16_t wOnTime)
+void IOXPEventQueue::ResetCounters()
 {
-	WriteBytesI2C(IOXP_ADDR_PWM_ONT_LOW, 2, (uint8_t *)&wOnTime);
+	dwDropped = 0;
+	dwOverflows = 0;
 }
 
-/* ----------------------------------------------------------------------------- */
-/*	IOXP::GetPWMOnTimeUS                                                         */
-/*                                                                               */
-/*	Synopsis:                                                                    */
-/*		GetPWMOnTimeUS()                                                         */
-/*	Parameters:                                                                  */  
-/*		void                                                                     */
-/*		                                                                         */
-/*  Return Value:                                                                */
-/*		uint16_t - the 16 bits value containing the on time (in us)              */
-/*                                                                               */
-/*	Errors:                                                                      */
-/*                                                                               */
-/*	Description:                                                                 */
-/*		This function returns the PWM on time (expressed in micro seconds)       */
-/*		as a 16 bits value contained in PWM_ONT_LOW and PWM_ONT_HIGH registers.  */
-/* ----------------------------------------------------------------------------- */
-
+/* -------------------------------------------------------------------- */
+/*	IOXPDispatchTable::IOXPDispatchTable                                */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Creates a table without handlers.                               */
+/* -------------------------------------------------------------------- */
 
-uint16_t IOXP::GetPWMOnTimeUS()
+IOXPDispatchTable::IOXPDispatchTable()
 {
-	uint16_t wResult;
-	ReadBytesI2C(IOXP_ADDR_PWM_ONT_LOW, 2, (uint8_t *)&wResult);
-	return wResult;
+	Clear();
 }
 
-/* --------------------------------------------------------------------------------------------- */
-/*	IOXP::SetClkDivClkDiv                                                                        */
-/*                                                                                               */
-/*	Synopsis:                                                                                    */
-/*		SetClkDivClkDiv(uint8_t bClkDiv);                                                        */
-/*	Parameters:                                                                                  */  
-/*		uint8_t bClkDiv	- the information to be set for CLK_DIV                                  */
-/*				It can be one of the following:                                                  */
-/*					IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV1		(0X00)	// divide by 1 (pass-through).   */
-/*                  IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV2		(0X01)	// divide by 2.                  */
-/*                  IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV3		(0X02)	// divide by 3.                  */
-/*                    IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV4		(0X03)	// divide by 4.              */
-/*					IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV32	(0X1F)	// divide by 32.                 */
-/*                                                                                               */
-/*  Return Value:                                                                                */
-/*		void                                                                                     */
-/*                                                                                               */
-/*	Errors:                                                                                      */
-/*                                                                                               */
-/*	Description:                                                                                 */
-/*		This function sets the CLK_DIV information of the CLOCK_DIV_CFG register.                */
-/* --------------------------------------------------------------------------------------------- */
-
+/* -------------------------------------------------------------------- */
+/*	IOXPDispatchTable::Clear                                            */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Removes all the handlers. The event enable bits written by      */
+/*		IOXP::OnGpi and OnLogic are left unchanged.                     */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetClkDivClkDiv(uint8_t bClkDiv)
+void IOXPDispatchTable::Clear()
 {
-	SetRegisterBitsGroup(IOXP_CLOCK_DIV_CFG_CLK_DIV, bClkDiv);	
+	memset(rgpfnHandler, 0, sizeof(rgpfnHandler));
+	memset(rgdwOnPress, 0, sizeof(rgdwOnPress));
+	memset(rgdwOnRelease, 0, sizeof(rgdwOnRelease));
 }
 
+/* -------------------------------------------------------------------- */
+/*	IOXPDispatchTable::Set                                              */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		Set(bEventId, pfnHandler, bStates);                             */
+/*	Parameters:                                                         */  
+/*		uint8_t bEventId	- the event identifier, 1 - 127             */
+/*		IOXPEventHandler pfnHandler	- the handler, NULL to remove it    */
+/*		uint8_t bStates		- IOXP_ON_PRESS and/or IOXP_ON_RELEASE      */
+/*                                                                      */	                                                     
+/*	Description:                                                        */
+/*		Stores the handler of the identifier and the states it is       */
+/*		called for. A NULL handler or no state clears the slot.         */
+/* -------------------------------------------------------------------- */
 
-/* ----------------------------------------------------------------------------------------------- */
-/*	IOXP::GetClkDivClkDiv                                                                          */
-/*                                                                                                 */
-/*	Synopsis:                                                                                      */
-/*		GetClkDivClkDiv()                                                                          */
-/*	Parameters:                                                                                    */  
-/*	 	 void                                                                                      */
-/*		                                                                                           */
-/*		 uint8_t -  the information read from CLK_DIV                                              */
-/*					It can be one of the following:                                                */
-/*					    IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV1		(0X00)	// divide by 1 (pass-through). */
-/*                      IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV2		(0X01)	// divide by 2.                */
-/*                      IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV3		(0X02)	// divide by 3.                */
-/*                      IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV4		(0X03)	// divide by 4.                */
-/*                      IOXP_CLOCK_DIV_CFG_CLK_DIV_DIV32	(0X1F)	// divide by 32.               */
-/*                                                                                                 */
-/*                                                                                                 */
-/*	Errors:                                                                                        */
-/*                                                                                                 */
-/*	Description:                                                                                   */
-/*		This function returns the CLK_DIV information of the CLOCK_DIV_CFG register.               */
-/* ----------------------------------------------------------------------------------------------- */
+void IOXPDispatchTable::Set(uint8_t bEventId, IOXPEventHandler pfnHandler, uint8_t bStates)
+{
+	uint32_t dwBit = (uint32_t)1 << (bEventId & 31);
+	uint8_t bWord = (bEventId & 0x7F) >> 5;
+	if(pfnHandler == NULL)
+	{
+		bStates = 0;
+	}
+	rgpfnHandler[bEventId & 0x7F] = (bStates & IOXP_ON_BOTH) ? pfnHandler : NULL;
+	if(bStates & IOXP_ON_PRESS)
+	{
+		rgdwOnPress[bWord] |= dwBit;
+	}
+	else
+	{
+		rgdwOnPress[bWord] &= ~dwBit;
+	}
+	if(bStates & IOXP_ON_RELEASE)
+	{
+		rgdwOnRelease[bWord] |= dwBit;
+	}
+	else
+	{
+		rgdwOnRelease[bWord] &= ~dwBit;
+	}
+}
 
+/* -------------------------------------------------------------------- */
+/*	IOXPDispatchTable::Dispatch                                         */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		Dispatch(evt);                                                  */
+/*	Parameters:                                                         */  
+/*		const IOXPEvent &evt	- the event                             */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		bool - true if a handler was called                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Calls the handler of the event identifier if it is subscribed   */
+/*		to the event state. Constant time: one bit test and one         */
+/*		indirect call, whatever the number of handlers.                 */
+/* -------------------------------------------------------------------- */
 
-uint8_t IOXP::GetClkDivClkDiv()
+bool IOXPDispatchTable::Dispatch(const IOXPEvent &evt)
 {
-	return GetRegisterBitsGroup(IOXP_CLOCK_DIV_CFG_CLK_DIV);
+	uint8_t bEventId = evt.bEvent & 0x7F;
+	const uint32_t *rgdwStates = (evt.bEvent & 0x80) ? rgdwOnPress : rgdwOnRelease;
+	if(!((rgdwStates[bEventId >> 5] >> (bEventId & 31)) & 1))
+	{
+		return false;
+	}
+	rgpfnHandler[bEventId](evt);
+	return true;
 }
 
+/* -------------------------------------------------------------------- */
+/*	IOXPGroup::IOXPGroup                                                */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Creates an empty group.                                         */
+/* -------------------------------------------------------------------- */
 
-/* ------------------------------------------------------------------------------ */
-/*	IOXP::SetLogicSel1                                                            */
-/*                                                                                */
-/*	Synopsis:                                                                     */
-/*		SetLogicSel1(uint8_t bLogicSel)                                           */
-/*	Parameters:                                                                   */  
-/*		uint8_t bLogicSel - the information to be set for LOGIC1_SEL              */
-/*			It can be one of the following:                                       */
-/*				IOXP_LOGIC_CFG_LOGIC_SEL_OFF		(0x00)	// off/disable        */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_AND		(0x01)	// AND                */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_OR			(0x02)	// OR                 */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_XOR		(0x03)	// XOR                */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_FF			(0x04)	// FF                 */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_IN_LA		(0x05)	// IN_LA              */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_IN_LB		(0x06)	// IN_LB              */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_IN_LC		(0x07)	// IN_LC              */
-/*                                                                                */
-/*  Return Value:                                                                 */
-/*		void                                                                      */
-/*                                                                                */
-/*	Errors:                                                                       */
-/*                                                                                */
-/*	Description:                                                                  */
-/*		This function sets the LOGIC1_SEL information of the LOGIC1_CFG register. */
-/* ------------------------------------------------------------------------------ */
+IOXPGroup::IOXPGroup()
+{
+	bCntDev = 0;
+	pEvtQueue = NULL;
+	fIntPending = false;
+	dwIntTimeUS = 0;
+	ResetServiceStats();
+}
+
+/* -------------------------------------------------------------------- */
+/*	IOXPGroup::AddDevice                                                */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		AddDevice(pDevice);                                             */
+/*	Parameters:                                                         */  
+/*		IOXP *pDevice	- a device whose INT pin is connected to the    */
+/*						  shared interrupt line                         */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - the device index, stored in IOXPEvent::bDevice, or    */
+/*				  0xFF if the group already has IOXP_GROUP_MAX_DEVICES  */
+/*                                                                      */
+/*	Errors:                                                             */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Adds a device to the group, at the end of the scan order.       */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetLogicSel1(uint8_t bLogicSel)
+uint8_t IOXPGroup::AddDevice(IOXP *pDevice)
 {
-	SetRegisterBitsGroup(IOXP_LOGIC_1_CFG_LOGIC1_SEL, bLogicSel);	
+	if(bCntDev >= IOXP_GROUP_MAX_DEVICES)
+	{
+		return 0xFF;
+	}
+	rgpDev[bCntDev] = pDevice;
+	rgbScanOrder[bCntDev] = bCntDev;
+	return bCntDev++;
 }
 
-/* ----------------------------------------------------------------------------------- */
-/*	IOXP::GetLogicSel1                                                                 */
-/*                                                                                     */
-/*	Synopsis:                                                                          */
-/*		  GetLogicSel1();                                                              */
-/*	Parameters:                                                                        */  
-/*	 	  void                                                                         */
-/*		                                                                               */
-/*  Return Value:                                                                      */
-/*		uint8_t -  the information read from LOGIC1_SEL                                */
-/*			It can be one of the following:                                            */
-/*				IOXP_LOGIC_CFG_LOGIC_SEL_OFF		(0x00)	// off/disable             */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_AND		(0x01)	// AND                     */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_OR			(0x02)	// OR                      */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_XOR		(0x03)	// XOR                     */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_FF			(0x04)	// FF                      */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_IN_LA		(0x05)	// IN_LA                   */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_IN_LB		(0x06)	// IN_LB                   */
-/*              IOXP_LOGIC_CFG_LOGIC_SEL_IN_LC		(0x07)	// IN_LC                   */
-/*                                                                                     */
-/*                                                                                     */
-/*	Errors:                                                                            */
-/*                                                                                     */
-/*	Description:                                                                       */
-/*		  This function returns the LOGIC1_SEL information of the LOGIC1_CFG register. */
-/* ----------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXPGroup::SetScanOrder                                             */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		SetScanOrder(rgbOrder);                                         */
+/*	Parameters:                                                         */  
+/*		const uint8_t *rgbOrder	- the indexes of all the devices, in    */
+/*								  the order they are serviced           */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - IOXP_I2C_OK or IOXP_ERR_PARAM                         */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		IOXP_ERR_PARAM if rgbOrder is not a permutation of the device   */
+/*		indexes (an index out of range or given twice); the scan order  */
+/*		is then left unchanged.                                         */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Devices that must be serviced with the lowest latency go first. */
+/*		rgbOrder must have one entry per device of the group, so that   */
+/*		every device is scanned exactly once by Service.                */
+/* -------------------------------------------------------------------- */
 
-uint8_t IOXP::GetLogicSel1()
+uint8_t IOXPGroup::SetScanOrder(const uint8_t *rgbOrder)
 {
-	return GetRegisterBitsGroup(IOXP_LOGIC_1_CFG_LOGIC1_SEL);
+	uint8_t bSeen = 0;		// one bit per device index
+	uint8_t bIdx;
+	for(bIdx = 0; bIdx < bCntDev; bIdx++)
+	{
+		if(rgbOrder[bIdx] >= bCntDev || (bSeen & (1 << rgbOrder[bIdx])) != 0)
+		{
+			return IOXP_ERR_PARAM;
+		}
+		bSeen |= (uint8_t)(1 << rgbOrder[bIdx]);
+	}
+	for(bIdx = 0; bIdx < bCntDev; bIdx++)
+	{
+		rgbScanOrder[bIdx] = rgbOrder[bIdx];
+	}
+	return IOXP_I2C_OK;
 }
 
-/* ------------------------------------------------------------------------------ */
-/*	IOXP::SetLogicSel2                                                            */
-/*                                                                                */
-/*	Synopsis:                                                                     */
-/*		SetLogicSel2(uint8_t bLogicSel);                                          */
-/*	Parameters:                                                                   */  
-/*		uint8_t bLogicSel - the information to be set for LOGIC2_SEL              */
-/*				It can be one of the following:                                   */
-/*					IOXP_LOGIC_CFG_LOGIC_SEL_OFF		(0x00)	// off/disable    */
-/*                  IOXP_LOGIC_CFG_LOGIC_SEL_AND		(0x01)	// AND            */
-/*                  IOXP_LOGIC_CFG_LOGIC_SEL_OR			(0x02)	// OR             */
-/*                  IOXP_LOGIC_CFG_LOGIC_SEL_XOR		(0x03)	// XOR            */
-/*                 IOXP_LOGIC_CFG_LOGIC_SEL_FF			(0x04)	// FF             */
-/*                  IOXP_LOGIC_CFG_LOGIC_SEL_IN_LA		(0x05)	// IN_LA          */
-/*                  IOXP_LOGIC_CFG_LOGIC_SEL_IN_LB		(0x06)	// IN_LB          */
-/*                  IOXP_LOGIC_CFG_LOGIC_SEL_IN_LC		(0x07)	// IN_LC          */
-/*                                                                                */
-/*  Return Value:                                                                 */
-/*		void                                                                      */
-/*                                                                                */
-/*	Errors:                                                                       */
-/*                                                                                */
-/*	Description:                                                                  */
-/*		This function sets the LOGIC2_SEL information of the LOGIC2_CFG register. */
-/* ------------------------------------------------------------------------------ */
+/* -------------------------------------------------------------------- */
+/*	IOXPGroup::GetDeviceCount                                           */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the number of devices in the group.                     */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetLogicSel2(uint8_t bLogicSel)
+uint8_t IOXPGroup::GetDeviceCount()
 {
-	SetRegisterBitsGroup(IOXP_LOGIC_2_CFG_LOGIC2_SEL, bLogicSel);	
+	return bCntDev;
 }
 
-/* ----------------------------------------------------------------------------------- */
-/*	IOXP::GetLogicSel2                                                                 */
-/*                                                                                     */
-/*	Synopsis:                                                                          */
-/*		GetLogicSel2();                                                                */
-/*	Parameters:                                                                        */  
-/*	 	void                                                                           */
-/*		                                                                               */
-/*  Return Value:                                                                      */
-/*		uint8_t -  the information read from LOGIC2_SEL                                */
-/*				It can be one of the following:                                        */
-/*		    		IOXP_LOGIC_CFG_LOGIC_SEL_OFF		(0x00)	// off/disable         */
-/*                  IOXP_LOGIC_CFG_LOGIC_SEL_AND		(0x01)	// AND                 */
-/*                  IOXP_LOGIC_CFG_LOGIC_SEL_OR			(0x02)	// OR                  */
-/*                  IOXP_LOGIC_CFG_LOGIC_SEL_XOR		(0x03)	// XOR                 */
-/*                  IOXP_LOGIC_CFG_LOGIC_SEL_FF			(0x04)	// FF                  */
-/*                  IOXP_LOGIC_CFG_LOGIC_SEL_IN_LA		(0x05)	// IN_LA               */
-/*                   IOXP_LOGIC_CFG_LOGIC_SEL_IN_LB		(0x06)	// IN_LB               */
-/*                  IOXP_LOGIC_CFG_LOGIC_SEL_IN_LC		(0x07)	// IN_LC               */
-/*                                                                                     */
-/*	Errors:                                                                            */
-/*                                                                                     */
-/*	Description:                                                                       */
-/*		This function returns the LOGIC2_SEL information of the LOGIC2_CFG register.   */
-/* ----------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXPGroup::ConfigureEventQueue                                      */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		ConfigureEventQueue(bParExtIntNo, wEventMask, pQueue);          */
+/*	Parameters:                                                         */  
+/*		uint8_t bParExtIntNo	- the external interrupt number (0-4)   */
+/*								  of the shared INT line                */
+/*		uint16_t wEventMask		- the interrupts to enable on every     */
+/*								  device, see IOXP::ConfigureInterrupt  */
+/*		IOXPEventQueue *pQueue	- the queue receiving the events of all */
+/*								  the devices                           */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		void                                                            */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		Nothing is done if bParExtIntNo is larger than 4.               */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Same as IOXP::ConfigureEventQueue, for all the devices of the   */
+/*		group, which must have been added before.                      */
+/* -------------------------------------------------------------------- */
 
-uint8_t IOXP::GetLogicSel2()
+void IOXPGroup::ConfigureEventQueue(uint8_t bParExtIntNo, uint16_t wEventMask, IOXPEventQueue *pQueue)
 {
-	return GetRegisterBitsGroup(IOXP_LOGIC_2_CFG_LOGIC2_SEL);
+	if(bParExtIntNo >= IOXP_EXT_INT_CNT)
+	{
+		return;
+	}
+	pEvtQueue = pQueue;
+	for(uint8_t bIdx = 0; bIdx < bCntDev; bIdx++)
+	{
+		rgpDev[bIdx]->EnableEventInterrupts(wEventMask);
+	}
+	dwIntTimeUS = micros() - IOXP_NO_EDGE_AGE_US;
+	fIntPending = true;
+	IOXP::AttachIntFlag(bParExtIntNo, &fIntPending, &dwIntTimeUS);
 }
 
-/* ---------------------------------------------------------------------------------- */
-/* 	IOXP::SetPollTime                                                                 */
-/*                                                                                    */
-/*	Synopsis:                                                                         */
-/*		SetPollTime(uint8_t bPollTime)                                                */
-/*	Parameters:                                                                       */  
-/*	 	 uint8_t bPollTime	- the information to be set for POLL_TIME bits.           */
-/*				It can be one of the following time values::                          */
-/*					IOXP_POLL_TIME_CFG_KEY_POLL_TIME_10MS	(0x00)	- 10 ms           */
-/*					IOXP_POLL_TIME_CFG_KEY_POLL_TIME_20MS	(0x01)	- 20 ms           */
-/*					IOXP_POLL_TIME_CFG_KEY_POLL_TIME_30MS	(0x02)	- 30 ms           */
-/*					IOXP_POLL_TIME_CFG_KEY_POLL_TIME_40MS	(0x03)	- 40 ms           */                       
-/*		                                                                              */
-/*  Return Value:                                                                     */
-/*		 void                                                                         */
-/*                                                                                    */
-/*	Errors:                                                                           */
-/*                                                                                    */
-/*	Description:                                                                      */
-/*		 This function sets the POLL_TIME information of the POLL_TIME_CFG register.  */
-/* ---------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXPGroup::Service                                                  */
+/*                                                                      */
+/*	Synopsis:                                                           */
+/*		Service();                                                      */
+/*	Parameters:                                                         */  
+/*		bool fPoll	- true to scan the devices even if no interrupt is  */
+/*					  pending                                           */
+/*                                                                      */	                                                     
+/*  Return Value:                                                       */
+/*		uint8_t - the number of events read from all the devices        */
+/*                                                                      */
+/*	Errors:                                                             */
+/*		On an I2C error the group stays pending.                        */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Does nothing unless the shared INT line had a falling edge      */
+/*		since the last call, or fPoll is true. Otherwise each device,   */
+/*		in scan order, gets one burst read of INT_STATUS and STATUS;    */
+/*		only the devices with events get their FIFO read, and only the  */
+/*		devices with a set INT_STATUS bit get it acknowledged. The      */
+/*		events of all the devices go to the same queue, tagged with the */
+/*		device index (IOXPEvent::bDevice).                              */
+/*		A device can assert the line while it is still held low by      */
+/*		another one, which gives no new edge, so after a pass that      */
+/*		found anything the group stays pending for one more pass.       */
+/*		The duration of the pass is recorded, see GetMaxServiceTimeUS.  */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetPollTime(uint8_t bPollTime)
+uint8_t IOXPGroup::Service(bool fPoll)
 {
-	SetRegisterBitsGroup(IOXP_POLL_TIME_CFG_KEY_POLL_TIME, bPollTime);	
+	uint8_t bCntTotal = 0;
+	bool fActive = false;
+	if(!fIntPending && !fPoll)
+	{
+		return 0;
+	}
+	uint32_t dwStartUS = micros();
+	// the edge may come from any device: it only bounds the event times
+	uint32_t dwEdgeUS = fIntPending ? dwIntTimeUS : dwStartUS - IOXP_NO_EDGE_AGE_US;
+	fIntPending = false;
+	for(uint8_t bIdx = 0; bIdx < bCntDev; bIdx++)
+	{
+		uint8_t bDevice = rgbScanOrder[bIdx];
+		IOXP *pDev = rgpDev[bDevice];
+		uint8_t bCntEvents;
+		uint8_t bStatus = pDev->ServiceDevice(pEvtQueue, bDevice, 0, bCntEvents, dwEdgeUS, false);
+		if(bStatus != IOXP_I2C_OK || bCntEvents != 0 || pDev->bLastIntStatus != 0)
+		{
+			fActive = true;
+		}
+		bCntTotal += bCntEvents;
+	}
+	if(fActive)
+	{
+		fIntPending = true;
+	}
+	dwLastServiceUS = micros() - dwStartUS;
+	if(dwLastServiceUS > dwMaxServiceUS)
+	{
+		dwMaxServiceUS = dwLastServiceUS;
+	}
+	return bCntTotal;
 }
 
-/* ----------------------------------------------------------------------------------- */
-/*	IOXP::GetPollTime                                                                  */
-/*                                                                                     */
-/*	Synopsis:                                                                          */
-/*		GetPollTime();                                                                 */
-/*	Parameters:                                                                        */  
-/*		void                                                                           */
-/*		                                                                               */
-/*  Return Value:                                                                      */
-/*		uint8_t -  the information read from POLL_TIME bits                            */
-/*                                                                                     */
-/*                                                                                     */
-/*	Errors:                                                                            */
-/*                                                                                     */
-/*	Description:                                                                       */
-/*		This function returns the POLL_TIME information of the POLL_TIME_CFG register. */
-/* ----------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXPGroup::GetMaxServiceTimeUS                                      */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the longest Service pass, in microseconds, since the    */
+/*		last ResetServiceStats. It grows with the number of devices     */
+/*		(one INT_STATUS/STATUS burst each, 480 us at 100 kHz and 120 us */
+/*		at 400 kHz) and with the events drained; extras/host/           */
+/*		GroupLatency prints it for 1 to IOXP_GROUP_MAX_DEVICES devices. */
+/* -------------------------------------------------------------------- */
 
-uint8_t IOXP::GetPollTime()
+uint32_t IOXPGroup::GetMaxServiceTimeUS()
 {
-	return GetRegisterBitsGroup(IOXP_POLL_TIME_CFG_KEY_POLL_TIME);
+	return dwMaxServiceUS;
 }
 
-/* ----------------------------------------------------------------------------------- */
-/*	IOXP::SetCoreFreq                                                                  */
-/*                                                                                     */
-/*	Synopsis:                                                                          */
-/*		SetCoreFreq(uint8_t bCoreFreq);                                                */
-/*	Parameters:                                                                        */  
-/*		uint8_t bCoreFreq	- the information to be set for CORE_FREQ bits             */
-/*			It can be one of the following:                                            */
-/*				IOXP_GENERAL_CFG_B_CORE_FREQ_50K		(0x00)	-  50 kHz              */
-/*				IOXP_GENERAL_CFG_B_CORE_FREQ_100K		(0x01)	- 100 kHz              */
-/*				IOXP_GENERAL_CFG_B_CORE_FREQ_200K		(0x02)	- 200 kHz              */
-/*				IOXP_GENERAL_CFG_B_CORE_FREQ_500K	    (0x03)	- 500 kHz              */
-/*                                                                                     */
-/*  Return Value:                                                                      */
-/*		  void                                                                         */
-/*                                                                                     */
-/*	Errors:                                                                            */
-/*                                                                                     */
-/*	Description:                                                                       */
-/*		 This function sets the CORE_FREQ information of the GENERAL_CFG_B register.   */
-/* ----------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXPGroup::GetLastServiceTimeUS                                     */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Returns the duration of the last Service pass, in microseconds. */
+/* -------------------------------------------------------------------- */
 
-void IOXP::SetCoreFreq(uint8_t bCoreFreq)
+uint32_t IOXPGroup::GetLastServiceTimeUS()
 {
-	SetRegisterBitsGroup(IOXP_GENERAL_CFG_B_CORE_FREQ, bCoreFreq);	
+	return dwLastServiceUS;
 }
 
-/* ------------------------------------------------------------------------------------- */
-/*	IOXP::GetCoreFreq                                                                    */
-/*                                                                                       */
-/*	Synopsis:                                                                            */
-/*		GetCoreFreq();                                                                   */
-/*	Parameters:                                                                          */  
-/*	 	  void                                                                           */
-/*		                                                                                 */
-/*  Return Value:                                                                        */ 
-/*		  uint8_t - the information read from CORE_FREQ bits.                            */
-/*				It can be one of the following:                                          */
-/*					IOXP_GENERAL_CFG_B_CORE_FREQ_50K		(0x00)	-  50 kHz            */
-/*					IOXP_GENERAL_CFG_B_CORE_FREQ_100K		(0x01)	- 100 kHz            */
-/*					IOXP_GENERAL_CFG_B_CORE_FREQ_200K		(0x02)	- 200 kHz            */
-/*					IOXP_GENERAL_CFG_B_CORE_FREQ_500K		(0x03)	- 500 kHz            */
-/*                                                                                       */
-/*                                                                                       */
-/*	Errors:                                                                              */
-/*                                                                                       */
-/*	Description:                                                                         */
-/*		 This function returns the CORE_FREQ information of the GENERAL_CFG_B register.  */
-/* ------------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------- */
+/*	IOXPGroup::ResetServiceStats                                        */
+/*                                                                      */
+/*	Description:                                                        */
+/*		Clears the service time statistics.                             */
+/* -------------------------------------------------------------------- */
 
-uint8_t IOXP::GetCoreFreq()
+void IOXPGroup::ResetServiceStats()
 {
-	return GetRegisterBitsGroup(IOXP_GENERAL_CFG_B_CORE_FREQ);
+	dwMaxServiceUS = 0;
+	dwLastServiceUS = 0;
 }
-
-/* ---------------------------------------------------------------------------------------------- */
-/*	IOXP::SetKeyMap                                                                               */
-/*                                                                                                */
-/*	Synopsis:                                                                                     */
-/*		SetKeyMap(int table[IOXP_KB_ROWS][IOXP_KB_COLS]);                                         */
-/*	Parameters:                                                                                   */  
-/*		int table[IOXP_KB_ROWS][IOXP_KB_COLS]	- the table containing key mappings               */
-/*						                                                                          */
-/*  Return Value:                                                                                 */
-/*		void                                                                                      */
-/*                                                                                                */
-/*	Errors:                                                                                       */
-/*                                                                                                */
-/*	Description:                                                                                  */
-/*		This function sets the value for keys using the values from specified table.              */
-/*		Mapping values on keys is optional, user may use keys just by specifying row and column.  */
-/* ---------------------------------------------------------------------------------------------- */
-
-void IOXP::SetKeyMap(int table[IOXP_KB_ROWS][IOXP_KB_COLS])
-{  
-	for(int idxRows = 0 ; idxRows < IOXP_KB_ROWS ; idxRows++)       
-	{
-		for(int idxCols = 0 ; idxCols < IOXP_KB_COLS ; idxCols++)        
-		{
-			this->keyMap[idxRows][idxCols] = table[idxRows][idxCols];
-		}
-	}   
-}
\ No newline at end of file
@@ -50,14 +50,23 @@
 /* -------------------------------------------------------------------- */
 #include <inttypes.h>
 #include <WProgram.h>
+
+class TwoWire;	// Wire library, included by the sketch
+
 /* -------------------------------------------------------------------- */
 /*					Definitions									        */
 /* -------------------------------------------------------------------- */
-#define IOXP_I2C_ADDR		0x34	// ADP5589 IIC Address
+// Define IOXP_PROFILE (here or on the compiler command line) to collect per register I2C
+// traffic statistics, see IOXP::GetStats. The profiler is compiled out by default.
+//#define IOXP_PROFILE
+
+#define IOXP_I2C_ADDR		0x34	// ADP5589 IIC Address, default value of the IOXP constructor
 #define IOXP_KB_ROWS		8
 #define IOXP_KB_COLS		11
-#define IOXP_GPIOS			IOXP_KB_ROWS + IOXP_KB_COLS
+#define IOXP_GPIOS			(IOXP_KB_ROWS + IOXP_KB_COLS)
 #define IOXP_NO_LOGIC		2
+#define IOXP_NO_REGS		0x4F	// number of ADP5589 registers (0x00 - 0x4E)
+#define IOXP_FIFO_DEPTH		16		// number of event FIFO registers (FIFO1 - FIFO16)
 
 
 /* -------------------------------------------------------------------- */
@@ -145,14 +154,37 @@
 #define IOXP_ADDR_GENERAL_CFG_B      0x4D     
 #define IOXP_ADDR_INT_EN            	0x4E 
 
+// Volatile registers (INT_STATUS, STATUS, FIFO, GPI_INT_STATUS, GPI_STATUS) are changed by the device
+// itself, so they are never served from the register cache.
+#define IOXP_ADDR_VOLATILE_FIRST	IOXP_ADDR_INT_STATUS
+#define IOXP_ADDR_VOLATILE_LAST		IOXP_ADDR_GPI_STATUS_C
+#define IOXP_IS_ADDR_CACHEABLE(a)	(((a) < IOXP_ADDR_VOLATILE_FIRST || (a) > IOXP_ADDR_VOLATILE_LAST) && (a) < IOXP_NO_REGS)
+
+// number of external interrupts (INT0 - INT4) that ConfigureEventQueue can use
+#define IOXP_EXT_INT_CNT			5
+// FIFO entries read by Service in the same burst as INT_STATUS and STATUS; the rest, if any,
+// are read with a second burst
+#define IOXP_SERVICE_PREFETCH		4
+// maximum number of devices of an IOXPGroup, at most 8 (one bit per device in SetScanOrder)
+#define IOXP_GROUP_MAX_DEVICES		8
+
+// Longest run of unchanged, cached registers that CommitBatch rewrites to join two write bursts:
+// two data bytes cost less bus time than a new transaction (START, two address bytes, STOP).
+#define IOXP_BATCH_MAX_GAP			2
+
+// configuration registers covered by IOXPConfig and IOXP::ApplyConfig (RPULL_CONFIG_A - INT_EN)
+#define IOXP_CFG_FIRST				IOXP_ADDR_RPULL_CONFIG_A
+#define IOXP_CFG_LAST				IOXP_ADDR_INT_EN
+#define IOXP_CFG_IMAGE_SIZE			(IOXP_CFG_LAST - IOXP_CFG_FIRST + 1)
+
 /* -------------------------------------------------------------------- */
 /*		Register Bit Mask Definitions - single bits				        */
 /* -------------------------------------------------------------------- */
 
-#define div8(a) (a >> 3)
-#define mod8(a) (a - (div8(a) << 3))
-#define div4(a) (a >> 2)
-#define mod4(a) (a - (div4(a) << 2))
+#define div8(a) ((a) >> 3)
+#define mod8(a) ((a) - (div8(a) << 3))
+#define div4(a) ((a) >> 2)
+#define mod4(a) ((a) - (div4(a) << 2))
 
 #define IOXP_INT_STATUS_EVENT_INT   		(0x0101)	// EVENT_INT bit of the INT_STATUS register
 #define IOXP_INT_STATUS_GPI_INT     		(0x0102)	// GPI_INT bit of the INT_STATUS register
@@ -163,9 +195,9 @@
 #define IOXP_STATUS_LOCK_STAT  				(0x0220)	// LOCK_STAT bit of the Status register
 #define IOXP_STATUS_LOGIC1_STAT  			(0x0240)	// LOGIC1_STAT bit of the Status register
 #define IOXP_STATUS_LOGIC2_STAT  	 		(0x0280)	// LOGIC2_STAT bit of the Status register
-#define IOXP_UNLOCK1_UNLOCK1_STATE	  		(0x3340)	// UNLOCK1_STATE bit of the UNLOCK1 register
-#define IOXP_UNLOCK2_UNLOCK2_STATE	  		(0x3440)	// UNLOCK2_STATE bit of the UNLOCK2 register
-#define IOXP_EXT_LOCK_EVENT_EXT_LOCK_STATE	(0x3540)	// EXT_LOCK_STATE bit of the EXT_LOCK register
+#define IOXP_UNLOCK1_UNLOCK1_STATE	  		(0x3380)	// UNLOCK1_STATE bit of the UNLOCK1 register
+#define IOXP_UNLOCK2_UNLOCK2_STATE	  		(0x3480)	// UNLOCK2_STATE bit of the UNLOCK2 register
+#define IOXP_EXT_LOCK_EVENT_EXT_LOCK_STATE	(0x3580)	// EXT_LOCK_STATE bit of the EXT_LOCK register
 #define IOXP_LOCK_CFG_LOCK_EN	  			(0x3701)	// LOCK_EN bit of the LOCK_CFG register			
 #define IOXP_RESET1_EVENT_A_RESET1_EVENT_A_LEVEL	(0x3880)	// RESET1_EVENT_A_LEVEL bit of the RESET1_EVENT_A register	
 #define IOXP_RESET1_EVENT_B_RESET1_EVENT_B_LEVEL	(0x3980)	// RESET1_EVENT_B_LEVEL bit of the RESET1_EVENT_B register
@@ -188,7 +220,7 @@
 #define IOXP_LOGIC_2_LB2_INV				(0x4510)	// LB2_INV bit of the LOGIC_2 register
 #define IOXP_LOGIC_2_LC2_INV				(0x4520)	// LC2_INV bit of the LOGIC_2 register
 #define IOXP_LOGIC_2_LY2_INV				(0x4540)	// LY2_INV bit of the LOGIC_2 register
-#define IOXP_LOGIC_2_LY1_CASCADE			(0x4540)	// LY1_CASCADE bit of the LOGIC_2 register
+#define IOXP_LOGIC_2_LY1_CASCADE			(0x4580)	// LY1_CASCADE bit of the LOGIC_2 register
 #define IOXP_LOGIC_FF_CFG_FF1_CLR			(0x4601)	// FF1_CLR bit of the LOGIC_FF_CFG register
 #define IOXP_LOGIC_FF_CFG_FF1_SET			(0x4602)	// FF1_SET bit of the LOGIC_FF_CFG register
 #define IOXP_LOGIC_FF_CFG_FF2_CLR			(0x4604)	// FF2_CLR bit of the LOGIC_FF_CFG register
@@ -223,7 +255,7 @@
 #define IOXP_GPI_EVENT_EN_GPI_EVENT_EN(x)	((((0x21 + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	// GPI_EVENT_EN bit of the GPI_EVENT_EN registers corresponding to GPIO no x (x between 1 and 19)
 #define IOXP_GPI_INT_STAT_GPI_INT(x)		((((0x13 + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	// GPI_INT bit of the GPI_INT_STAT registers corresponding to GPIO no x  (x between 1 and 19)
 #define IOXP_GPI_STATUS_GPI_STAT(x)		 	((((0x16 + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	// GPI_STAT bit of the GPI_STATUS registers corresponding to GPIO no x  (x between 1 and 19)
-#define IOXP_INT_LEVEL_GPI_INT_LEVEL(x)		((((0x38 + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	// GPI_INT_LEVEL bit of GPI_INT_LEVEL registers corresponding to GPIO no x  (x between 1 and 19)
+#define IOXP_INT_LEVEL_GPI_INT_LEVEL(x)		((((0x1E + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	// GPI_INT_LEVEL bit of GPI_INT_LEVEL registers corresponding to GPIO no x  (x between 1 and 19)
 #define IOXP_DEBOUNCE_DIS_GPI_DEB_DIS(x)	((((0x27 + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	// GPI_DEB_DIS bit of the DEBOUNCE_DIS registers corresponding to GPIO no x  (x between 1 and 19)
 #define IOXP_GPO_DATA_OUT_GPO_DATA(x)		((((0x2A + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	// GPO_DATA bit of the GPO_DATA_OUT registers corresponding to GPIO no x  (x between 1 and 19)
 #define IOXP_GPO_OUT_MODE_GPO_OUT_MODE(x)	((((0x2D + div8(x - 1))) << 8) | (1 << mod8(x - 1)))	// GPO_OUT_MODE bit of the GPO_OUT_MODE registers corresponding to GPIO no x (x between 1 and 19)
@@ -234,17 +266,17 @@
 #define IOXP_ID_MAN_ID  					(0x00F0)	// MAN_ID[3:0] field of the ID register
 #define IOXP_ID_REV_ID  					(0x000F)	// REV_ID[3:0] field of the ID register
 #define IOXP_INT_STATUS_ALL   				(0x01FF)	// all bits [7:0] of INT_STATUS register 
-#define IOXP_STATUS_EC  					(0x020F)	// EC[4:0] field of the Status register
-#define IOXP_UNLOCK1_UNLOCK1  				(0x333F)	// UNLOCK1[6:0] field of the UNLOCK1 register
-#define IOXP_UNLOCK2_UNLOCK2  				(0x343F)	// UNLOCK2[6:0] field of the UNLOCK2 register
-#define IOXP_EXT_LOCK_EVENT_EXT_LOCK_EVENT	(0x353F)	// EXT_LOCK_EVENT[6:0] field of the EXT_LOCK_EVENT register			
-#define IOXP_UNLOCK_TIMERS_INT_MASK_TIMER  	(0x36F0)	// INT_MASK_TIMER[4:0] field of the UNLOCK_TIMERS register
-#define IOXP_UNLOCK_TIMERS_UNLOCK_TIMER  	(0x360F)	// UNLOCK_TIMER[2:0] field of the UNLOCK_TIMERS register
-#define IOXP_RESET1_EVENT_A_RESET1_EVENT_A  (0x383F)	// RESET1_EVENT_A[6:0] field of the RESET1_EVENT_A register
-#define IOXP_RESET1_EVENT_B_RESET1_EVENT_B  (0x393F)	// RESET1_EVENT_B[6:0] field of the RESET1_EVENT_B register
-#define IOXP_RESET1_EVENT_C_RESET1_EVENT_C  (0x3A3F)	// RESET1_EVENT_C[6:0] field of the RESET1_EVENT_C register
-#define IOXP_RESET2_EVENT_A_RESET2_EVENT_A  (0x3B3F)	// RESET2_EVENT_A[6:0] field of the RESET2_EVENT_A register
-#define IOXP_RESET2_EVENT_B_RESET2_EVENT_B  (0x3C3F)	// RESET2_EVENT_B[6:0] field of the RESET2_EVENT_B register			
+#define IOXP_STATUS_EC  					(0x021F)	// EC[4:0] field of the Status register
+#define IOXP_UNLOCK1_UNLOCK1  				(0x337F)	// UNLOCK1[6:0] field of the UNLOCK1 register
+#define IOXP_UNLOCK2_UNLOCK2  				(0x347F)	// UNLOCK2[6:0] field of the UNLOCK2 register
+#define IOXP_EXT_LOCK_EVENT_EXT_LOCK_EVENT	(0x357F)	// EXT_LOCK_EVENT[6:0] field of the EXT_LOCK_EVENT register			
+#define IOXP_UNLOCK_TIMERS_INT_MASK_TIMER  	(0x36F8)	// INT_MASK_TIMER[4:0] field of the UNLOCK_TIMERS register
+#define IOXP_UNLOCK_TIMERS_UNLOCK_TIMER  	(0x3607)	// UNLOCK_TIMER[2:0] field of the UNLOCK_TIMERS register
+#define IOXP_RESET1_EVENT_A_RESET1_EVENT_A  (0x387F)	// RESET1_EVENT_A[6:0] field of the RESET1_EVENT_A register
+#define IOXP_RESET1_EVENT_B_RESET1_EVENT_B  (0x397F)	// RESET1_EVENT_B[6:0] field of the RESET1_EVENT_B register
+#define IOXP_RESET1_EVENT_C_RESET1_EVENT_C  (0x3A7F)	// RESET1_EVENT_C[6:0] field of the RESET1_EVENT_C register
+#define IOXP_RESET2_EVENT_A_RESET2_EVENT_A  (0x3B7F)	// RESET2_EVENT_A[6:0] field of the RESET2_EVENT_A register
+#define IOXP_RESET2_EVENT_B_RESET2_EVENT_B  (0x3C7F)	// RESET2_EVENT_B[6:0] field of the RESET2_EVENT_B register			
 #define IOXP_RESET_CFG_RESET_PULSE_WIDTH	(0x3D03)	// RESET_PULSE_WIDTH[1:0] field of the RESET_PULSE_WIDTH register
 #define IOXP_RESET_CFG_RESET_TRIGGER_TIME	(0x3D1C)	// TRIGGER_TIME[2:0] field of the RESET_PULSE_WIDTH register
 #define IOXP_CLOCK_DIV_CFG_CLK_DIV			(0X433E)	// CFG_CLK_DIV[4:0] field of the CLOCK_DIV register
@@ -255,12 +287,117 @@
 #define IOXP_GENERAL_CFG_B_CORE_FREQ  		(0x4D60)	// CORE_FREQ[1:0] field of the GENERAL_CFG_B register
 #define IOXP_RPULL_CONFIG_R_PULL_CFG(x)		((((0x19 + div4(x))) << 8) | (3 << (mod4(x)<<1)))		// R_PULL_CFG field of the RPULL_CONFIG registers corresponding to Row x (x between 0 and 7)
 #define IOXP_RPULL_CONFIG_C_PULL_CFG(x)		((((0x1B + div4(x))) << 8) | (3 << (mod4(x)<<1)))		// C_PULL_CFG field of the RPULL_CONFIG registers corresponding to Column x (x between 0 and 10)
+/* -------------------------------------------------------------------- */
+/*		Register Field Descriptors								        */
+/* -------------------------------------------------------------------- */
+
+// compile-time assertion, usable at namespace, class and function scope
+#if defined(__GNUC__)
+#define IOXP_ATTR_UNUSED				__attribute__((unused))
+#else
+#define IOXP_ATTR_UNUSED
+#endif
+#define IOXP_CONCAT_(a, b)				a##b
+#define IOXP_CONCAT(a, b)				IOXP_CONCAT_(a, b)
+#define IOXP_STATIC_ASSERT(cond, msg)	typedef char IOXP_CONCAT(IOXP_ASSERT_##msg##_, __LINE__)[(cond) ? 1 : -1] IOXP_ATTR_UNUSED
+
+// number of bits a mask must be shifted right so that its LSB is 1
+template<uint8_t bMask, bool fLsb = (bMask & 1) != 0>
+struct IOXPMaskShift {
+	enum { value = 1 + IOXPMaskShift<(uint8_t)(bMask >> 1)>::value };
+};
+template<uint8_t bMask>
+struct IOXPMaskShift<bMask, true> {
+	enum { value = 0 };
+};
+template<>
+struct IOXPMaskShift<0, false> {
+	enum { value = 0 };		// rejected by IOXPField
+};
+
+// Register field (single bit or group of bits) known at compile time. The shift is computed by the
+// compiler, so IOXP::SetField / IOXP::GetField reduce to a single masked register access.
+template<uint8_t bAddr, uint8_t bMask>
+struct IOXPField {
+	enum {
+		bAddress = bAddr,
+		bFieldMask = bMask,
+		bShift = IOXPMaskShift<bMask>::value,
+		bMaxVal = bMask >> IOXPMaskShift<bMask>::value
+	};
+	IOXP_STATIC_ASSERT(bMask != 0, field_mask_is_zero);
+	IOXP_STATIC_ASSERT(bAddr < IOXP_NO_REGS, field_address_out_of_range);
+	IOXP_STATIC_ASSERT(((bMaxVal + 1) & bMaxVal) == 0, field_mask_not_contiguous);
+};
+
+// field descriptor built from a wBitDef value (high byte register address, low byte mask)
+#define IOXP_FIELD(wBitDef)		IOXPField<(uint8_t)((wBitDef) >> 8), (uint8_t)((wBitDef) & 0xFF)>
+
+typedef IOXP_FIELD(IOXP_ID_MAN_ID)						IOXP_FIELD_MAN_ID;
+typedef IOXP_FIELD(IOXP_ID_REV_ID)						IOXP_FIELD_REV_ID;
+typedef IOXP_FIELD(IOXP_STATUS_EC)						IOXP_FIELD_EC;
+typedef IOXP_FIELD(IOXP_UNLOCK_TIMERS_INT_MASK_TIMER)	IOXP_FIELD_INT_MASK_TIMER;
+typedef IOXP_FIELD(IOXP_UNLOCK_TIMERS_UNLOCK_TIMER)		IOXP_FIELD_UNLOCK_TIMER;
+typedef IOXP_FIELD(IOXP_RESET_CFG_RESET_PULSE_WIDTH)	IOXP_FIELD_RESET_PULSE_WIDTH;
+typedef IOXP_FIELD(IOXP_RESET_CFG_RESET_TRIGGER_TIME)	IOXP_FIELD_RESET_TRIGGER_TIME;
+typedef IOXP_FIELD(IOXP_CLOCK_DIV_CFG_CLK_DIV)			IOXP_FIELD_CLK_DIV;
+typedef IOXP_FIELD(IOXP_LOGIC_1_CFG_LOGIC1_SEL)			IOXP_FIELD_LOGIC1_SEL;
+typedef IOXP_FIELD(IOXP_LOGIC_2_CFG_LOGIC2_SEL)			IOXP_FIELD_LOGIC2_SEL;
+typedef IOXP_FIELD(IOXP_POLL_TIME_CFG_KEY_POLL_TIME)	IOXP_FIELD_KEY_POLL_TIME;
+typedef IOXP_FIELD(IOXP_PIN_CONFIG_D_R3_EXTEND)			IOXP_FIELD_R3_EXTEND;
+typedef IOXP_FIELD(IOXP_GENERAL_CFG_B_CORE_FREQ)		IOXP_FIELD_CORE_FREQ;
+
+// Checks of the bit definitions above: the per-GPIO and per-pin macros must point to the first
+// register of their bank, and the event fields and their state bits must share their register.
+IOXP_STATIC_ASSERT((IOXP_GPI_EVENT_EN_GPI_EVENT_EN(1) >> 8) == IOXP_ADDR_GPI_EVENT_EN_A, gpi_event_en_base);
+IOXP_STATIC_ASSERT((IOXP_GPI_INT_STAT_GPI_INT(1) >> 8) == IOXP_ADDR_GPI_INT_STATUS_A, gpi_int_stat_base);
+IOXP_STATIC_ASSERT((IOXP_GPI_STATUS_GPI_STAT(1) >> 8) == IOXP_ADDR_GPI_STATUS_A, gpi_status_base);
+IOXP_STATIC_ASSERT((IOXP_INT_LEVEL_GPI_INT_LEVEL(1) >> 8) == IOXP_ADDR_GPI_INT_LEVEL_A, gpi_int_level_base);
+IOXP_STATIC_ASSERT((IOXP_DEBOUNCE_DIS_GPI_DEB_DIS(1) >> 8) == IOXP_ADDR_DEBOUNCE_DIS_A, debounce_dis_base);
+IOXP_STATIC_ASSERT((IOXP_GPO_DATA_OUT_GPO_DATA(1) >> 8) == IOXP_ADDR_GPO_DATA_OUT_A, gpo_data_out_base);
+IOXP_STATIC_ASSERT((IOXP_GPO_OUT_MODE_GPO_OUT_MODE(1) >> 8) == IOXP_ADDR_GPO_OUT_MODE_A, gpo_out_mode_base);
+IOXP_STATIC_ASSERT((IOXP_GPIO_DIRECTION_GPIO_DIR(1) >> 8) == IOXP_ADDR_GPIO_DIRECTION_A, gpio_direction_base);
+IOXP_STATIC_ASSERT((IOXP_GPIO_DIRECTION_GPIO_DIR(IOXP_GPIOS) >> 8) == IOXP_ADDR_GPIO_DIRECTION_C, gpio_direction_last);
+IOXP_STATIC_ASSERT((IOXP_RPULL_CONFIG_R_PULL_CFG(0) >> 8) == IOXP_ADDR_RPULL_CONFIG_A, rpull_row_base);
+IOXP_STATIC_ASSERT((IOXP_RPULL_CONFIG_C_PULL_CFG(0) >> 8) == IOXP_ADDR_RPULL_CONFIG_C, rpull_col_base);
+IOXP_STATIC_ASSERT((IOXP_UNLOCK1_UNLOCK1 | IOXP_UNLOCK1_UNLOCK1_STATE) == ((IOXP_ADDR_UNLOCK1 << 8) | 0xFF), unlock1_fields);
+IOXP_STATIC_ASSERT((IOXP_UNLOCK2_UNLOCK2 | IOXP_UNLOCK2_UNLOCK2_STATE) == ((IOXP_ADDR_UNLOCK2 << 8) | 0xFF), unlock2_fields);
+IOXP_STATIC_ASSERT((IOXP_EXT_LOCK_EVENT_EXT_LOCK_EVENT | IOXP_EXT_LOCK_EVENT_EXT_LOCK_STATE) == ((IOXP_ADDR_EXT_LOCK_EVENT << 8) | 0xFF), ext_lock_fields);
+IOXP_STATIC_ASSERT((IOXP_RESET1_EVENT_A_RESET1_EVENT_A | IOXP_RESET1_EVENT_A_RESET1_EVENT_A_LEVEL) == ((IOXP_ADDR_RESET1_EVENT_A << 8) | 0xFF), reset1a_fields);
+IOXP_STATIC_ASSERT((IOXP_RESET2_EVENT_B_RESET2_EVENT_B | IOXP_RESET2_EVENT_B_RESET2_EVENT_B_LEVEL) == ((IOXP_ADDR_RESET2_EVENT_B << 8) | 0xFF), reset2b_fields);
+IOXP_STATIC_ASSERT((IOXP_UNLOCK_TIMERS_INT_MASK_TIMER ^ IOXP_UNLOCK_TIMERS_UNLOCK_TIMER) == 0xFF, unlock_timers_fields);
+IOXP_STATIC_ASSERT(IOXP_LOGIC_2_LY2_INV != IOXP_LOGIC_2_LY1_CASCADE, logic2_bits);
+
 /* ------------------------------------------------------------------- */
 /*			Parameters Definitions  							       */
 /* ------------------------------------------------------------------- */
 
 
 
+// I2C transfer status, the first values match the Wire.endTransmission return codes
+#define IOXP_I2C_OK					0	// success
+#define IOXP_I2C_ERR_LENGTH			1	// data too long for the Wire buffer
+#define IOXP_I2C_ERR_NACK_ADDR		2	// device address not acknowledged
+#define IOXP_I2C_ERR_NACK_DATA		3	// data byte not acknowledged
+#define IOXP_I2C_ERR_BUS			4	// other bus error
+#define IOXP_I2C_ERR_SHORT_READ		5	// the device returned fewer bytes than requested
+#define IOXP_I2C_ERR_TIMEOUT		6	// the transfer did not complete in time
+// other status values returned by IOXP::begin, OnGpi and OnLogic
+#define IOXP_ERR_DEVICE_ID			7	// the device answered but its MAN_ID is not the ADP5589 one
+#define IOXP_ERR_PARAM				8	// invalid argument or no dispatch table, nothing was written
+
+// IOXP::begin options
+#define IOXP_BEGIN_NO_WIRE			0x01	// do not call Wire.begin (bus initialized by another IOXP object)
+#define IOXP_BEGIN_RESET_CFG		0x02	// without image, write the reset value (0) to all configuration registers
+
+// IOXP::SetRetryPolicy defaults: no retry until enabled
+#define IOXP_RETRY_BACKOFF_US		100		// wait before the first retry, doubled at each retry
+#define IOXP_CALL_TIMEOUT_US		5000	// no retry starts later than this after the start of a transfer
+#define IOXP_NO_PIN					0xFF	// IOXP::SetBusRecoveryPins: bus recovery disabled
+
+#define IOXP_I2C_CLK_100K			100000	// standard mode SCL frequency (Hz)
+#define IOXP_I2C_CLK_400K			400000	// fast mode SCL frequency (Hz)
+
 #define	PAR_EXT_INT0 0	// External interrupt 0
 #define	PAR_EXT_INT1 1	// External interrupt 1
 #define	PAR_EXT_INT2 2	// External interrupt 2
@@ -318,52 +455,522 @@
 #define IOXP_POLL_TIME_CFG_KEY_POLL_TIME_30MS	(0x02)	// 30 ms
 #define IOXP_POLL_TIME_CFG_KEY_POLL_TIME_40MS	(0x03)	// 40 ms
 
+#define IOXP_ID_MAN_ID_ADP5589				(0x01)	// MAN_ID field of the ADP5589 ID register
+
 #define IOXP_GENERAL_CFG_B_CORE_FREQ_50K		(0x00)	//  50 kHz
 #define IOXP_GENERAL_CFG_B_CORE_FREQ_100K		(0x01)	// 100 kHz
 #define IOXP_GENERAL_CFG_B_CORE_FREQ_200K		(0x02)	// 200 kHz
 #define IOXP_GENERAL_CFG_B_CORE_FREQ_500K		(0x03)	// 500 kHz
 
 
+// Values of the R_PULL_CFG / C_PULL_CFG fields. IOXP_RPULL_CONFIG_300KPD used to be redefined as 3 (no pull),
+// it is now the 300 kO pull-down: use IOXP_RPULL_CONFIG_NONE for no pull, see README.txt.
 #define IOXP_RPULL_CONFIG_300KPU		0	// enable 300 kO pull-up
 #define IOXP_RPULL_CONFIG_300KPD		1	// enable 300 kO pull-down
-#define IOXP_RPULL_CONFIG_100KPD		2	// enable 100 kO pull-up.
-#define IOXP_RPULL_CONFIG_300KPD		3	// disable all pull-up/pull-down resistors
+#define IOXP_RPULL_CONFIG_100KPU		2	// enable 100 kO pull-up
+#define IOXP_RPULL_CONFIG_100KPD		IOXP_RPULL_CONFIG_100KPU	// former name, it is a pull-up
+#define IOXP_RPULL_CONFIG_NONE			3	// disable all pull-up/pull-down resistors
 
 /* -------------------------------------------------------------------- */
 /*					Procedure Declarations						        */
 /* -------------------------------------------------------------------- */
 
 // the default value for the keyMap corresponds to Digilent PmodKYPD plugged into J1 connector of PmodIOXP (R0-3, C0-3).
-static int keyMap_KYPD[IOXP_KB_ROWS][IOXP_KB_COLS] = 
-					{{ 0xD,0xC,0xB,0xA, -1, -1, -1, -1, -1, -1, -1},    //row 0
-                     { 0xE,  9,  6,  3, -1, -1, -1, -1, -1, -1, -1},    //row 1
-                     { 0xF,  8,  5,  2, -1, -1, -1, -1, -1, -1, -1},    //row 2
-                     {   0,  7,  4,  1, -1, -1, -1, -1, -1, -1, -1},    //row 3
-                     {  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},    //row 4
-                     {  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},    //row 5
-                     {  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},    //row 6
-                     {  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},    //row 7
-					 };
+// It is defined in IOXP.cpp.
+extern const int8_t keyMap_KYPD[IOXP_KB_ROWS][IOXP_KB_COLS];
+
+
+// event kinds, returned by DecodeEvent and stored in IOXPEvent::bKind
+#define IOXP_EVENT_KIND_NONE		0	// unused event identifier
+#define IOXP_EVENT_KIND_KEY			1	// key between a row and a column
+#define IOXP_EVENT_KIND_GND			2	// key between a row and GND
+#define IOXP_EVENT_KIND_GPI			3
+#define IOXP_EVENT_KIND_LOGIC		4
+#define IOXP_EVENT_KINDS			5
+
+// first event identifier of each kind
+#define IOXP_EVENT_ID_KEY			1
+#define IOXP_EVENT_ID_GND			(IOXP_EVENT_ID_KEY + IOXP_KB_ROWS * IOXP_KB_COLS)	// 89
+#define IOXP_EVENT_ID_GPI			(IOXP_EVENT_ID_GND + IOXP_KB_ROWS)					// 97
+#define IOXP_EVENT_ID_LOGIC			(IOXP_EVENT_ID_GPI + IOXP_GPIOS)					// 116
+#define IOXP_EVENT_ID_END			(IOXP_EVENT_ID_LOGIC + IOXP_NO_LOGIC)				// 118, first unused identifier
+
+// reverse key map built by SetKeyMap: a hash table of key indexes with IOXP_KEY_HASH_SLOTS slots (a power of 2,
+// more than the number of keys), 128 bytes per object
+#define IOXP_KEY_HASH_SLOTS			128
+#define IOXP_KEY_HASH_BITS			7
+IOXP_STATIC_ASSERT((1 << IOXP_KEY_HASH_BITS) == IOXP_KEY_HASH_SLOTS && IOXP_KEY_HASH_SLOTS > IOXP_KB_ROWS * IOXP_KB_COLS, key_hash_size);
+
+// Pressed-key state kept from the FIFO events: one bit per key index, which is the event identifier - 1
+// (row * IOXP_KB_COLS + col for the matrix keys, IOXP_KEY_IDX_GND + row for the row-to-GND keys)
+#define IOXP_KEY_STATES				(IOXP_EVENT_ID_GPI - IOXP_EVENT_ID_KEY)		// 96
+#define IOXP_KEY_IDX_GND			(IOXP_EVENT_ID_GND - IOXP_EVENT_ID_KEY)		// 88
+#define IOXP_KB_COL_GND				IOXP_KB_COLS	// column given to IsKeyDown for the row-to-GND keys
+#define IOXP_KEY_IDX_NONE			0xFF			// end of GetNextKeyDown
+
+// index of the lowest set bit of a non-zero 32-bit value
+#if defined(__GNUC__)
+#define IOXP_CTZ(dw)				__builtin_ctzl(dw)
+#else
+#define IOXP_CTZ(dw)				IOXP::BitScan(dw)
+#endif
+
+// IOXPEvent::bFlags bits
+#define IOXP_EVENT_FLAG_RESYNC		0x01	// not read from the FIFO: state change lost in a FIFO overflow, see IOXP::Service
+
+// decoded FIFO event, see IOXP::ReadFIFO for the meaning of the fields
+struct IOXPEvent {
+	uint8_t bEvent;			// raw event byte: event identifier in bits [6:0], event state in bit 7
+	uint8_t bKind;			// one of the IOXP_EVENT_KIND_... values
+	uint8_t bDevice;		// index of the device in its IOXPGroup, 0 for a device used alone
+	uint8_t bFlags;			// IOXP_EVENT_FLAG_... bits
+	int iKeyVal;
+	uint8_t bRow;
+	uint8_t bCol;
+	uint8_t bGPI;
+	uint8_t bLogic;
+	uint8_t bEventState;
+	uint32_t dwTimeUS;		// estimated time (micros()) the device queued the event, see IOXP::Service
+	uint32_t dwTimeErrUS;	// the queuing time is within dwTimeUS +/- dwTimeErrUS
+};
+
+// input state read by IOXP::ReadSnapshot
+struct IOXPSnapshot {
+	uint8_t bIntStatus;		// INT_STATUS: pending interrupt sources, IOXP_INT_STATUS_... bits
+	uint8_t bStatus;		// STATUS: event count and LOGIC / LOCK states, IOXP_STATUS_... bits
+	uint8_t bEventCount;	// number of events in the FIFO (EC field of STATUS)
+	uint32_t dwGPIIntStat;	// GPI interrupt flags, bit x - 1 for GPIO x (cleared in the device by the read)
+	uint32_t dwGPIStat;		// GPI levels, bit x - 1 for GPIO x
+};
+
+// Device configuration, converted by IOXP::BuildConfigImage to the values of the registers
+// IOXP_CFG_FIRST - IOXP_CFG_LAST and written by IOXP::ApplyConfig. GPIO bit maps use bit x - 1 for
+// GPIO x (GPIO 1 - 8 are R0 - R7, GPIO 9 - 19 are C0 - C10). IOXP::InitConfig gives the reset values.
+struct IOXPConfig {
+	uint8_t bRowCfg;				// PIN_CONFIG_A: rows of the key matrix, bit x for row x
+	uint16_t wColCfg;				// PIN_CONFIG_B, C: columns of the key matrix, bit x for column x
+	uint8_t bPinConfigD;			// PIN_CONFIG_D: IOXP_PIN_CONFIG_D_... bits
+	uint8_t rgbPull[IOXP_GPIOS];	// pull resistor of each GPIO (index x - 1 for GPIO x), IOXP_RPULL_CONFIG_... values
+	uint32_t dwDirection;			// GPIO_DIRECTION: 1 for an output
+	uint32_t dwGpoOut;				// GPO_DATA_OUT: output levels
+	uint32_t dwGpoOutMode;			// GPO_OUT_MODE
+	uint32_t dwDebounceDis;			// DEBOUNCE_DIS: 1 to disable the debounce of the input
+	uint32_t dwGpiIntLevel;			// GPI_INT_LEVEL
+	uint32_t dwGpiEventEn;			// GPI_EVENT_EN: 1 to report the input changes in the event FIFO
+	uint32_t dwGpiIntEn;			// GPI_INTERRUPT_EN
+	uint8_t rgbLockCfg[5];			// UNLOCK1, UNLOCK2, EXT_LOCK_EVENT, UNLOCK_TIMERS, LOCK_CFG
+	uint8_t rgbResetCfg[6];			// RESET1_EVENT_A - C, RESET2_EVENT_A - B, RESET_CFG
+	uint16_t wPwmOffTime;			// PWM_OFFT: off time (us)
+	uint16_t wPwmOnTime;			// PWM_ONT: on time (us)
+	uint8_t bPwmCfg;				// PWM_CFG: IOXP_PWM_CFG_... bits
+	uint8_t bClockDivCfg;			// CLOCK_DIV_CFG
+	uint8_t bLogic1Cfg;				// LOGIC_1_CFG
+	uint8_t bLogic2Cfg;				// LOGIC_2_CFG
+	uint8_t bLogicFFCfg;			// LOGIC_FF_CFG
+	uint8_t bLogicIntEvent;			// LOGIC_INT_EVENT_EN
+	uint8_t bPollTime;				// KEY_POLL_TIME, IOXP_POLL_TIME_CFG_KEY_POLL_TIME_... value
+	uint8_t bCoreFreq;				// CORE_FREQ, IOXP_GENERAL_CFG_B_CORE_FREQ_... value
+	uint8_t bGeneralCfgB;			// GENERAL_CFG_B except the CORE_FREQ field (OSC_EN, INT_CFG, ...)
+	uint8_t bIntEn;					// INT_EN: IOXP_INT_EN_... bits
+};
+
+// Compile-time configuration: derive a struct from IOXPDefaultConfig and redefine the enumerators that
+// differ from the reset state, for example
+//		struct MyCfg : IOXPDefaultConfig {
+//			enum { bRowCfg = 0x0F, wColCfg = 0x0F, bIntEn = IOXP_INT_EN_EVENT_IEN,
+//				bGeneralCfgB = IOXP_GENERAL_CFG_B_OSC_EN | IOXP_GENERAL_CFG_B_INT_CFG };
+//		};
+// Register values keep only their low byte, so the IOXP_... bit definitions can be used as they are.
+// IOXPImage<MyCfg> then holds the register image and its write ranges as constant tables, with no code.
+struct IOXPDefaultConfig {
+	enum {
+		bRowCfg = 0, wColCfg = 0, bPinConfigD = 0,					// as in IOXPConfig
+		wPullRows = 0,			// RPULL_CONFIG_A - B, see IOXP_PULL_ROW
+		dwPullCols = 0,			// RPULL_CONFIG_C - E, see IOXP_PULL_COL
+		dwDirection = 0, dwGpoOut = 0, dwGpoOutMode = 0, dwDebounceDis = 0,	// GPIO bit maps, see IOXP_GPIO_BIT
+		dwGpiIntLevel = 0, dwGpiEventEn = 0, dwGpiIntEn = 0,
+		bUnlock1 = 0, bUnlock2 = 0, bExtLockEvent = 0, bUnlockTimers = 0, bLockCfg = 0,
+		bReset1EventA = 0, bReset1EventB = 0, bReset1EventC = 0, bReset2EventA = 0, bReset2EventB = 0, bResetCfg = 0,
+		wPwmOffTime = 0, wPwmOnTime = 0, bPwmCfg = 0, bClockDivCfg = 0,
+		bLogic1Cfg = 0, bLogic2Cfg = 0, bLogicFFCfg = 0, bLogicIntEvent = 0,
+		bPollTime = 0, bCoreFreq = 0, bGeneralCfgB = 0, bIntEn = 0
+	};
+};
+
+#define IOXP_GPIO_BIT(x)		(1L << ((x) - 1))				// bit of GPIO x (1 - 19) in a GPIO bit map
+#define IOXP_PULL_ROW(x, v)		((long)(v) << ((x) << 1))		// pull option v (IOXP_RPULL_CONFIG_...) of row x, for wPullRows
+#define IOXP_PULL_COL(x, v)		((long)(v) << ((x) << 1))		// pull option v of column x, for dwPullCols
+
+// byte of the multi-byte value v that goes to register a, base being the register of the low byte
+#define IOXP_CFG_BYTE(v, a, base)	((uint8_t)((unsigned long)(v) >> ((((a) - (base)) & 3) << 3)))
+
+// value of register nAddr in the image of Cfg, 0 outside IOXP_CFG_FIRST - IOXP_CFG_LAST
+template<class Cfg, int nAddr>
+struct IOXPCfgReg {
+	enum { value =
+		(nAddr < IOXP_CFG_FIRST || nAddr > IOXP_CFG_LAST) ? 0 :
+		(nAddr < IOXP_ADDR_RPULL_CONFIG_C) ? IOXP_CFG_BYTE(Cfg::wPullRows, nAddr, IOXP_ADDR_RPULL_CONFIG_A) :
+		(nAddr < IOXP_ADDR_GPI_INT_LEVEL_A) ? IOXP_CFG_BYTE(Cfg::dwPullCols, nAddr, IOXP_ADDR_RPULL_CONFIG_C) :
+		(nAddr < IOXP_ADDR_GPI_EVENT_EN_A) ? IOXP_CFG_BYTE(Cfg::dwGpiIntLevel, nAddr, IOXP_ADDR_GPI_INT_LEVEL_A) :
+		(nAddr < IOXP_ADDR_GPI_INTERRUPT_EN_A) ? IOXP_CFG_BYTE(Cfg::dwGpiEventEn, nAddr, IOXP_ADDR_GPI_EVENT_EN_A) :
+		(nAddr < IOXP_ADDR_DEBOUNCE_DIS_A) ? IOXP_CFG_BYTE(Cfg::dwGpiIntEn, nAddr, IOXP_ADDR_GPI_INTERRUPT_EN_A) :
+		(nAddr < IOXP_ADDR_GPO_DATA_OUT_A) ? IOXP_CFG_BYTE(Cfg::dwDebounceDis, nAddr, IOXP_ADDR_DEBOUNCE_DIS_A) :
+		(nAddr < IOXP_ADDR_GPO_OUT_MODE_A) ? IOXP_CFG_BYTE(Cfg::dwGpoOut, nAddr, IOXP_ADDR_GPO_DATA_OUT_A) :
+		(nAddr < IOXP_ADDR_GPIO_DIRECTION_A) ? IOXP_CFG_BYTE(Cfg::dwGpoOutMode, nAddr, IOXP_ADDR_GPO_OUT_MODE_A) :
+		(nAddr < IOXP_ADDR_UNLOCK1) ? IOXP_CFG_BYTE(Cfg::dwDirection, nAddr, IOXP_ADDR_GPIO_DIRECTION_A) :
+		(nAddr == IOXP_ADDR_UNLOCK1) ? (uint8_t)Cfg::bUnlock1 :
+		(nAddr == IOXP_ADDR_UNLOCK2) ? (uint8_t)Cfg::bUnlock2 :
+		(nAddr == IOXP_ADDR_EXT_LOCK_EVENT) ? (uint8_t)Cfg::bExtLockEvent :
+		(nAddr == IOXP_ADDR_UNLOCK_TIMERS) ? (uint8_t)Cfg::bUnlockTimers :
+		(nAddr == IOXP_ADDR_LOCK_CFG) ? (uint8_t)Cfg::bLockCfg :
+		(nAddr == IOXP_ADDR_RESET1_EVENT_A) ? (uint8_t)Cfg::bReset1EventA :
+		(nAddr == IOXP_ADDR_RESET1_EVENT_B) ? (uint8_t)Cfg::bReset1EventB :
+		(nAddr == IOXP_ADDR_RESET1_EVENT_C) ? (uint8_t)Cfg::bReset1EventC :
+		(nAddr == IOXP_ADDR_RESET2_EVENT_A) ? (uint8_t)Cfg::bReset2EventA :
+		(nAddr == IOXP_ADDR_RESET2_EVENT_B) ? (uint8_t)Cfg::bReset2EventB :
+		(nAddr == IOXP_ADDR_RESET_CFG) ? (uint8_t)Cfg::bResetCfg :
+		(nAddr < IOXP_ADDR_PWM_ONT_LOW) ? IOXP_CFG_BYTE(Cfg::wPwmOffTime, nAddr, IOXP_ADDR_PWM_OFFT_LOW) :
+		(nAddr < IOXP_ADDR_PWM_CFG) ? IOXP_CFG_BYTE(Cfg::wPwmOnTime, nAddr, IOXP_ADDR_PWM_ONT_LOW) :
+		(nAddr == IOXP_ADDR_PWM_CFG) ? (uint8_t)Cfg::bPwmCfg :
+		(nAddr == IOXP_ADDR_CLOCK_DIV_CFG) ? (uint8_t)Cfg::bClockDivCfg :
+		(nAddr == IOXP_ADDR_LOGIC_1_CFG) ? (uint8_t)Cfg::bLogic1Cfg :
+		(nAddr == IOXP_ADDR_LOGIC_2_CFG) ? (uint8_t)Cfg::bLogic2Cfg :
+		(nAddr == IOXP_ADDR_LOGIC_FF_CFG) ? (uint8_t)Cfg::bLogicFFCfg :
+		(nAddr == IOXP_ADDR_LOGIC_INT_EVENT) ? (uint8_t)Cfg::bLogicIntEvent :
+		(nAddr == IOXP_ADDR_POLL_TIME_CFG) ? (Cfg::bPollTime & IOXP_FIELD_KEY_POLL_TIME::bFieldMask) :
+		(nAddr == IOXP_ADDR_PIN_CONFIG_A) ? (uint8_t)Cfg::bRowCfg :
+		(nAddr == IOXP_ADDR_PIN_CONFIG_B) ? (uint8_t)Cfg::wColCfg :
+		(nAddr == IOXP_ADDR_PIN_CONFIG_C) ? ((Cfg::wColCfg >> 8) & 0x07) :
+		(nAddr == IOXP_ADDR_PIN_CONFIG_D) ? (uint8_t)Cfg::bPinConfigD :
+		(nAddr == IOXP_ADDR_GENERAL_CFG_B) ? (((uint8_t)Cfg::bGeneralCfgB & ~IOXP_FIELD_CORE_FREQ::bFieldMask) |
+			((Cfg::bCoreFreq << IOXP_FIELD_CORE_FREQ::bShift) & IOXP_FIELD_CORE_FREQ::bFieldMask)) :
+		(uint8_t)Cfg::bIntEn
+	};
+};
+
+// Write ranges of an image: the registers that differ from their reset value (0), joined in bursts
+// like CommitBatch does (up to IOXP_BATCH_MAX_GAP registers between two non-zero registers).
+template<class Cfg, int nAddr>
+struct IOXPCfgNonZero {
+	enum { value = IOXPCfgReg<Cfg, nAddr>::value != 0 };
+};
+// a non-zero register among the n registers before nAddr
+template<class Cfg, int nAddr, int n = IOXP_BATCH_MAX_GAP + 1>
+struct IOXPCfgNonZeroBefore {
+	enum { value = IOXPCfgNonZero<Cfg, nAddr - n>::value || IOXPCfgNonZeroBefore<Cfg, nAddr, n - 1>::value };
+};
+template<class Cfg, int nAddr>
+struct IOXPCfgNonZeroBefore<Cfg, nAddr, 0> {
+	enum { value = 0 };
+};
+template<class Cfg, int nAddr>
+struct IOXPCfgRangeStart {
+	enum { value = IOXPCfgNonZero<Cfg, nAddr>::value && !IOXPCfgNonZeroBefore<Cfg, nAddr>::value };
+};
+// last register of the range containing the non-zero register nAddr
+template<class Cfg, int nAddr, bool fInImage = (nAddr <= IOXP_CFG_LAST)>
+struct IOXPCfgRangeEnd;
+template<class Cfg, int nAddr, int n = IOXP_BATCH_MAX_GAP + 1>
+struct IOXPCfgRangeEndAfter {
+	enum {
+		nNext = IOXPCfgNonZero<Cfg, nAddr + n>::value ? (int)IOXPCfgRangeEnd<Cfg, nAddr + n>::value : nAddr,
+		nOther = IOXPCfgRangeEndAfter<Cfg, nAddr, n - 1>::value,
+		value = nNext > nOther ? nNext : nOther
+	};
+};
+template<class Cfg, int nAddr>
+struct IOXPCfgRangeEndAfter<Cfg, nAddr, 0> {
+	enum { value = nAddr };
+};
+template<class Cfg, int nAddr, bool fInImage>
+struct IOXPCfgRangeEnd {
+	enum { value = IOXPCfgRangeEndAfter<Cfg, nAddr>::value };
+};
+template<class Cfg, int nAddr>
+struct IOXPCfgRangeEnd<Cfg, nAddr, false> {
+	enum { value = nAddr };
+};
+// number of ranges starting before nAddr
+template<class Cfg, int nAddr, bool fInImage = (nAddr > IOXP_CFG_FIRST)>
+struct IOXPCfgRangeCount {
+	enum { value = IOXPCfgRangeCount<Cfg, nAddr - 1>::value + IOXPCfgRangeStart<Cfg, nAddr - 1>::value };
+};
+template<class Cfg, int nAddr>
+struct IOXPCfgRangeCount<Cfg, nAddr, false> {
+	enum { value = 0 };
+};
+// range number i, searched from nAddr; bCount is 0 past the last range
+template<class Cfg, int i, int nAddr = IOXP_CFG_FIRST, bool fInImage = (nAddr <= IOXP_CFG_LAST)>
+struct IOXPCfgRange {
+	enum {
+		fFound = IOXPCfgRangeStart<Cfg, nAddr>::value && IOXPCfgRangeCount<Cfg, nAddr>::value == i,
+		bFirst = fFound ? nAddr : (int)IOXPCfgRange<Cfg, i, nAddr + 1>::bFirst,
+		bCount = fFound ? IOXPCfgRangeEnd<Cfg, nAddr>::value - nAddr + 1 : (int)IOXPCfgRange<Cfg, i, nAddr + 1>::bCount
+	};
+};
+template<class Cfg, int i, int nAddr>
+struct IOXPCfgRange<Cfg, i, nAddr, false> {
+	enum { bFirst = 0, bCount = 0 };
+};
+
+// burst write of rgbImage[bFirst - IOXP_CFG_FIRST] ... to registers bFirst ...
+struct IOXPRange {
+	uint8_t bFirst;
+	uint8_t bCount;
+};
+
+// most ranges an image can have: one non-zero register every IOXP_BATCH_MAX_GAP + 2 registers
+#define IOXP_CFG_MAX_RANGES		((IOXP_CFG_IMAGE_SIZE + IOXP_BATCH_MAX_GAP + 1) / (IOXP_BATCH_MAX_GAP + 2))
+IOXP_STATIC_ASSERT(IOXP_CFG_MAX_RANGES <= 14, image_range_table_size);
+
+// register image of the configuration Cfg (rgbImage, for IOXP::ApplyConfigImage) and its write ranges
+// after a device reset (rgRanges, for IOXP::WriteConfig), all computed by the compiler
+template<class Cfg>
+struct IOXPImage {
+	enum { bCntRanges = IOXPCfgRangeCount<Cfg, IOXP_CFG_LAST + 1>::value };
+	static const uint8_t rgbImage[IOXP_CFG_IMAGE_SIZE];
+	static const IOXPRange rgRanges[IOXP_CFG_MAX_RANGES];
+};
+
+#define IOXP_IMG_REG(a)		IOXPCfgReg<Cfg, (a)>::value
+#define IOXP_IMG_REG4(a)	IOXP_IMG_REG(a), IOXP_IMG_REG((a) + 1), IOXP_IMG_REG((a) + 2), IOXP_IMG_REG((a) + 3)
+#define IOXP_IMG_RANGE(i)	{IOXPCfgRange<Cfg, (i)>::bFirst, IOXPCfgRange<Cfg, (i)>::bCount}
+template<class Cfg>
+const uint8_t IOXPImage<Cfg>::rgbImage[IOXP_CFG_IMAGE_SIZE] =
+{
+	IOXP_IMG_REG4(0x19), IOXP_IMG_REG4(0x1D), IOXP_IMG_REG4(0x21), IOXP_IMG_REG4(0x25),
+	IOXP_IMG_REG4(0x29), IOXP_IMG_REG4(0x2D), IOXP_IMG_REG4(0x31), IOXP_IMG_REG4(0x35),
+	IOXP_IMG_REG4(0x39), IOXP_IMG_REG4(0x3D), IOXP_IMG_REG4(0x41), IOXP_IMG_REG4(0x45),
+	IOXP_IMG_REG4(0x49), IOXP_IMG_REG(0x4D), IOXP_IMG_REG(0x4E)
+};
+template<class Cfg>
+const IOXPRange IOXPImage<Cfg>::rgRanges[IOXP_CFG_MAX_RANGES] =
+{
+	IOXP_IMG_RANGE(0), IOXP_IMG_RANGE(1), IOXP_IMG_RANGE(2), IOXP_IMG_RANGE(3), IOXP_IMG_RANGE(4),
+	IOXP_IMG_RANGE(5), IOXP_IMG_RANGE(6), IOXP_IMG_RANGE(7), IOXP_IMG_RANGE(8), IOXP_IMG_RANGE(9),
+	IOXP_IMG_RANGE(10), IOXP_IMG_RANGE(11), IOXP_IMG_RANGE(12), IOXP_IMG_RANGE(13)
+};
+IOXP_STATIC_ASSERT(IOXP_CFG_FIRST == 0x19 && IOXP_CFG_IMAGE_SIZE == 54, image_table_layout);
+
+// Single-producer / single-consumer queue of decoded events, filled by IOXP::Service and emptied by
+// the application with Pop. The producer only writes wHead and the consumer only writes wTail, so no
+// lock is needed as long as each side runs in a single context. Use IOXPEventRing to get the storage.
+class IOXPEventQueue {
+public:
+	bool Pop(IOXPEvent &evt);
+	uint16_t GetCount();
+	uint16_t GetCapacity();
+	uint32_t GetDropCount();
+	uint32_t GetOverflowCount();
+	void ResetCounters();
+protected:
+	IOXPEventQueue(IOXPEvent *rgEvtStorage, uint16_t wCapacity);
+private:
+	friend class IOXP;
+	bool Push(const IOXPEvent &evt);
+	IOXPEvent *rgEvt;
+	uint16_t wMask;					// capacity - 1, the capacity is a power of 2
+	volatile uint16_t wHead;		// free running index of the next slot to fill, written by the producer
+	volatile uint16_t wTail;		// free running index of the next slot to pop, written by the consumer
+	volatile uint32_t dwDropped;	// events lost because the queue was full
+	volatile uint32_t dwOverflows;	// device FIFO overflows (OVERFLOW_INT) seen by IOXP::Service
+};
+
+// event queue with storage for N events, N must be a power of 2
+template<uint16_t N> class IOXPEventRing : public IOXPEventQueue {
+	IOXP_STATIC_ASSERT(N != 0 && (N & (N - 1)) == 0, ring_capacity_not_power_of_2);
+	IOXP_STATIC_ASSERT(N <= 0x8000, ring_capacity_too_large);
+	IOXPEvent rgEvtBuf[N];
+public:
+	IOXPEventRing() : IOXPEventQueue(rgEvtBuf, N) {}
+};
+
+// event handler called by IOXPDispatchTable::Dispatch
+typedef void (*IOXPEventHandler)(const IOXPEvent &evt);
+
+// event states a handler is subscribed to, see IOXP::OnKey
+#define IOXP_ON_PRESS				0x01	// event state 1: key pressed, GPI or logic output active
+#define IOXP_ON_RELEASE				0x02	// event state 0: key released, GPI or logic output inactive
+#define IOXP_ON_BOTH				(IOXP_ON_PRESS | IOXP_ON_RELEASE)
+
+// number of slots of the dispatch table, one per event identifier (bits [6:0] of the event byte)
+#define IOXP_EVENT_IDS				128
+
+// Handlers indexed by event identifier, filled by IOXP::OnKey, OnKeyVal, OnGpi and OnLogic and used
+// by IOXP::Service (see IOXP::SetDispatchTable) or directly with Dispatch. One table can be shared by
+// the devices of an IOXPGroup when they subscribe to different inputs.
+class IOXPDispatchTable {
+public:
+	IOXPDispatchTable();
+	void Clear();
+	bool Dispatch(const IOXPEvent &evt);
+private:
+	friend class IOXP;
+	void Set(uint8_t bEventId, IOXPEventHandler pfnHandler, uint8_t bStates);
+	IOXPEventHandler rgpfnHandler[IOXP_EVENT_IDS];
+	uint32_t rgdwOnPress[IOXP_EVENT_IDS / 32];		// bit set: call the handler for event state 1
+	uint32_t rgdwOnRelease[IOXP_EVENT_IDS / 32];	// bit set: call the handler for event state 0
+};
+
+// I2C error counters of an IOXP object, see IOXP::GetBusErrors
+struct IOXPBusErrors {
+	uint32_t dwNacks;		// address or data byte not acknowledged
+	uint32_t dwBusErrors;	// other Wire errors
+	uint32_t dwShortReads;	// reads that returned fewer bytes than requested
+	uint32_t dwRetries;		// cycles repeated after an error
+	uint32_t dwTimeouts;	// transfers stopped because their time budget ran out
+	uint32_t dwFailures;	// transfers that returned an error to the caller
+	uint32_t dwRecoveries;	// bus recovery sequences (SDA held low)
+};
+
+struct IOXPRequest;
 
+// completion handler of a request submitted with IOXP::SubmitRead or SubmitWrite
+typedef void (*IOXPRequestHandler)(IOXPRequest &req);
+
+// IOXPRequest::bState values
+#define IOXP_REQ_IDLE				0	// never submitted
+#define IOXP_REQ_QUEUED				1	// waiting or in progress, see IOXP::PollRequests
+#define IOXP_REQ_DONE				2	// completed, bStatus holds the result
+
+// default number of register bytes transferred by one IOXP::PollRequests call
+#define IOXP_REQ_CHUNK				4
+
+// Register transfer run in steps by IOXP::PollRequests. The request is owned by the caller and linked
+// in the device queue by SubmitRead or SubmitWrite: it and its buffer must stay valid until bState is
+// IOXP_REQ_DONE. The fields are set by the submit call, only bState, bStatus and bCntDone change after.
+struct IOXPRequest {
+	uint8_t bAddress;				// first register
+	uint8_t bCntBytes;				// number of registers
+	uint8_t *rgbBuf;				// values read, or values to write
+	IOXPRequestHandler pfnDone;		// called by PollRequests on completion, can be NULL
+	void *pvContext;				// for the handler
+	volatile uint8_t bState;		// IOXP_REQ_... value, poll it when pfnDone is NULL
+	uint8_t bStatus;				// IOXP_I2C_OK or the error that ended the transfer
+	uint8_t bCntDone;				// number of registers transferred
+	bool fRead;
+	IOXPRequest *pNext;				// next request of the queue
+};
+
+#if defined(IOXP_PROFILE)
+// I2C traffic statistics, indexed by the address of the first register of each transaction
+struct IOXPStats {
+	uint32_t rgdwReads[IOXP_NO_REGS];		// read transactions
+	uint32_t rgdwWrites[IOXP_NO_REGS];		// write transactions
+	uint32_t rgdwBytes[IOXP_NO_REGS];		// data bytes read and written
+	uint32_t dwWireTimeUS;					// time spent in Wire calls (us)
+	uint32_t dwMaxTransferUS;				// longest single transaction (us)
+	uint8_t bMaxTransferBytes;				// largest single transaction (data bytes)
+	uint8_t bMaxTransferAddr;				// first register of the largest transaction
+};
+#endif
 
 class IOXP {
 private:	
-	void ReadBytesI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues);
-	void WriteBytesI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues);
+	uint8_t ReadBytesI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues);
+	uint8_t WriteBytesI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues);
+	uint8_t WriteChunkI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues);
+	uint8_t ReadChunkI2C(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues, uint8_t &bCntRead);
+	uint8_t RetryTransfer(uint8_t bStatus, uint8_t &bAttempt, uint32_t dwStartUS);
+	uint8_t CheckBus();
 	uint8_t ReadMaskedRegisterValue(uint8_t bAddress, uint8_t bMask);
 	void WriteMaskedRegisterValue(uint8_t bAddress, uint8_t bMask, uint8_t bValue);
-	void DecodeEvent(uint8_t bEvent, int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);
+	uint8_t DecodeEvent(uint8_t bEvent, int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);
 	// under construction not fully working
 	uint8_t EncodeEvent(int iKeyVal, uint8_t bRow = 0xFF, uint8_t bCol = 0xFF, uint8_t bGPI = 0xFF, uint8_t bLogic = 0xFF, uint8_t bEventState = 0);
 
 	int GetKeyVal(uint8_t bRow, uint8_t bCol);
-	void GetKeyByVal(int iKeyVal, uint8_t &bRow, uint8_t &bCol);
+	static uint8_t KeyHash(int iKeyVal);
+	int GetKeyMapVal(uint8_t bKeyIdx);
+	uint8_t GetKeyIdxByVal(int iKeyVal);
+	bool TrackEventState(uint8_t bEvent);
+	uint8_t ReadGpiState(uint32_t &dwActive, uint32_t &dwEventEn);
+	uint8_t ResyncState(uint32_t dwFromUS, uint32_t dwToUS);
+	bool NextResyncEvent(IOXPEvent &evt);
+	void DeliverEvent(IOXPEventQueue *pQueue, const IOXPEvent &evt);
+	uint8_t SubmitRequest(IOXPRequest &req, bool fRead, uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbBuf,
+		IOXPRequestHandler pfnDone, void *pvContext);
+#if !defined(__GNUC__)
+	static uint8_t BitScan(uint32_t dw);
+#endif
+	uint8_t SetKeyMapTable(const void *pvTable, uint8_t bElemSize);
 	uint8_t Mask2Scale(uint8_t bMask);
 	void attachCNInterrupt(uint8_t bParCNNo, void (*pfIntHandler)(), unsigned char type);
-    int keyMap[IOXP_KB_ROWS][IOXP_KB_COLS];	
+	void UpdateShadow(uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbValues);
+	bool IsShadowValid(uint8_t bAddress);
+	bool FillEvent(IOXPEvent &evt, uint8_t bEvent);
+	uint8_t KeepLateEvents(uint8_t *rgbFifo, uint8_t bCntEvents, uint8_t bCntRead);
+	static void IntHandler0();
+	static void IntHandler1();
+	static void IntHandler2();
+	static void IntHandler3();
+	static void IntHandler4();
+	static volatile bool *rgpfIntPending[IOXP_EXT_INT_CNT];	// flag set by each external interrupt handler
+	static volatile uint32_t *rgpdwIntTimeUS[IOXP_EXT_INT_CNT];	// receives the time of the edge that sets the flag
+	static void AttachIntFlag(uint8_t bParExtIntNo, volatile bool *pfPending, volatile uint32_t *pdwTimeUS);
+	static void SignalInt(uint8_t bParExtIntNo);
+	void EnableEventInterrupts(uint16_t wEventMask);
+	uint8_t ServiceDevice(IOXPEventQueue *pQueue, uint8_t bDevice, uint8_t bCntPrefetch, uint8_t &bCntEvents,
+		uint32_t dwEdgeUS, bool fExactEdge);
+	void StampEvent(IOXPEvent &evt, uint8_t bIdx, uint32_t dwFromUS, uint32_t dwToUS, bool fExact);
+	uint8_t GetGpoLatch(uint8_t *rgbLatch);
+	uint8_t GpoUpdate(uint32_t dwClear, uint32_t dwSet, uint32_t dwToggle);
+	static void ParseConfigImage(const uint8_t *rgbImage, IOXPConfig &cfg);
+	friend class IOXPGroup;
+	template<uint8_t Pin> friend struct IOXPPin;
+	friend class IOXPHostTest;		// white box access for the host tests in extras/host
+	uint8_t UpdateLatchBits(uint8_t bAddress, uint8_t bMask, uint8_t bVal);
+	static void (* const rgpfIntHandler[IOXP_EXT_INT_CNT])();
+#if defined(IOXP_PROFILE)
+	void ProfileTransfer(uint8_t bAddress, uint8_t bCntBytes, bool fRead, uint32_t dwTimeUS);
+	IOXPStats stats;
+#endif
+	const void *pvKeyMap;		// key map set by SetKeyMap, IOXP_KB_ROWS x IOXP_KB_COLS signed values, not copied
+	uint8_t bKeyMapElemSize;	// size of the key map elements: 1, 2 or 4 bytes
+	uint8_t rgbKeyHash[IOXP_KEY_HASH_SLOTS];	// key value -> key index (row * IOXP_KB_COLS + col), open addressing, 0xFF if empty
+	uint32_t rgdwKeyDown[(IOXP_KEY_STATES + 31) >> 5];	// pressed keys, bit = key index
+	uint8_t bCntKeysDown;						// number of bits set in rgdwKeyDown
+	uint32_t dwGpiActive;						// GPI states from the GPI events, bit x - 1 for GPIO x
+	uint32_t rgdwKeyResync[(IOXP_KEY_STATES + 31) >> 5];	// keys to release after a FIFO overflow
+	uint32_t rgdwKeyResyncUp[(IOXP_KEY_STATES + 31) >> 5];	// keys released by a resync, their FIFO release is dropped
+	uint32_t dwGpiResync;						// GPIs that changed state without an event, after a FIFO overflow
+	uint32_t dwResyncTimeUS;					// time window of the lost events, given to the resync events
+	uint32_t dwResyncErrUS;
+	uint32_t dwFifoOverflows;					// OVERFLOW_INT seen by Service and DrainFIFO
+	uint32_t dwLostEvents;						// estimated number of events lost in the overflows
+	uint8_t rgbShadow[IOXP_NO_REGS];					// write-through copy of the register map
+	uint8_t rgbShadowValid[(IOXP_NO_REGS + 7) >> 3];	// one bit per register, set when rgbShadow holds the device value
+	bool fCacheEn;
+	bool fBatch;
+	uint8_t rgbBatchVal[IOXP_NO_REGS];		// register values staged by BeginBatch
+	uint8_t rgbBatchMask[IOXP_NO_REGS];		// staged bits of each register, 0 when not staged
+	uint8_t bI2CAddr;						// 7-bit I2C address of the device
+	TwoWire *pWire;							// I2C bus used for all the transfers
+	uint8_t bLastI2CStatus;
+	uint8_t bRetries;						// retries per transfer, see SetRetryPolicy
+	uint16_t wBackoffUS;
+	uint32_t dwTimeoutUS;
+	uint8_t bSclPin;						// pins used by RecoverBus, IOXP_NO_PIN if none
+	uint8_t bSdaPin;
+	IOXPBusErrors busErrors;
+	uint32_t dwBusBytes;
+	uint32_t dwBusConditions;
+	uint32_t dwCacheSavedReads;
+	uint32_t dwCacheSavedWrites;
+	IOXPEventQueue *pEvtQueue;
+	IOXPDispatchTable *pDispatch;			// handlers called by ServiceDevice, NULL if none
+	volatile bool fIntPending;				// set on the INT falling edge, cleared by Service
+	uint8_t bLastIntStatus;					// INT_STATUS read by the last ServiceDevice
+	volatile uint32_t dwIntTimeUS;			// micros() at the INT edge that set fIntPending
+	uint32_t dwLastFifoUS;					// micros() when the FIFO was last emptied
+	uint32_t dwBeginUS;						// duration of the last begin
+	IOXPRequest *pReqHead;					// request run by PollRequests, NULL if none
+	IOXPRequest *pReqTail;					// last submitted request
+	uint8_t bReqChunk;						// bytes per PollRequests step
 public:
-	IOXP();
-	void begin();
+	IOXP(uint8_t bI2CAddr = IOXP_I2C_ADDR, TwoWire *pWire = NULL);
+	uint8_t begin(uint8_t bOptions = 0, const uint8_t *rgbImage = NULL);
+	uint32_t GetBeginTimeUS();
 	void SetRegister(uint8_t bAddress, uint8_t bValue);	
 	uint8_t GetRegister(uint8_t bAddress);
 	void SetRegisterBit(uint16_t wBitDef, uint8_t bBitVal);
@@ -371,10 +978,37 @@ public:
 	void SetRegisterBitsGroup(uint16_t wBitDef, uint8_t bBitsVal);
 	uint8_t GetRegisterBitsGroup(uint16_t wBitDef);
 
+	// typed access to a register field, e.g. SetField<IOXP_FIELD_CLK_DIV>(3)
+	template<class F> void SetField(uint8_t bVal)
+	{
+		if(F::bFieldMask == 0xFF)
+		{
+			WriteBytesI2C(F::bAddress, 1, &bVal);
+		}
+		else
+		{
+			WriteMaskedRegisterValue(F::bAddress, F::bFieldMask, (uint8_t)(bVal << F::bShift));
+		}
+	}
+	template<class F> uint8_t GetField()
+	{
+		return ReadMaskedRegisterValue(F::bAddress, F::bFieldMask) >> F::bShift;
+	}
+
 	void SetKeyboardPinConfig(uint8_t bRowCfg, uint16_t wColCfg);
 	void ReadFIFO(int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState);
+	uint8_t DrainFIFO(IOXPEvent *rgEvents, uint8_t bMaxEvents);
 
 	void ConfigureInterrupt(uint8_t bParExtIntNo, uint16_t wEventMask, void (*pfIntHandler)());
+	void ConfigureEventQueue(uint8_t bParExtIntNo, uint16_t wEventMask, IOXPEventQueue *pQueue);
+	uint8_t Service(bool fPoll = false);
+
+	// event subscriptions, handlers called by Service; bStates is a combination of IOXP_ON_... values
+	void SetDispatchTable(IOXPDispatchTable *pTable);
+	uint8_t OnKey(uint8_t bRow, uint8_t bCol, IOXPEventHandler pfnHandler, uint8_t bStates = IOXP_ON_PRESS);
+	uint8_t OnKeyVal(int iKeyVal, IOXPEventHandler pfnHandler, uint8_t bStates = IOXP_ON_PRESS);
+	uint8_t OnGpi(uint8_t bGPI, IOXPEventHandler pfnHandler, uint8_t bStates = IOXP_ON_BOTH);
+	uint8_t OnLogic(uint8_t bLogic, IOXPEventHandler pfnHandler, uint8_t bStates = IOXP_ON_BOTH);
 	
 	
 	// under construction not fully working
@@ -430,6 +1064,7 @@ public:
 	
 	uint32_t GetGPIIntStat();
 	uint32_t GetGPIStat();
+	uint8_t ReadSnapshot(IOXPSnapshot &snap);
 
 	void SetGPIIntLevel(uint32_t dwBitMap);
 	uint32_t GetGPIIntLevel();
@@ -442,6 +1077,13 @@ public:
 
 	void SetGPODataOut(uint32_t dwBitMap);
 	uint32_t GetGPODataOut();
+
+	// GPO outputs through the output latch, bit x - 1 of the masks is GPIO x
+	uint8_t GpoSet(uint32_t dwMask);
+	uint8_t GpoClear(uint32_t dwMask);
+	uint8_t GpoToggle(uint32_t dwMask);
+	uint8_t GpoWrite(uint32_t dwMask, uint32_t dwValue);
+	uint32_t GpoRead();
 	
 	void SetGPOOutMode(uint32_t dwBitMap);
 	uint32_t GetGPOOutMode();
@@ -475,7 +1117,149 @@ public:
 	uint8_t GetCoreFreq();
 	
 	
-	void SetKeyMap(int table[IOXP_KB_ROWS][IOXP_KB_COLS]);
+	// installs a key map of int8_t, int16_t or int (int32_t) values; the table is referenced, not copied,
+	// so it must stay valid (a const table is kept in flash), and SetKeyMap must be called again if it is changed
+	template<class T> uint8_t SetKeyMap(const T table[IOXP_KB_ROWS][IOXP_KB_COLS])
+	{
+		IOXP_STATIC_ASSERT((T)-1 < 0, key_map_type_must_be_signed);
+		IOXP_STATIC_ASSERT(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4, key_map_type_size);
+		return SetKeyMapTable(table, sizeof(T));
+	}
+	void GetKeyByVal(int iKeyVal, uint8_t &bRow, uint8_t &bCol);
+
+	// pressed keys, updated by ReadFIFO, DrainFIFO and Service; no I2C access
+	bool IsKeyDown(uint8_t bRow, uint8_t bCol);
+	bool IsKeyDownByVal(int iKeyVal);
+	uint8_t GetKeyDownCount();
+	uint8_t GetNextKeyDown(uint8_t bKeyIdx, uint8_t &bRow, uint8_t &bCol);
+	void ClearKeyState();
+
+	// device FIFO overflows, see Service
+	uint32_t GetFifoOverflowCount();
+	uint32_t GetLostEventCount();
+	void ResetOverflowCounters();
+
+	void EnableRegisterCache(bool fEnable);
+	void InvalidateRegisterCache();
+	void GetRegisterCacheStats(uint32_t &dwSavedReads, uint32_t &dwSavedWrites);
+	void ResetRegisterCacheStats();
+
+	void BeginBatch();
+	uint8_t CommitBatch();
+
+	// declarative configuration, see IOXPConfig
+	static void InitConfig(IOXPConfig &cfg);
+	static void BuildConfigImage(const IOXPConfig &cfg, uint8_t *rgbImage);
+	uint8_t ReadConfig(IOXPConfig &cfg);
+	uint8_t ApplyConfig(const IOXPConfig &cfg);
+	uint8_t ApplyConfigImage(const uint8_t *rgbImage);
+	uint8_t WriteConfigRanges(const uint8_t *rgbImage, const IOXPRange *rgRanges, uint8_t bCntRanges);
+	// writes the configuration Cfg (see IOXPDefaultConfig) to a device in its reset state
+	template<class Cfg> uint8_t WriteConfig()
+	{
+		return WriteConfigRanges(IOXPImage<Cfg>::rgbImage, IOXPImage<Cfg>::rgRanges, IOXPImage<Cfg>::bCntRanges);
+	}
+
+	// register transfers run in steps from loop(), see IOXPRequest
+	uint8_t SubmitRead(IOXPRequest &req, uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbBuf,
+		IOXPRequestHandler pfnDone = NULL, void *pvContext = NULL);
+	uint8_t SubmitWrite(IOXPRequest &req, uint8_t bAddress, uint8_t bCntBytes, uint8_t *rgbBuf,
+		IOXPRequestHandler pfnDone = NULL, void *pvContext = NULL);
+	uint8_t PollRequests();
+	void SetRequestChunk(uint8_t bCntBytes);
+
+	uint8_t GetLastI2CStatus();
+
+	// error handling of all the transfers
+	void SetRetryPolicy(uint8_t bRetries, uint16_t wBackoffUS = IOXP_RETRY_BACKOFF_US, uint32_t dwTimeoutUS = IOXP_CALL_TIMEOUT_US);
+	void SetBusRecoveryPins(uint8_t bSclPin, uint8_t bSdaPin);
+	uint8_t RecoverBus();
+	const IOXPBusErrors &GetBusErrors();
+	void ResetBusErrors();
+
+	void GetBusCost(uint32_t &dwBytes, uint32_t &dwConditions);
+	uint32_t GetBusTimeUS(uint32_t dwSclHz);
+	void ResetBusCost();
+
+#if defined(IOXP_PROFILE)
+	const IOXPStats &GetStats();
+	void ResetStats();
+	void DumpStats(Print &out);
+#endif
+};
+
+// GPIO x (1 - 19, GPIO 1 - 8 are R0 - R7, GPIO 9 - 19 are C0 - C10) known at compile time, e.g.
+// IOXPPin<12> led(ioxp); led.Write(true). The register addresses and masks are constants and each
+// call is a single masked update of one register through the register shadow (IOXP::UpdateLatchBits):
+// one write, and no write at all when the register already holds the value.
+template<uint8_t Pin>
+struct IOXPPin {
+	IOXP_STATIC_ASSERT(Pin >= 1 && Pin <= IOXP_GPIOS, gpio_pin_out_of_range);
+	enum {
+		bBank = (Pin - 1) >> 3,
+		bMask = 1 << ((Pin - 1) & 7),
+		bPullIdx = (Pin <= IOXP_KB_ROWS) ? (Pin - 1) : (Pin - 1 - IOXP_KB_ROWS),	// row or column number
+		bPullAddr = ((Pin <= IOXP_KB_ROWS) ? IOXP_ADDR_RPULL_CONFIG_A : IOXP_ADDR_RPULL_CONFIG_C) + (bPullIdx >> 2),
+		bPullShift = (bPullIdx & 3) << 1,
+		bPullMask = 3 << bPullShift
+	};
+	IOXP &dev;
+	IOXPPin(IOXP &dev) : dev(dev) {}
+	// output level, in GPO_DATA_OUT
+	uint8_t Write(bool fHigh)
+	{
+		return dev.UpdateLatchBits(IOXP_ADDR_GPO_DATA_OUT_A + bBank, bMask, fHigh ? bMask : 0);
+	}
+	// input level, from GPI_STATUS (one register read); fHigh is not changed on an I2C error
+	uint8_t Read(bool &fHigh)
+	{
+		uint8_t bVal;
+		uint8_t bStatus = dev.ReadBytesI2C(IOXP_ADDR_GPI_STATUS_A + bBank, 1, &bVal);
+		if(bStatus == IOXP_I2C_OK)
+		{
+			fHigh = (bVal & bMask) != 0;
+		}
+		return bStatus;
+	}
+	uint8_t SetDirection(bool fOutput)
+	{
+		return dev.UpdateLatchBits(IOXP_ADDR_GPIO_DIRECTION_A + bBank, bMask, fOutput ? bMask : 0);
+	}
+	// bPull is one of the IOXP_RPULL_CONFIG_... values
+	uint8_t SetPull(uint8_t bPull)
+	{
+		return dev.UpdateLatchBits(bPullAddr, bPullMask, (uint8_t)(bPull << bPullShift));
+	}
+	// GPI debounce, enabled at reset (DEBOUNCE_DIS bit cleared)
+	uint8_t SetDebounce(bool fEnable)
+	{
+		return dev.UpdateLatchBits(IOXP_ADDR_DEBOUNCE_DIS_A + bBank, bMask, fEnable ? 0 : bMask);
+	}
+};
+
+// Devices sharing one (open-drain, wired-OR) INT line: Service scans them in a configurable order and
+// merges their events in one queue, tagged with the device index.
+IOXP_STATIC_ASSERT(IOXP_GROUP_MAX_DEVICES <= 8, group_scan_order_mask);
+class IOXPGroup {
+private:
+	IOXP *rgpDev[IOXP_GROUP_MAX_DEVICES];
+	uint8_t rgbScanOrder[IOXP_GROUP_MAX_DEVICES];
+	uint8_t bCntDev;
+	IOXPEventQueue *pEvtQueue;
+	volatile bool fIntPending;				// set on the INT falling edge, cleared by Service
+	volatile uint32_t dwIntTimeUS;			// micros() at the INT edge that set fIntPending
+	uint32_t dwMaxServiceUS;
+	uint32_t dwLastServiceUS;
+public:
+	IOXPGroup();
+	uint8_t AddDevice(IOXP *pDevice);
+	uint8_t SetScanOrder(const uint8_t *rgbOrder);
+	uint8_t GetDeviceCount();
+	void ConfigureEventQueue(uint8_t bParExtIntNo, uint16_t wEventMask, IOXPEventQueue *pQueue);
+	uint8_t Service(bool fPoll = false);
+	uint32_t GetMaxServiceTimeUS();
+	uint32_t GetLastServiceTimeUS();
+	void ResetServiceStats();
 };
 
 
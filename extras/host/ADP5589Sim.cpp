@@ -0,0 +1,228 @@
+/************************************************************************/
+/*																		*/
+/*	ADP5589Sim.cpp	--	Host model of the ADP5589 I/O expander			*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		See ADP5589Sim.h.												*/
+/*																		*/
+/************************************************************************/
+#include "ADP5589Sim.h"
+
+#define SIM_INT_BITS	0x3F	// INT_STATUS bits with an enable in INT_EN
+#define SIM_GPI_MASK	(((uint32_t)1 << IOXP_GPIOS) - 1)
+
+ADP5589Sim::ADP5589Sim()
+{
+	bIntLine = SIM_NO_INT_LINE;
+	Reset();
+}
+
+/* Power on state: registers 0, except the ID (MAN_ID 1, REV 0), empty FIFO, INT high. */
+void ADP5589Sim::Reset()
+{
+	memset(rgbReg, 0, sizeof(rgbReg));
+	rgbReg[IOXP_ADDR_ID] = IOXP_ID_MAN_ID_ADP5589 << 4;
+	bCntFifo = 0;
+	bPtr = 0;
+	fPtrSet = false;
+	fIntLow = false;
+	bCntSched = 0;
+	dwLostEvents = 0;
+	dwFifoReads = 0;
+}
+
+/* Falling edges of INT run the handler of external interrupt bExtIntNo, see attachInterrupt. */
+void ADP5589Sim::SetIntLine(uint8_t bExtIntNo)
+{
+	bIntLine = bExtIntNo;
+}
+
+uint32_t ADP5589Sim::Get24(uint8_t bAddress)
+{
+	return rgbReg[bAddress] | ((uint32_t)rgbReg[bAddress + 1] << 8) | ((uint32_t)rgbReg[bAddress + 2] << 16);
+}
+
+void ADP5589Sim::Set24(uint8_t bAddress, uint32_t dwVal)
+{
+	rgbReg[bAddress] = (uint8_t)dwVal;
+	rgbReg[bAddress + 1] = (uint8_t)(dwVal >> 8);
+	rgbReg[bAddress + 2] = (uint8_t)(dwVal >> 16);
+}
+
+/* STATUS EC, EVENT_INT (set while the FIFO is not empty) and the INT output. */
+void ADP5589Sim::UpdateStatus()
+{
+	rgbReg[IOXP_ADDR_STATUS] = (rgbReg[IOXP_ADDR_STATUS] & ~(uint8_t)IOXP_STATUS_EC) | bCntFifo;
+	if(bCntFifo != 0)
+	{
+		rgbReg[IOXP_ADDR_INT_STATUS] |= (uint8_t)IOXP_INT_STATUS_EVENT_INT;
+	}
+	bool fLow = (rgbReg[IOXP_ADDR_INT_STATUS] & rgbReg[IOXP_ADDR_INT_EN] & SIM_INT_BITS) != 0;
+	bool fEdge = fLow && !fIntLow;
+	fIntLow = fLow;
+	if(fEdge && bIntLine != SIM_NO_INT_LINE)
+	{
+		HostFireInterrupt(bIntLine);
+	}
+}
+
+/* Adds the events whose time has come, in time order. */
+void ADP5589Sim::RunSchedule()
+{
+	bool fFound = true;
+	while(fFound)
+	{
+		fFound = false;
+		uint8_t bFirst = 0;
+		for(uint8_t bIdx = 0; bIdx < bCntSched; bIdx++)
+		{
+			if((int32_t)(micros() - rgdwSchedUS[bIdx]) >= 0 &&
+				(!fFound || (int32_t)(rgdwSchedUS[bIdx] - rgdwSchedUS[bFirst]) < 0))
+			{
+				bFirst = bIdx;
+				fFound = true;
+			}
+		}
+		if(fFound)
+		{
+			uint8_t bEvent = rgbSchedEvent[bFirst];
+			bCntSched--;
+			for(uint8_t bIdx = bFirst; bIdx < bCntSched; bIdx++)
+			{
+				rgdwSchedUS[bIdx] = rgdwSchedUS[bIdx + 1];
+				rgbSchedEvent[bIdx] = rgbSchedEvent[bIdx + 1];
+			}
+			PushEvent(bEvent);
+		}
+	}
+}
+
+/* Adds one entry to the FIFO. A full FIFO drops it and sets OVERFLOW_INT. */
+void ADP5589Sim::PushEvent(uint8_t bEvent)
+{
+	if(bCntFifo >= IOXP_FIFO_DEPTH)
+	{
+		rgbReg[IOXP_ADDR_INT_STATUS] |= (uint8_t)IOXP_INT_STATUS_OVERFLOW_INT;
+		dwLostEvents++;
+	}
+	else
+	{
+		rgbFifo[bCntFifo++] = bEvent;
+	}
+	UpdateStatus();
+}
+
+/* Adds bEvent to the FIFO once micros() reaches dwTimeUS, checked at every byte of a transfer. */
+void ADP5589Sim::ScheduleEvent(uint32_t dwTimeUS, uint8_t bEvent)
+{
+	if(bCntSched < SIM_MAX_SCHEDULED)
+	{
+		rgdwSchedUS[bCntSched] = dwTimeUS;
+		rgbSchedEvent[bCntSched] = bEvent;
+		bCntSched++;
+	}
+}
+
+void ADP5589Sim::PressKey(uint8_t bRow, uint8_t bCol)
+{
+	PushEvent((IOXP_EVENT_ID_KEY + bRow * IOXP_KB_COLS + bCol) | 0x80);
+}
+
+void ADP5589Sim::ReleaseKey(uint8_t bRow, uint8_t bCol)
+{
+	PushEvent(IOXP_EVENT_ID_KEY + bRow * IOXP_KB_COLS + bCol);
+}
+
+/* ------------------------------------------------------------ */
+/*	Changes the level of GPI bGPI (1 - 19). GPI_STATUS follows	*/
+/*	the level. A GPI is active when its level matches			*/
+/*	GPI_INT_LEVEL. With GPI_EVENT_EN both edges go to the FIFO	*/
+/*	(bit 7 set when active); otherwise, with GPI_INTERRUPT_EN,	*/
+/*	becoming active sets GPI_INT_STAT and GPI_INT.				*/
+/* ------------------------------------------------------------ */
+void ADP5589Sim::SetGpi(uint8_t bGPI, bool fHigh)
+{
+	uint32_t dwBit = (uint32_t)1 << (bGPI - 1);
+	uint32_t dwStatus = Get24(IOXP_ADDR_GPI_STATUS_A);
+	if(((dwStatus & dwBit) != 0) == fHigh)
+	{
+		return;
+	}
+	dwStatus ^= dwBit;
+	Set24(IOXP_ADDR_GPI_STATUS_A, dwStatus);
+	bool fActive = ((dwStatus ^ ~Get24(IOXP_ADDR_GPI_INT_LEVEL_A)) & dwBit) != 0;
+	if(Get24(IOXP_ADDR_GPI_EVENT_EN_A) & dwBit)
+	{
+		PushEvent((IOXP_EVENT_ID_GPI + bGPI - 1) | (fActive ? 0x80 : 0));
+	}
+	else if(fActive && (Get24(IOXP_ADDR_GPI_INTERRUPT_EN_A) & dwBit))
+	{
+		Set24(IOXP_ADDR_GPI_INT_STATUS_A, (Get24(IOXP_ADDR_GPI_INT_STATUS_A) | dwBit) & SIM_GPI_MASK);
+		rgbReg[IOXP_ADDR_INT_STATUS] |= (uint8_t)IOXP_INT_STATUS_GPI_INT;
+		UpdateStatus();
+	}
+}
+
+void ADP5589Sim::Start(bool fRead)
+{
+	// a write sets the address pointer with its first byte, a read goes on from the pointer
+	fPtrSet = fRead;
+	RunSchedule();
+}
+
+bool ADP5589Sim::Write(uint8_t bVal)
+{
+	RunSchedule();
+	if(!fPtrSet)
+	{
+		bPtr = bVal;
+		fPtrSet = true;
+		return true;
+	}
+	if(bPtr == IOXP_ADDR_INT_STATUS)
+	{
+		// write 1 to clear; EVENT_INT stays set while the FIFO holds events
+		rgbReg[IOXP_ADDR_INT_STATUS] &= ~bVal;
+		UpdateStatus();
+	}
+	else if(bPtr > IOXP_ADDR_VOLATILE_LAST && bPtr < IOXP_NO_REGS)
+	{
+		rgbReg[bPtr] = bVal;
+		if(bPtr == IOXP_ADDR_INT_EN)
+		{
+			UpdateStatus();
+		}
+	}
+	// ID, STATUS, FIFO and GPI status registers are read only
+	bPtr++;
+	return true;
+}
+
+uint8_t ADP5589Sim::Read()
+{
+	RunSchedule();
+	uint8_t bVal = 0;
+	if(bPtr >= IOXP_ADDR_FIFO1 && bPtr <= IOXP_ADDR_FIFO16)
+	{
+		// every FIFO address pops the oldest event, 0 when empty
+		dwFifoReads++;
+		if(bCntFifo != 0)
+		{
+			bVal = rgbFifo[0];
+			bCntFifo--;
+			memmove(rgbFifo, rgbFifo + 1, bCntFifo);
+			UpdateStatus();
+		}
+	}
+	else if(bPtr < IOXP_NO_REGS)
+	{
+		bVal = rgbReg[bPtr];
+		if(bPtr >= IOXP_ADDR_GPI_INT_STATUS_A && bPtr <= IOXP_ADDR_GPI_INT_STATUS_C)
+		{
+			rgbReg[bPtr] = 0;	// clear on read
+		}
+	}
+	bPtr++;
+	return bVal;
+}
@@ -0,0 +1,74 @@
+/************************************************************************/
+/*																		*/
+/*	ADP5589Sim.h	--	Host model of the ADP5589 I/O expander			*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		A device model for the fake Wire (Wire.h). It holds the			*/
+/*		register file with the auto-incremented address pointer, the	*/
+/*		16 entry event FIFO with its event count (STATUS EC) and		*/
+/*		OVERFLOW_INT, the GPI status and GPI interrupt status			*/
+/*		registers, INT_STATUS with its write 1 to clear bits and the	*/
+/*		active low INT output, which can be wired to an external		*/
+/*		interrupt of the simulated core.								*/
+/*		Key and GPI changes are made by the test; events can also be	*/
+/*		scheduled at a simulated time, so they land in the middle of a	*/
+/*		transfer. Lock, reset, PWM and logic blocks are not modeled:	*/
+/*		their registers are plain storage.								*/
+/*																		*/
+/************************************************************************/
+#if !defined(ADP5589_SIM_H)
+#define ADP5589_SIM_H
+
+#include "WProgram.h"
+#include "Wire.h"
+#include "IOXP.h"
+
+#define SIM_NO_INT_LINE		0xFF	// INT not wired to an external interrupt
+#define SIM_MAX_SCHEDULED	16		// events waiting for their time
+
+class ADP5589Sim : public HostI2CDevice
+{
+private:
+	uint8_t rgbFifo[IOXP_FIFO_DEPTH];
+	uint8_t bCntFifo;
+	uint8_t bPtr;
+	bool fPtrSet;
+	bool fIntLow;
+	uint8_t bIntLine;
+	uint32_t rgdwSchedUS[SIM_MAX_SCHEDULED];
+	uint8_t rgbSchedEvent[SIM_MAX_SCHEDULED];
+	uint8_t bCntSched;
+
+	uint32_t Get24(uint8_t bAddress);
+	void Set24(uint8_t bAddress, uint32_t dwVal);
+	void RunSchedule();
+	void UpdateStatus();
+
+public:
+	uint8_t rgbReg[IOXP_NO_REGS];	// register file, INT_STATUS / STATUS / FIFO included
+	uint32_t dwLostEvents;			// events dropped because the FIFO was full
+	uint32_t dwFifoReads;			// FIFO entries popped by reads, empty reads included
+
+	ADP5589Sim();
+	void Reset();
+	void SetIntLine(uint8_t bExtIntNo);
+
+	/* stimulus */
+	void PushEvent(uint8_t bEvent);
+	void ScheduleEvent(uint32_t dwTimeUS, uint8_t bEvent);
+	void PressKey(uint8_t bRow, uint8_t bCol);
+	void ReleaseKey(uint8_t bRow, uint8_t bCol);
+	void SetGpi(uint8_t bGPI, bool fHigh);
+
+	/* observation */
+	uint8_t GetEventCount()			{ return bCntFifo; }
+	bool IsIntAsserted()			{ return fIntLow; }
+
+	/* HostI2CDevice */
+	void Start(bool fRead);
+	bool Write(uint8_t bVal);
+	uint8_t Read();
+};
+
+#endif
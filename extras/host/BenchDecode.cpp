@@ -0,0 +1,105 @@
+/************************************************************************/
+/*																		*/
+/*	BenchDecode.cpp	--	Throughput of the FIFO event decoder			*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		Decodes a stream of 64k FIFO event bytes (70% keys, 20% GPIs,	*/
+/*		10% Logic, random states) 400 times with IOXP::DecodeEvent		*/
+/*		and with the range compare decoder it replaced, and prints		*/
+/*		the events per second of each. Host numbers only show the		*/
+/*		relative cost; run "make bench".								*/
+/*																		*/
+/************************************************************************/
+#include <stdlib.h>
+#include <time.h>
+#include "ADP5589Sim.h"
+#include "IOXPHostTest.h"
+
+#define BENCH_EVENTS	(1 << 16)
+#define BENCH_ROUNDS	400
+
+/* The decoder before the event table, key map lookup included (with its Logic / row 8 / 116 bugs). */
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+static void RangeDecode(uint8_t bEvent, int &iKeyVal, uint8_t &bRow, uint8_t &bCol, uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+{
+	bEventState = (bEvent & 0x80) != 0 ? 1 : 0;
+	uint8_t bEventNo = bEvent & 0x7F;
+	iKeyVal = -1;
+	bRow = 0xFF;
+	bCol = 0xFF;
+	bGPI = 0xFF;
+	bLogic = 0xFF;
+	if(bEventNo >= 1 && bEventNo <= IOXP_KB_ROWS * IOXP_KB_COLS)
+	{
+		bRow = (uint8_t)((bEventNo - 1) / IOXP_KB_COLS);
+		bCol = bEventNo - 1 - IOXP_KB_COLS * bRow;
+		if(bRow <= IOXP_KB_ROWS && bCol <= IOXP_KB_COLS)
+		{
+			iKeyVal = keyMap_KYPD[bRow][bCol];
+		}
+	}
+	else if(bEventNo <= 1 + IOXP_KB_ROWS * (IOXP_KB_COLS + 1))
+	{
+		bRow = bEventNo - (1 + IOXP_KB_ROWS * IOXP_KB_COLS);
+	}
+	else if(bEventNo <= 1 + IOXP_KB_ROWS * (IOXP_KB_COLS + 1) + IOXP_GPIOS)
+	{
+		bGPI = bEventNo - (IOXP_KB_ROWS * (IOXP_KB_COLS + 1));
+	}
+	else if(bEventNo <= 1 + IOXP_KB_ROWS * (IOXP_KB_COLS + 1) + IOXP_GPIOS + IOXP_NO_LOGIC)
+	{
+		bGPI = bEventNo - (IOXP_KB_ROWS * (IOXP_KB_COLS + 1) + IOXP_GPIOS);
+	}
+}
+
+static uint8_t rgbStream[BENCH_EVENTS];
+
+int main()
+{
+	IOXP ioxp;
+	int iKeyVal;
+	uint8_t bRow, bCol, bGPI, bLogic, bEventState;
+	long lSum = 0;
+	int nRound, nIdx;
+	clock_t tStart;
+
+	srand(1);
+	for(nIdx = 0; nIdx < BENCH_EVENTS; nIdx++)
+	{
+		int iKind = rand() % 10;
+		uint8_t bId = (iKind < 7) ? IOXP_EVENT_ID_KEY + rand() % (IOXP_KB_ROWS * IOXP_KB_COLS) :
+					  (iKind < 9) ? IOXP_EVENT_ID_GPI + rand() % IOXP_GPIOS : IOXP_EVENT_ID_LOGIC + rand() % IOXP_NO_LOGIC;
+		rgbStream[nIdx] = bId | (rand() & 0x80);
+	}
+
+	tStart = clock();
+	for(nRound = 0; nRound < BENCH_ROUNDS; nRound++)
+	{
+		for(nIdx = 0; nIdx < BENCH_EVENTS; nIdx++)
+		{
+			RangeDecode(rgbStream[nIdx], iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+			lSum += iKeyVal + bRow + bCol + bGPI + bLogic + bEventState;
+		}
+	}
+	double dRangeS = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+
+	tStart = clock();
+	for(nRound = 0; nRound < BENCH_ROUNDS; nRound++)
+	{
+		for(nIdx = 0; nIdx < BENCH_EVENTS; nIdx++)
+		{
+			IOXPHostTest::DecodeEvent(ioxp, rgbStream[nIdx], iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+			lSum += iKeyVal + bRow + bCol + bGPI + bLogic + bEventState;
+		}
+	}
+	double dTableS = (double)(clock() - tStart) / CLOCKS_PER_SEC;
+
+	double dEvents = (double)BENCH_EVENTS * BENCH_ROUNDS;
+	printf("range compare decoder: %7.1f Mevents/s\n", dEvents / dRangeS / 1e6);
+	printf("DecodeEvent (table):   %7.1f Mevents/s\n", dEvents / dTableS / 1e6);
+	printf("speedup x%.2f (checksum %ld)\n", dRangeS / dTableS, lSum & 0xFF);
+	return 0;
+}
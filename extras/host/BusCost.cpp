@@ -0,0 +1,98 @@
+/************************************************************************/
+/*																		*/
+/*	BusCost.cpp	--	Bus cost of the IOXP API calls						*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		Runs a set of API calls against the ADP5589 model and prints,	*/
+/*		for each one, the bytes and conditions seen on the fake bus		*/
+/*		and their wire time at 100 kHz and 400 kHz. The counters of		*/
+/*		the object (GetBusCost / GetBusTimeUS) are checked against the	*/
+/*		bus; the exit code is 1 if they disagree.						*/
+/*																		*/
+/************************************************************************/
+#include "ADP5589Sim.h"
+#include "HostTest.h"
+
+static ADP5589Sim dev;
+static IOXP ioxp;
+
+/* Prints the traffic since the last Reset and checks the object counters. */
+static void Report(const char *szCall)
+{
+	const HostWireStats &stats = Wire.GetStats();
+	uint32_t dwBytes, dwConditions;
+	ioxp.GetBusCost(dwBytes, dwConditions);
+	printf("%-36s %3u %5u %5u %6u %7u %7u\n", szCall,
+		(unsigned)Wire.GetLogCount(), (unsigned)(stats.dwStarts - stats.dwRestarts), (unsigned)stats.dwRestarts,
+		(unsigned)stats.dwBytes, (unsigned)Wire.GetWireTimeUS(IOXP_I2C_CLK_100K),
+		(unsigned)Wire.GetWireTimeUS(IOXP_I2C_CLK_400K));
+	HOST_CHECK_EQ(dwBytes, stats.dwBytes);
+	HOST_CHECK_EQ(dwConditions, stats.dwStarts + stats.dwStops);
+	HOST_CHECK_EQ(ioxp.GetBusTimeUS(IOXP_I2C_CLK_100K), Wire.GetWireTimeUS(IOXP_I2C_CLK_100K));
+	HOST_CHECK_EQ(ioxp.GetBusTimeUS(IOXP_I2C_CLK_400K), Wire.GetWireTimeUS(IOXP_I2C_CLK_400K));
+	Wire.ResetStats();
+	ioxp.ResetBusCost();
+}
+
+#define MEASURE(szCall, stmt)	do { Wire.ResetStats(); ioxp.ResetBusCost(); stmt; Report(szCall); } while(0)
+
+int main()
+{
+	IOXPEvent rgEvents[IOXP_FIFO_DEPTH];
+	IOXPEventRing<32> queue;
+	IOXPSnapshot snap;
+	IOXPConfig cfg;
+	IOXPRequest req;
+	uint8_t rgbBuf[8];
+	int nIdx;
+
+	Wire.Attach(IOXP_I2C_ADDR, &dev);
+	printf("%-36s %3s %5s %5s %6s %7s %7s\n", "call", "xfr", "start", "rstrt", "bytes", "us@100k", "us@400k");
+
+	MEASURE("begin()", ioxp.begin());
+	MEASURE("begin(IOXP_BEGIN_RESET_CFG)", ioxp.begin(IOXP_BEGIN_RESET_CFG));
+	MEASURE("GetRegister(ID)", ioxp.GetRegister(IOXP_ADDR_ID));
+	MEASURE("SetRegister(POLL_TIME_CFG)", ioxp.SetRegister(IOXP_ADDR_POLL_TIME_CFG, 1));
+	MEASURE("SetPollTime (masked)", ioxp.SetPollTime(2));
+	MEASURE("SetGPIODirection", ioxp.SetGPIODirection(0x7FFFF));
+	MEASURE("GetGPIStat", ioxp.GetGPIStat());
+	MEASURE("GpoSet, cache off", ioxp.GpoSet(0x00003));
+	MEASURE("GpoToggle, cache off", ioxp.GpoToggle(0x10001));
+	ioxp.EnableRegisterCache(true);
+	ioxp.GpoRead();
+	ioxp.GetPollTime();
+	MEASURE("GpoSet, cache on", ioxp.GpoSet(0x00004));
+	MEASURE("GpoToggle, cache on", ioxp.GpoToggle(0x10001));
+	MEASURE("SetPollTime, cache on, same value", ioxp.SetPollTime(2));
+	ioxp.EnableRegisterCache(false);
+	MEASURE("ReadSnapshot", ioxp.ReadSnapshot(snap));
+	MEASURE("ReadConfig", ioxp.ReadConfig(cfg));
+	IOXP::InitConfig(cfg);
+	MEASURE("ApplyConfig(defaults)", ioxp.ApplyConfig(cfg));
+	MEASURE("BeginBatch, 3 setters, CommitBatch",
+		ioxp.BeginBatch(); ioxp.SetPollTime(3); ioxp.SetGPIEventEn(0x00100); ioxp.SetGPIODirection(0x00FF); ioxp.CommitBatch());
+	MEASURE("ConfigureEventQueue", ioxp.ConfigureEventQueue(0, IOXP_INT_STATUS_EVENT_INT, &queue));
+
+	MEASURE("Service(true), FIFO empty", ioxp.Service(true));
+	for(nIdx = 0; nIdx < 3; nIdx++)
+	{
+		dev.PressKey(0, nIdx);
+	}
+	MEASURE("Service(true), 3 events", ioxp.Service(true));
+	for(nIdx = 0; nIdx < 10; nIdx++)
+	{
+		dev.PressKey(1, nIdx);
+	}
+	MEASURE("Service(true), 10 events", ioxp.Service(true));
+	for(nIdx = 0; nIdx < 8; nIdx++)
+	{
+		dev.ReleaseKey(1, nIdx);
+	}
+	MEASURE("DrainFIFO, 8 events", ioxp.DrainFIFO(rgEvents, IOXP_FIFO_DEPTH));
+	MEASURE("SubmitRead 8 bytes + PollRequests",
+		ioxp.SubmitRead(req, IOXP_ADDR_GPIO_DIRECTION_A, sizeof(rgbBuf), rgbBuf, NULL, NULL);
+		while(req.bState != IOXP_REQ_DONE) { ioxp.PollRequests(); });
+
+	HOST_TEST_END("BusCost");
+}
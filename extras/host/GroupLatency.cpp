@@ -0,0 +1,112 @@
+/************************************************************************/
+/*																		*/
+/*	GroupLatency.cpp	--	IOXPGroup::Service time vs group size		*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		Builds groups of 1 to IOXP_GROUP_MAX_DEVICES ADP5589 models on	*/
+/*		Wire and prints the duration of a Service pass (simulated		*/
+/*		time, GetLastServiceTimeUS) with no event and with one event	*/
+/*		on the last device of the scan order, at 100 kHz and 400 kHz.	*/
+/*		The idle pass must grow linearly with the number of devices.	*/
+/*		Also checks that SetScanOrder only takes permutations and		*/
+/*		that the scan follows it.										*/
+/*																		*/
+/************************************************************************/
+#include "ADP5589Sim.h"
+#include "HostTest.h"
+
+static ADP5589Sim rgDev[IOXP_GROUP_MAX_DEVICES];
+
+/* Duration of a pass of a group of bCntDev devices, with an event on the last one if fEvent. */
+static uint32_t MeasurePass(uint8_t bCntDev, uint32_t dwClockHz, bool fEvent)
+{
+	IOXP *rgpIoxp[IOXP_GROUP_MAX_DEVICES];
+	IOXPGroup group;
+	IOXPEventRing<32> queue;
+	IOXPEvent evt;
+	uint8_t bIdx;
+
+	Wire.SetClock(dwClockHz);
+	for(bIdx = 0; bIdx < bCntDev; bIdx++)
+	{
+		rgDev[bIdx].Reset();
+		rgpIoxp[bIdx] = new IOXP(IOXP_I2C_ADDR + bIdx);
+		rgpIoxp[bIdx]->begin();
+		group.AddDevice(rgpIoxp[bIdx]);
+	}
+	group.ConfigureEventQueue(0, IOXP_INT_STATUS_EVENT_INT, &queue);
+	while(group.Service() != 0)
+	{
+	}
+	if(fEvent)
+	{
+		rgDev[bCntDev - 1].PressKey(0, 0);
+	}
+	HOST_CHECK_EQ(group.Service(true), fEvent ? 1 : 0);
+	HOST_CHECK(!fEvent || (queue.Pop(evt) && evt.bDevice == bCntDev - 1));
+	uint32_t dwPassUS = group.GetLastServiceTimeUS();
+	for(bIdx = 0; bIdx < bCntDev; bIdx++)
+	{
+		delete rgpIoxp[bIdx];
+	}
+	return dwPassUS;
+}
+
+int main()
+{
+	uint32_t rgdwIdle1[2];
+	uint8_t bCntDev;
+	uint8_t bIdx;
+
+	for(bIdx = 0; bIdx < IOXP_GROUP_MAX_DEVICES; bIdx++)
+	{
+		Wire.Attach(IOXP_I2C_ADDR + bIdx, &rgDev[bIdx]);
+	}
+
+	printf("%-8s %12s %12s %12s %12s\n", "devices", "idle@100k", "event@100k", "idle@400k", "event@400k");
+	for(bCntDev = 1; bCntDev <= IOXP_GROUP_MAX_DEVICES; bCntDev++)
+	{
+		uint32_t dwIdle100 = MeasurePass(bCntDev, IOXP_I2C_CLK_100K, false);
+		uint32_t dwEvent100 = MeasurePass(bCntDev, IOXP_I2C_CLK_100K, true);
+		uint32_t dwIdle400 = MeasurePass(bCntDev, IOXP_I2C_CLK_400K, false);
+		uint32_t dwEvent400 = MeasurePass(bCntDev, IOXP_I2C_CLK_400K, true);
+		printf("%-8u %12u %12u %12u %12u\n", (unsigned)bCntDev,
+			(unsigned)dwIdle100, (unsigned)dwEvent100, (unsigned)dwIdle400, (unsigned)dwEvent400);
+		if(bCntDev == 1)
+		{
+			rgdwIdle1[0] = dwIdle100;
+			rgdwIdle1[1] = dwIdle400;
+		}
+		// one INT_STATUS / STATUS burst per device
+		HOST_CHECK_EQ(dwIdle100, bCntDev * rgdwIdle1[0]);
+		HOST_CHECK_EQ(dwIdle400, bCntDev * rgdwIdle1[1]);
+		HOST_CHECK(dwEvent100 > dwIdle100 && dwEvent400 > dwIdle400);
+	}
+
+	// SetScanOrder takes permutations only
+	{
+		IOXP ioxp0(IOXP_I2C_ADDR), ioxp1(IOXP_I2C_ADDR + 1), ioxp2(IOXP_I2C_ADDR + 2);
+		IOXPGroup group;
+		const uint8_t rgbDup[] = { 0, 0, 1 };
+		const uint8_t rgbRange[] = { 0, 1, 3 };
+		const uint8_t rgbRev[] = { 2, 1, 0 };
+		group.AddDevice(&ioxp0);
+		group.AddDevice(&ioxp1);
+		group.AddDevice(&ioxp2);
+		HOST_CHECK_EQ(group.SetScanOrder(rgbDup), IOXP_ERR_PARAM);
+		HOST_CHECK_EQ(group.SetScanOrder(rgbRange), IOXP_ERR_PARAM);
+		Wire.ResetStats();
+		group.Service(true);
+		HOST_CHECK_EQ(Wire.GetLog(0).bAddr, IOXP_I2C_ADDR);		// rejected orders leave the default
+		HOST_CHECK_EQ(group.SetScanOrder(rgbRev), IOXP_I2C_OK);
+		Wire.ResetStats();
+		group.Service(true);
+		HOST_CHECK_EQ(Wire.GetLogCount(), 6);
+		HOST_CHECK_EQ(Wire.GetLog(0).bAddr, IOXP_I2C_ADDR + 2);
+		HOST_CHECK_EQ(Wire.GetLog(2).bAddr, IOXP_I2C_ADDR + 1);
+		HOST_CHECK_EQ(Wire.GetLog(4).bAddr, IOXP_I2C_ADDR);
+	}
+
+	HOST_TEST_END("GroupLatency");
+}
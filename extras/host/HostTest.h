@@ -0,0 +1,49 @@
+/************************************************************************/
+/*																		*/
+/*	HostTest.h	--	Checks used by the host tests						*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		HOST_CHECK reports a failed condition and keeps going, so one	*/
+/*		run lists every failure. HOST_TEST_END prints the result and	*/
+/*		returns the exit code of the test program.						*/
+/*																		*/
+/************************************************************************/
+#if !defined(HOST_TEST_H)
+#define HOST_TEST_H
+
+#include <stdio.h>
+
+static int iHostFailures = 0;
+
+#define HOST_CHECK(cond)												\
+	do																	\
+	{																	\
+		if(!(cond))														\
+		{																\
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);	\
+			iHostFailures++;											\
+		}																\
+	} while(0)
+
+#define HOST_CHECK_EQ(val, exp)											\
+	do																	\
+	{																	\
+		long lHostVal = (long)(val);									\
+		long lHostExp = (long)(exp);									\
+		if(lHostVal != lHostExp)										\
+		{																\
+			printf("%s:%d: check failed: %s == %ld, expected %ld\n",	\
+				__FILE__, __LINE__, #val, lHostVal, lHostExp);			\
+			iHostFailures++;											\
+		}																\
+	} while(0)
+
+#define HOST_TEST_END(szName)											\
+	do																	\
+	{																	\
+		printf("%s: %s\n", szName, (iHostFailures == 0) ? "ok" : "FAILED");	\
+		return (iHostFailures == 0) ? 0 : 1;							\
+	} while(0)
+
+#endif
@@ -0,0 +1,31 @@
+/************************************************************************/
+/*																		*/
+/*	IOXPHostTest.h	--	White box access to IOXP for the host tests		*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		IOXPHostTest is a friend of IOXP. It forwards the private		*/
+/*		members that the host tests and benchmarks call directly.		*/
+/*																		*/
+/************************************************************************/
+#if !defined(IOXP_HOST_TEST_H)
+#define IOXP_HOST_TEST_H
+
+#include "IOXP.h"
+
+class IOXPHostTest
+{
+public:
+	static uint8_t DecodeEvent(IOXP &ioxp, uint8_t bEvent, int &iKeyVal, uint8_t &bRow, uint8_t &bCol,
+		uint8_t &bGPI, uint8_t &bLogic, uint8_t &bEventState)
+	{
+		return ioxp.DecodeEvent(bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	}
+	static uint8_t EncodeEvent(IOXP &ioxp, int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI,
+		uint8_t bLogic, uint8_t bEventState)
+	{
+		return ioxp.EncodeEvent(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	}
+};
+
+#endif
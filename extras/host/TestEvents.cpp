@@ -0,0 +1,92 @@
+/************************************************************************/
+/*																		*/
+/*	TestEvents.cpp	--	Host test of the event decoder and encoder		*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		Checks that EncodeEvent is the inverse of DecodeEvent: every	*/
+/*		event byte with a kind encodes back to itself, every valid		*/
+/*		row / column / GPI / Logic encodes to an identifier that		*/
+/*		decodes to it, and invalid arguments give 0xFF.					*/
+/*																		*/
+/************************************************************************/
+#include "ADP5589Sim.h"
+#include "IOXPHostTest.h"
+#include "HostTest.h"
+
+static IOXP ioxp;
+
+static uint8_t Encode(int iKeyVal, uint8_t bRow, uint8_t bCol, uint8_t bGPI, uint8_t bLogic, uint8_t bEventState)
+{
+	return IOXPHostTest::EncodeEvent(ioxp, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+}
+
+int main()
+{
+	int iKeyVal;
+	uint8_t bRow, bCol, bGPI, bLogic, bEventState;
+	uint8_t rgbCntKind[IOXP_EVENT_KINDS] = { 0 };
+	int nEvent;
+
+	// decode -> encode, over every byte
+	for(nEvent = 0; nEvent < 256; nEvent++)
+	{
+		uint8_t bKind = IOXPHostTest::DecodeEvent(ioxp, (uint8_t)nEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+		HOST_CHECK(bKind < IOXP_EVENT_KINDS);
+		HOST_CHECK_EQ(bEventState, nEvent >> 7);
+		if(bKind == IOXP_EVENT_KIND_NONE)
+		{
+			continue;
+		}
+		if(nEvent < 0x80)
+		{
+			rgbCntKind[bKind]++;
+		}
+		HOST_CHECK_EQ(Encode(-1, bRow, bCol, bGPI, bLogic, bEventState), nEvent);
+	}
+	HOST_CHECK_EQ(rgbCntKind[IOXP_EVENT_KIND_KEY], IOXP_KB_ROWS * IOXP_KB_COLS);
+	HOST_CHECK_EQ(rgbCntKind[IOXP_EVENT_KIND_GND], IOXP_KB_ROWS);
+	HOST_CHECK_EQ(rgbCntKind[IOXP_EVENT_KIND_GPI], IOXP_GPIOS);
+	HOST_CHECK_EQ(rgbCntKind[IOXP_EVENT_KIND_LOGIC], IOXP_NO_LOGIC);
+
+	// encode -> decode, over every valid argument
+	for(bRow = 0; bRow < IOXP_KB_ROWS; bRow++)
+	{
+		for(bCol = 0; bCol < IOXP_KB_COLS; bCol++)
+		{
+			uint8_t bEvent = Encode(-1, bRow, bCol, 0xFF, 0xFF, 1);
+			uint8_t bR, bC;
+			HOST_CHECK_EQ(IOXPHostTest::DecodeEvent(ioxp, bEvent, iKeyVal, bR, bC, bGPI, bLogic, bEventState), IOXP_EVENT_KIND_KEY);
+			HOST_CHECK(bR == bRow && bC == bCol && bEventState == 1);
+		}
+		uint8_t bEvent = Encode(-1, bRow, 0xFF, 0xFF, 0xFF, 0);
+		uint8_t bR;
+		HOST_CHECK_EQ(IOXPHostTest::DecodeEvent(ioxp, bEvent, iKeyVal, bR, bCol, bGPI, bLogic, bEventState), IOXP_EVENT_KIND_GND);
+		HOST_CHECK(bR == bRow && bEventState == 0);
+	}
+	for(uint8_t bG = 1; bG <= IOXP_GPIOS; bG++)
+	{
+		uint8_t bEvent = Encode(-1, 0xFF, 0xFF, bG, 0xFF, 1);
+		HOST_CHECK_EQ(IOXPHostTest::DecodeEvent(ioxp, bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState), IOXP_EVENT_KIND_GPI);
+		HOST_CHECK_EQ(bGPI, bG);
+	}
+	for(uint8_t bL = 1; bL <= IOXP_NO_LOGIC; bL++)
+	{
+		uint8_t bEvent = Encode(-1, 0xFF, 0xFF, 0xFF, bL, 1);
+		HOST_CHECK_EQ(IOXPHostTest::DecodeEvent(ioxp, bEvent, iKeyVal, bRow, bCol, bGPI, bLogic, bEventState), IOXP_EVENT_KIND_LOGIC);
+		HOST_CHECK_EQ(bLogic, bL);
+	}
+
+	// a key value of the default key map encodes to its key
+	HOST_CHECK_EQ(Encode(0xD, 0xFF, 0xFF, 0xFF, 0xFF, 1), IOXP_EVENT_ID_KEY | 0x80);
+
+	// no event
+	HOST_CHECK_EQ(Encode(-1, IOXP_KB_ROWS, 0, 0xFF, 0xFF, 1), 0xFF);
+	HOST_CHECK_EQ(Encode(-1, 0, IOXP_KB_COLS, 0xFF, 0xFF, 1), 0xFF);
+	HOST_CHECK_EQ(Encode(-1, 0xFF, 0xFF, 0, 0xFF, 1), 0xFF);
+	HOST_CHECK_EQ(Encode(-1, 0xFF, 0xFF, IOXP_GPIOS + 1, 0xFF, 1), 0xFF);
+	HOST_CHECK_EQ(Encode(-1, 0xFF, 0xFF, 0xFF, 0, 1), 0xFF);
+	HOST_CHECK_EQ(Encode(-1, 0xFF, 0xFF, 0xFF, IOXP_NO_LOGIC + 1, 1), 0xFF);
+
+	HOST_TEST_END("TestEvents");
+}
@@ -0,0 +1,110 @@
+/************************************************************************/
+/*																		*/
+/*	TestMultiDevice.cpp	--	Host test of several devices and buses		*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		Three ADP5589 models: two on Wire at 0x34 and 0x35, one on a	*/
+/*		second bus at 0x34. Each IOXP object must only address its own	*/
+/*		device on its own bus and keep its own key state, and an		*/
+/*		IOXPGroup on one INT line must tag the events of each device	*/
+/*		with its index.													*/
+/*		The ADP5589 answers at 0x34 only; the second address on Wire	*/
+/*		stands for a device behind an address translator.				*/
+/*																		*/
+/************************************************************************/
+#include "ADP5589Sim.h"
+#include "HostTest.h"
+
+#define ADDR_B		(IOXP_I2C_ADDR + 1)
+
+static TwoWire wire2;
+
+int main()
+{
+	ADP5589Sim devA, devB, devC;
+	IOXP ioxpA;
+	IOXP ioxpB(ADDR_B);
+	IOXP ioxpC(IOXP_I2C_ADDR, &wire2);
+	IOXPGroup group;
+	IOXPEventRing<32> queue;
+	IOXPEvent evt;
+	uint8_t bIdx;
+
+	Wire.Attach(IOXP_I2C_ADDR, &devA);
+	Wire.Attach(ADDR_B, &devB);
+	wire2.Attach(IOXP_I2C_ADDR, &devC);
+	HOST_CHECK_EQ(ioxpA.begin(), IOXP_I2C_OK);
+	HOST_CHECK_EQ(ioxpB.begin(), IOXP_I2C_OK);
+	HOST_CHECK_EQ(ioxpC.begin(), IOXP_I2C_OK);
+
+	// each object writes its own device, on its own bus
+	Wire.ResetStats();
+	wire2.ResetStats();
+	ioxpA.SetRegister(IOXP_ADDR_POLL_TIME_CFG, 1);
+	ioxpB.SetRegister(IOXP_ADDR_POLL_TIME_CFG, 2);
+	ioxpC.SetRegister(IOXP_ADDR_POLL_TIME_CFG, 3);
+	HOST_CHECK_EQ(devA.rgbReg[IOXP_ADDR_POLL_TIME_CFG], 1);
+	HOST_CHECK_EQ(devB.rgbReg[IOXP_ADDR_POLL_TIME_CFG], 2);
+	HOST_CHECK_EQ(devC.rgbReg[IOXP_ADDR_POLL_TIME_CFG], 3);
+	HOST_CHECK_EQ(Wire.GetLogCount(), 2);
+	HOST_CHECK_EQ(Wire.GetLog(0).bAddr, IOXP_I2C_ADDR);
+	HOST_CHECK_EQ(Wire.GetLog(1).bAddr, ADDR_B);
+	HOST_CHECK_EQ(wire2.GetLogCount(), 1);
+	HOST_CHECK_EQ(ioxpB.GetRegister(IOXP_ADDR_POLL_TIME_CFG), 2);
+	HOST_CHECK_EQ(ioxpC.GetRegister(IOXP_ADDR_POLL_TIME_CFG), 3);
+
+	// a device missing from its bus fails alone
+	Wire.Detach(ADDR_B);
+	ioxpB.GetRegister(IOXP_ADDR_ID);
+	HOST_CHECK_EQ(ioxpB.GetLastI2CStatus(), IOXP_I2C_ERR_NACK_ADDR);
+	ioxpA.GetRegister(IOXP_ADDR_ID);
+	HOST_CHECK_EQ(ioxpA.GetLastI2CStatus(), IOXP_I2C_OK);
+	Wire.Attach(ADDR_B, &devB);
+
+	// the devices share the INT line; the events are tagged with the device index
+	HOST_CHECK_EQ(group.AddDevice(&ioxpA), 0);
+	HOST_CHECK_EQ(group.AddDevice(&ioxpB), 1);
+	HOST_CHECK_EQ(group.AddDevice(&ioxpC), 2);
+	group.ConfigureEventQueue(0, IOXP_INT_STATUS_EVENT_INT, &queue);
+	devA.SetIntLine(0);
+	devB.SetIntLine(0);
+	devC.SetIntLine(0);
+	group.Service();		// pending from ConfigureEventQueue, nothing queued yet
+	group.Service();
+	HOST_CHECK_EQ(group.Service(), 0);
+
+	devB.PressKey(1, 2);
+	devC.PressKey(3, 4);
+	devC.ReleaseKey(3, 4);
+	HOST_CHECK_EQ(group.Service(), 3);
+	HOST_CHECK_EQ(queue.GetCount(), 3);
+	HOST_CHECK(queue.Pop(evt) && evt.bDevice == 1 && evt.bRow == 1 && evt.bCol == 2 && evt.bEventState == 1);
+	HOST_CHECK(queue.Pop(evt) && evt.bDevice == 2 && evt.bRow == 3 && evt.bCol == 4 && evt.bEventState == 1);
+	HOST_CHECK(queue.Pop(evt) && evt.bDevice == 2 && evt.bRow == 3 && evt.bCol == 4 && evt.bEventState == 0);
+	HOST_CHECK(!devA.IsIntAsserted() && !devB.IsIntAsserted() && !devC.IsIntAsserted());
+
+	// the key state is kept per object
+	HOST_CHECK(!ioxpA.IsKeyDown(1, 2));
+	HOST_CHECK(ioxpB.IsKeyDown(1, 2));
+	HOST_CHECK(!ioxpC.IsKeyDown(3, 4));
+
+	// the pass that found events leaves the group pending for one more pass
+	HOST_CHECK_EQ(group.Service(), 0);
+	Wire.ResetStats();
+	wire2.ResetStats();
+	HOST_CHECK_EQ(group.Service(), 0);
+	HOST_CHECK_EQ(Wire.GetLogCount() + wire2.GetLogCount(), 0);
+
+	// events on two devices, serviced in scan order by one pass
+	devA.PressKey(0, 0);
+	devB.ReleaseKey(1, 2);
+	HOST_CHECK_EQ(group.Service(), 2);
+	for(bIdx = 0; bIdx < 2; bIdx++)
+	{
+		HOST_CHECK(queue.Pop(evt) && evt.bDevice == bIdx);
+	}
+	HOST_CHECK(ioxpA.IsKeyDown(0, 0) && !ioxpB.IsKeyDown(1, 2));
+
+	HOST_TEST_END("TestMultiDevice");
+}
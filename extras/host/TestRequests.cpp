@@ -0,0 +1,150 @@
+/************************************************************************/
+/*																		*/
+/*	TestRequests.cpp	--	Host test of the queued register transfers	*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		Runs SubmitRead / SubmitWrite requests with PollRequests		*/
+/*		called once per simulated 2 ms tick, as from loop() or a timer,	*/
+/*		against the ADP5589 model. Wire transfers block, so each step	*/
+/*		is complete (and its wire time elapsed) when PollRequests		*/
+/*		returns. Checks the completion order, the chunking of the		*/
+/*		transfers, a bus error in the middle of a request and a			*/
+/*		request submitted again from its completion handler.			*/
+/*																		*/
+/************************************************************************/
+#include "ADP5589Sim.h"
+#include "HostTest.h"
+
+#define TICK_US			2000		// longer than one step of up to 8 bytes at 100 kHz
+#define MAX_DONE		16
+
+static ADP5589Sim dev;
+static IOXP ioxp;
+static IOXPRequest reqA, reqB, reqC, reqD, reqE, reqF, reqG;	// static: bState starts IOXP_REQ_IDLE
+
+static IOXPRequest *rgpDone[MAX_DONE];	// completed requests, in completion order
+static uint32_t rgdwDoneTick[MAX_DONE];
+static uint8_t bCntDone;
+static uint32_t dwTick;
+
+static void OnDone(IOXPRequest &req)
+{
+	if(bCntDone < MAX_DONE)
+	{
+		rgpDone[bCntDone] = &req;
+		rgdwDoneTick[bCntDone] = dwTick;
+		bCntDone++;
+	}
+}
+
+/* Submits the request again until its counter (pvContext) reaches 0. */
+static void OnDoneAgain(IOXPRequest &req)
+{
+	uint8_t *pbLeft = (uint8_t *)req.pvContext;
+	OnDone(req);
+	if(*pbLeft != 0)
+	{
+		(*pbLeft)--;
+		HOST_CHECK_EQ(ioxp.SubmitRead(req, req.bAddress, req.bCntBytes, req.rgbBuf, OnDoneAgain, pbLeft), IOXP_I2C_OK);
+	}
+}
+
+/* Runs one PollRequests per tick until the queue is empty; returns the number of ticks. */
+static uint32_t RunTicks()
+{
+	uint32_t dwStartTick = dwTick;
+	uint8_t bCntQueued;
+	do
+	{
+		uint32_t dwTickUS = micros();
+		bCntQueued = ioxp.PollRequests();
+		HOST_CHECK(micros() - dwTickUS < TICK_US);		// one short transaction per tick
+		HostAdvanceUS(TICK_US - (micros() - dwTickUS));
+		dwTick++;
+	}
+	while(bCntQueued != 0 && dwTick - dwStartTick < 100);
+	return dwTick - dwStartTick;
+}
+
+static void ResetDone()
+{
+	bCntDone = 0;
+	Wire.ResetStats();
+}
+
+int main()
+{
+	uint8_t rgbA[10], rgbB[3] = { 0x11, 0x22, 0x33 }, rgbC[1], rgbD[12], rgbE[2], rgbF[2], rgbG[1];
+	uint8_t bIdx;
+
+	Wire.Attach(IOXP_I2C_ADDR, &dev);
+	HOST_CHECK_EQ(ioxp.begin(), IOXP_I2C_OK);
+	for(bIdx = 0; bIdx < IOXP_CFG_IMAGE_SIZE; bIdx++)
+	{
+		dev.rgbReg[IOXP_CFG_FIRST + bIdx] = 0x80 + bIdx;
+	}
+	ioxp.InvalidateRegisterCache();
+
+	// completion in submission order, 4 byte steps, one per tick
+	ResetDone();
+	HOST_CHECK_EQ(ioxp.SubmitRead(reqA, IOXP_CFG_FIRST, sizeof(rgbA), rgbA, OnDone), IOXP_I2C_OK);
+	HOST_CHECK_EQ(ioxp.SubmitWrite(reqB, IOXP_CFG_FIRST + 0x20, sizeof(rgbB), rgbB, OnDone), IOXP_I2C_OK);
+	HOST_CHECK_EQ(ioxp.SubmitRead(reqC, IOXP_CFG_FIRST + 0x21, sizeof(rgbC), rgbC, OnDone), IOXP_I2C_OK);
+	HOST_CHECK_EQ(ioxp.SubmitRead(reqA, IOXP_CFG_FIRST, 1, rgbA, OnDone), IOXP_ERR_PARAM);		// already queued
+	HOST_CHECK(reqA.bState == IOXP_REQ_QUEUED && reqC.bState == IOXP_REQ_QUEUED);
+	HOST_CHECK_EQ(RunTicks(), 5);		// 4 + 4 + 2, 3, 1
+	HOST_CHECK_EQ(bCntDone, 3);
+	HOST_CHECK(rgpDone[0] == &reqA && rgpDone[1] == &reqB && rgpDone[2] == &reqC);
+	HOST_CHECK(rgdwDoneTick[0] + 1 == rgdwDoneTick[1] && rgdwDoneTick[1] + 1 == rgdwDoneTick[2]);
+	HOST_CHECK(reqA.bState == IOXP_REQ_DONE && reqA.bStatus == IOXP_I2C_OK && reqA.bCntDone == sizeof(rgbA));
+	for(bIdx = 0; bIdx < sizeof(rgbA); bIdx++)
+	{
+		HOST_CHECK_EQ(rgbA[bIdx], 0x80 + bIdx);
+	}
+	HOST_CHECK_EQ(dev.rgbReg[IOXP_CFG_FIRST + 0x22], 0x33);
+	HOST_CHECK_EQ(rgbC[0], 0x22);		// the write of B is done before the read of C
+	// reads: register address write + read per step; the write: one transaction
+	HOST_CHECK_EQ(Wire.GetLogCount(), 3 * 2 + 1 + 2);
+	for(bIdx = 0; bIdx < Wire.GetLogCount(); bIdx++)
+	{
+		const HostWireXfer &xfer = Wire.GetLog(bIdx);
+		HOST_CHECK(xfer.bStatus == HOST_WIRE_OK && xfer.bCntData <= (xfer.fRead ? IOXP_REQ_CHUNK : IOXP_REQ_CHUNK + 1));
+	}
+	HOST_CHECK_EQ(Wire.GetLog(5).bCntData, 2);		// last step of A
+
+	// a larger chunk, fewer steps
+	ResetDone();
+	ioxp.SetRequestChunk(8);
+	HOST_CHECK_EQ(ioxp.SubmitRead(reqA, IOXP_CFG_FIRST, sizeof(rgbA), rgbA, OnDone), IOXP_I2C_OK);
+	HOST_CHECK_EQ(RunTicks(), 2);
+	HOST_CHECK_EQ(Wire.GetLog(1).bCntData, 8);
+	ioxp.SetRequestChunk(0);
+
+	// a bus error in the second step ends the request, the next one runs normally
+	ResetDone();
+	memset(rgbD, 0, sizeof(rgbD));
+	HOST_CHECK_EQ(ioxp.SubmitRead(reqD, IOXP_CFG_FIRST, sizeof(rgbD), rgbD, OnDone), IOXP_I2C_OK);
+	HOST_CHECK_EQ(ioxp.SubmitRead(reqE, IOXP_CFG_FIRST + 4, sizeof(rgbE), rgbE, OnDone), IOXP_I2C_OK);
+	Wire.FailAfter(2);
+	Wire.FailNackAddr(1);
+	HOST_CHECK_EQ(RunTicks(), 3);
+	HOST_CHECK(bCntDone == 2 && rgpDone[0] == &reqD && rgpDone[1] == &reqE);
+	HOST_CHECK_EQ(reqD.bStatus, IOXP_I2C_ERR_NACK_ADDR);
+	HOST_CHECK_EQ(reqD.bCntDone, IOXP_REQ_CHUNK);
+	HOST_CHECK(rgbD[0] == 0x80 && rgbD[IOXP_REQ_CHUNK - 1] == 0x80 + IOXP_REQ_CHUNK - 1 && rgbD[IOXP_REQ_CHUNK] == 0);
+	HOST_CHECK(reqE.bStatus == IOXP_I2C_OK && rgbE[0] == 0x84 && rgbE[1] == 0x85);
+
+	// a request submitted again by its handler goes behind the ones already queued
+	ResetDone();
+	uint8_t bLeft = 2;
+	HOST_CHECK_EQ(ioxp.SubmitRead(reqF, IOXP_CFG_FIRST, sizeof(rgbF), rgbF, OnDoneAgain, &bLeft), IOXP_I2C_OK);
+	HOST_CHECK_EQ(ioxp.SubmitRead(reqG, IOXP_CFG_FIRST, sizeof(rgbG), rgbG, OnDone), IOXP_I2C_OK);
+	HOST_CHECK_EQ(ioxp.PollRequests(), 2);		// F done and queued again, behind G
+	HOST_CHECK_EQ(RunTicks(), 3);
+	HOST_CHECK(bCntDone == 4 && rgpDone[0] == &reqF && rgpDone[1] == &reqG && rgpDone[2] == &reqF && rgpDone[3] == &reqF);
+	HOST_CHECK(bLeft == 0 && reqF.bState == IOXP_REQ_DONE && reqF.bStatus == IOXP_I2C_OK);
+	HOST_CHECK_EQ(ioxp.PollRequests(), 0);
+
+	HOST_TEST_END("TestRequests");
+}
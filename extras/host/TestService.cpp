@@ -0,0 +1,183 @@
+/************************************************************************/
+/*																		*/
+/*	TestService.cpp	--	Host test of the FIFO service path				*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		Runs Service and DrainFIFO against the ADP5589 model: events	*/
+/*		queued by the device while the FIFO burst is on the bus must	*/
+/*		be delivered, not popped and dropped. The event timestamps		*/
+/*		must hold the queuing time within their error. After a FIFO		*/
+/*		overflow the state is resynchronized once the FIFO is read		*/
+/*		without error, and each key gets a single release.				*/
+/*																		*/
+/************************************************************************/
+#include "ADP5589Sim.h"
+#include "HostTest.h"
+
+// At 100 kHz, a burst read from INT_STATUS clocks STATUS out 380 us after its start and pops
+// FIFO1 at 470 us: an event scheduled at +420 us is queued after EC was read.
+#define LATE_EVENT_US		420
+
+int main()
+{
+	ADP5589Sim dev;
+	IOXP ioxp;
+	IOXPEventRing<32> queue;
+	IOXPEvent rgEvents[IOXP_FIFO_DEPTH];
+	IOXPEvent evt;
+	uint8_t bCnt;
+
+	Wire.Attach(IOXP_I2C_ADDR, &dev);
+	Wire.SetClock(IOXP_I2C_CLK_100K);
+	HOST_CHECK_EQ(ioxp.begin(), IOXP_I2C_OK);
+	ioxp.ConfigureEventQueue(0, IOXP_INT_STATUS_EVENT_INT, &queue);
+
+	// Service: the late event is read by the prefetch, past EC
+	dev.PressKey(0, 0);
+	dev.ScheduleEvent(micros() + LATE_EVENT_US, (IOXP_EVENT_ID_KEY + 1) | 0x80);
+	HOST_CHECK_EQ(ioxp.Service(true), 2);
+	HOST_CHECK_EQ(dev.GetEventCount(), 0);
+	HOST_CHECK_EQ(queue.GetCount(), 2);
+	HOST_CHECK(queue.Pop(evt) && evt.bRow == 0 && evt.bCol == 0 && evt.bEventState == 1);
+	HOST_CHECK(queue.Pop(evt) && evt.bRow == 0 && evt.bCol == 1 && evt.bEventState == 1);
+	HOST_CHECK(ioxp.IsKeyDown(0, 1));
+
+	// no late event: the empty FIFO registers read past EC are not events
+	dev.ReleaseKey(0, 0);
+	HOST_CHECK_EQ(ioxp.Service(true), 1);
+	HOST_CHECK_EQ(queue.GetCount(), 1);
+	queue.Pop(evt);
+
+	// more events than the prefetch, read with a second burst
+	for(bCnt = 0; bCnt < 6; bCnt++)
+	{
+		dev.PressKey(2, bCnt);
+	}
+	HOST_CHECK_EQ(ioxp.Service(true), 6);
+	HOST_CHECK_EQ(queue.GetCount(), 6);
+	while(queue.Pop(evt))
+	{
+	}
+
+	// a short second burst: the entries clocked out were popped and are delivered, the rest stay queued
+	for(bCnt = 0; bCnt < 6; bCnt++)
+	{
+		dev.ReleaseKey(2, bCnt);
+		dev.PressKey(2, bCnt);
+	}
+	Wire.FailAfter(2);
+	Wire.FailShortRead(1);
+	bCnt = ioxp.Service(true);
+	HOST_CHECK_EQ(bCnt + dev.GetEventCount(), 12);
+	HOST_CHECK_EQ(dev.GetEventCount(), (12 - IOXP_SERVICE_PREFETCH) / 2);
+	HOST_CHECK_EQ(queue.GetCount(), bCnt);
+	HOST_CHECK_EQ(ioxp.Service(true), (12 - IOXP_SERVICE_PREFETCH) / 2);
+	HOST_CHECK_EQ(queue.GetCount(), 12);
+	for(bCnt = 0; queue.Pop(evt); bCnt++)
+	{
+		HOST_CHECK(evt.bRow == 2 && evt.bCol == bCnt / 2 && evt.bEventState == (bCnt & 1));
+	}
+
+	// DrainFIFO keeps the late event too
+	dev.ReleaseKey(0, 1);
+	dev.ReleaseKey(2, 0);
+	dev.ScheduleEvent(micros() + LATE_EVENT_US, IOXP_EVENT_ID_KEY + IOXP_KB_COLS * 2 + 1);
+	bCnt = ioxp.DrainFIFO(rgEvents, IOXP_FIFO_DEPTH);
+	HOST_CHECK_EQ(bCnt, 3);
+	HOST_CHECK_EQ(dev.GetEventCount(), 0);
+	HOST_CHECK(bCnt == 3 && rgEvents[2].bRow == 2 && rgEvents[2].bCol == 1 && rgEvents[2].bEventState == 0);
+	HOST_CHECK(!ioxp.IsKeyDown(2, 1));
+
+	// a short DrainFIFO read: the entries received are returned, the rest stay queued
+	for(bCnt = 0; bCnt < 6; bCnt++)
+	{
+		dev.ReleaseKey(2, bCnt);
+		dev.PressKey(2, bCnt);
+	}
+	Wire.FailShortRead(1);
+	bCnt = ioxp.DrainFIFO(rgEvents, IOXP_FIFO_DEPTH);
+	HOST_CHECK_EQ(bCnt, (2 + IOXP_FIFO_DEPTH) / 2 - 2);
+	HOST_CHECK_EQ(bCnt + dev.GetEventCount(), 12);
+	HOST_CHECK(rgEvents[0].bRow == 2 && rgEvents[0].bCol == 0 && rgEvents[0].bEventState == 0);
+	HOST_CHECK_EQ(ioxp.DrainFIFO(rgEvents, IOXP_FIFO_DEPTH), 12 - bCnt);
+	HOST_CHECK(ioxp.IsKeyDown(2, 5));
+
+	// overflow: INT_STATUS is left set when the FIFO read fails, the resync runs once it is empty
+	dev.PressKey(5, 0);
+	HOST_CHECK_EQ(ioxp.Service(true), 1);
+	queue.Pop(evt);
+	for(bCnt = 0; bCnt < IOXP_FIFO_DEPTH / 2; bCnt++)
+	{
+		dev.PressKey(6, bCnt);
+		dev.ReleaseKey(6, bCnt);
+	}
+	dev.PressKey(7, 0);		// lost
+	HOST_CHECK(dev.rgbReg[IOXP_ADDR_INT_STATUS] & IOXP_INT_STATUS_OVERFLOW_INT);
+	Wire.FailAfter(2);		// the second burst fails
+	Wire.FailNackAddr(1);
+	HOST_CHECK_EQ(ioxp.Service(true), IOXP_SERVICE_PREFETCH);
+	HOST_CHECK(dev.rgbReg[IOXP_ADDR_INT_STATUS] & IOXP_INT_STATUS_OVERFLOW_INT);
+	HOST_CHECK_EQ(ioxp.GetFifoOverflowCount(), 0);
+	HOST_CHECK(ioxp.IsKeyDown(5, 0));
+	HOST_CHECK_EQ(ioxp.Service(true), IOXP_FIFO_DEPTH - IOXP_SERVICE_PREFETCH);
+	HOST_CHECK(!(dev.rgbReg[IOXP_ADDR_INT_STATUS] & IOXP_INT_STATUS_OVERFLOW_INT));
+	HOST_CHECK_EQ(ioxp.GetFifoOverflowCount(), 1);
+	// the FIFO events of both passes, then a release of each key still down (2, 0 - 5 and 5, 0)
+	for(bCnt = 0; queue.Pop(evt); bCnt++)
+	{
+		bool fResync = (bCnt >= IOXP_FIFO_DEPTH);
+		HOST_CHECK_EQ(evt.bFlags, fResync ? IOXP_EVENT_FLAG_RESYNC : 0);
+		HOST_CHECK_EQ(evt.bEventState, fResync ? 0 : 1 - (bCnt & 1));
+	}
+	HOST_CHECK_EQ(bCnt, IOXP_FIFO_DEPTH + 7);
+	HOST_CHECK(evt.bRow == 5 && evt.bCol == 0 && evt.bEventState == 0);
+	HOST_CHECK(!ioxp.IsKeyDown(5, 0));
+	HOST_CHECK_EQ(ioxp.GetLostEventCount(), 1);		// no GPI correction: the minimum, held keys lost nothing
+
+	// the real release of a key released by the resync is dropped, the next press and release are not
+	dev.ReleaseKey(5, 0);
+	HOST_CHECK_EQ(ioxp.Service(true), 1);
+	HOST_CHECK_EQ(queue.GetCount(), 0);
+	dev.PressKey(5, 0);
+	dev.ReleaseKey(5, 0);
+	HOST_CHECK_EQ(ioxp.Service(true), 2);
+	HOST_CHECK(queue.Pop(evt) && evt.bRow == 5 && evt.bEventState == 1 && evt.bFlags == 0);
+	HOST_CHECK(queue.Pop(evt) && evt.bRow == 5 && evt.bEventState == 0 && evt.bFlags == 0);
+	HOST_CHECK_EQ(ioxp.GetLostEventCount(), 1);
+	// a press first proves that the release was lost
+	dev.PressKey(2, 1);
+	HOST_CHECK_EQ(ioxp.Service(true), 1);
+	HOST_CHECK(queue.Pop(evt) && evt.bRow == 2 && evt.bCol == 1 && evt.bEventState == 1);
+	HOST_CHECK_EQ(ioxp.GetLostEventCount(), 2);
+	// ReadFIFO returns a dropped release as an empty entry
+	int iKeyVal;
+	uint8_t bRow, bCol, bGPI, bLogic, bEventState;
+	dev.ReleaseKey(2, 2);
+	ioxp.ReadFIFO(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	HOST_CHECK(iKeyVal == -1 && bRow == 0xFF && bCol == 0xFF && bGPI == 0xFF && bLogic == 0xFF && bEventState == 0);
+	dev.PressKey(2, 2);
+	ioxp.ReadFIFO(iKeyVal, bRow, bCol, bGPI, bLogic, bEventState);
+	HOST_CHECK(bRow == 2 && bCol == 2 && bEventState == 1 && ioxp.IsKeyDown(2, 2));
+	HOST_CHECK_EQ(ioxp.GetLostEventCount(), 2);
+
+	// timestamps: an event queued with the INT edge is placed at the edge, within one scan interval
+	dev.SetIntLine(0);
+	while(ioxp.Service(true) != 0 || queue.Pop(evt))
+	{
+	}
+	HostAdvanceUS(5000);
+	uint32_t dwPressUS = micros();
+	dev.PressKey(4, 4);
+	dev.PressKey(4, 5);
+	HostAdvanceUS(3000);
+	HOST_CHECK_EQ(ioxp.Service(), 2);
+	HOST_CHECK(queue.Pop(evt) && evt.bRow == 4 && evt.bCol == 4);
+	HOST_CHECK_EQ(evt.dwTimeUS, dwPressUS);
+	HOST_CHECK(evt.dwTimeErrUS >= 10000);
+	// the next event has an estimated time, its window includes the real one
+	HOST_CHECK(queue.Pop(evt) && evt.bRow == 4 && evt.bCol == 5);
+	HOST_CHECK(evt.dwTimeErrUS != 0 && (uint32_t)(evt.dwTimeUS - dwPressUS) <= evt.dwTimeErrUS);
+
+	HOST_TEST_END("TestService");
+}
@@ -0,0 +1,181 @@
+/************************************************************************/
+/*																		*/
+/*	TestWire.cpp	--	Host test of the IOXP I2C transfer layer		*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		Checks the bus traffic of the register transfers on the fake	*/
+/*		Wire: the conditions of a single register read, the split of	*/
+/*		long transfers at the Wire buffer size, and the status codes	*/
+/*		returned for address NACKs, data NACKs and short reads.			*/
+/*																		*/
+/************************************************************************/
+#include "WProgram.h"
+#include "Wire.h"
+#include "IOXP.h"
+#include "HostTest.h"
+
+/* Plain register file with an auto-incremented address pointer. */
+class RegFile : public HostI2CDevice
+{
+public:
+	uint8_t rgbReg[IOXP_NO_REGS];
+	uint8_t bPtr;
+	bool fPtrSet;
+
+	RegFile()
+	{
+		memset(rgbReg, 0, sizeof(rgbReg));
+		rgbReg[IOXP_ADDR_ID] = 0x10;
+		bPtr = 0;
+	}
+	void Start(bool fRead)
+	{
+		fPtrSet = fRead;
+	}
+	bool Write(uint8_t bVal)
+	{
+		if(!fPtrSet)
+		{
+			bPtr = bVal;
+			fPtrSet = true;
+		}
+		else if(bPtr < IOXP_NO_REGS)
+		{
+			rgbReg[bPtr++] = bVal;
+		}
+		return true;
+	}
+	uint8_t Read()
+	{
+		return (bPtr < IOXP_NO_REGS) ? rgbReg[bPtr++] : 0;
+	}
+};
+
+static void CheckXfer(uint8_t bIdx, bool fRead, uint8_t bCntData, bool fStop)
+{
+	const HostWireXfer &xfer = Wire.GetLog(bIdx);
+	HOST_CHECK_EQ(xfer.bAddr, IOXP_I2C_ADDR);
+	HOST_CHECK_EQ(xfer.fRead, fRead);
+	HOST_CHECK_EQ(xfer.bCntData, bCntData);
+	HOST_CHECK_EQ(xfer.fStop, fStop);
+}
+
+int main()
+{
+	RegFile dev;
+	IOXP ioxp;
+	uint8_t rgbImage[IOXP_CFG_IMAGE_SIZE];
+	IOXPRange rngAll = { IOXP_CFG_FIRST, IOXP_CFG_IMAGE_SIZE };
+	IOXPConfig cfg;
+	int nIdx;
+
+	Wire.Attach(IOXP_I2C_ADDR, &dev);
+	HOST_CHECK_EQ(ioxp.begin(), IOXP_I2C_OK);
+
+	// one register read: START, address write, repeated START, read, STOP
+	Wire.ResetStats();
+	HOST_CHECK_EQ(ioxp.GetRegister(IOXP_ADDR_ID), 0x10);
+	HOST_CHECK_EQ(Wire.GetStats().dwStarts, 2);
+	HOST_CHECK_EQ(Wire.GetStats().dwRestarts, 1);
+	HOST_CHECK_EQ(Wire.GetStats().dwStops, 1);
+	HOST_CHECK_EQ(Wire.GetStats().dwBytes, 4);
+	HOST_CHECK_EQ(Wire.GetLogCount(), 2);
+	CheckXfer(0, false, 1, false);
+	CheckXfer(1, true, 1, true);
+
+	// one register write: START, device address, register address, value, STOP
+	Wire.ResetStats();
+	ioxp.SetRegister(IOXP_ADDR_POLL_TIME_CFG, 0x02);
+	HOST_CHECK_EQ(ioxp.GetLastI2CStatus(), IOXP_I2C_OK);
+	HOST_CHECK_EQ(dev.rgbReg[IOXP_ADDR_POLL_TIME_CFG], 0x02);
+	HOST_CHECK_EQ(Wire.GetStats().dwStarts, 1);
+	HOST_CHECK_EQ(Wire.GetStats().dwStops, 1);
+	HOST_CHECK_EQ(Wire.GetStats().dwBytes, 3);
+
+	// the 54 configuration registers are written in cycles of BUFFER_LENGTH - 1 values
+	for(nIdx = 0; nIdx < IOXP_CFG_IMAGE_SIZE; nIdx++)
+	{
+		rgbImage[nIdx] = nIdx + 1;
+	}
+	Wire.ResetStats();
+	HOST_CHECK_EQ(ioxp.WriteConfigRanges(rgbImage, &rngAll, 1), IOXP_I2C_OK);
+	HOST_CHECK_EQ(Wire.GetLogCount(), 2);
+	CheckXfer(0, false, 1 + (BUFFER_LENGTH - 1), true);
+	CheckXfer(1, false, 1 + IOXP_CFG_IMAGE_SIZE - (BUFFER_LENGTH - 1), true);
+	HOST_CHECK(memcmp(dev.rgbReg + IOXP_CFG_FIRST, rgbImage, IOXP_CFG_IMAGE_SIZE) == 0);
+
+	// and read back in cycles of BUFFER_LENGTH values
+	Wire.ResetStats();
+	HOST_CHECK_EQ(ioxp.ReadConfig(cfg), IOXP_I2C_OK);
+	HOST_CHECK_EQ(Wire.GetLogCount(), 4);
+	CheckXfer(0, false, 1, false);
+	CheckXfer(1, true, BUFFER_LENGTH, true);
+	CheckXfer(2, false, 1, false);
+	CheckXfer(3, true, IOXP_CFG_IMAGE_SIZE - BUFFER_LENGTH, true);
+	HOST_CHECK_EQ(Wire.GetStats().dwStarts, 4);
+	HOST_CHECK_EQ(Wire.GetStats().dwStops, 2);
+
+	// address NACK on a read: the cycle is closed by a STOP, the value is 0
+	Wire.ResetStats();
+	Wire.FailNackAddr(1);
+	HOST_CHECK_EQ(ioxp.GetRegister(IOXP_ADDR_ID), 0);
+	HOST_CHECK_EQ(ioxp.GetLastI2CStatus(), IOXP_I2C_ERR_NACK_ADDR);
+	HOST_CHECK_EQ(Wire.GetStats().dwStarts, 1);
+	HOST_CHECK_EQ(Wire.GetStats().dwStops, 1);
+
+	// address NACK on a write: nothing reaches the register
+	ioxp.SetRegister(IOXP_ADDR_POLL_TIME_CFG, 0x02);
+	Wire.FailNackAddr(1);
+	ioxp.SetRegister(IOXP_ADDR_POLL_TIME_CFG, 0x03);
+	HOST_CHECK_EQ(ioxp.GetLastI2CStatus(), IOXP_I2C_ERR_NACK_ADDR);
+	HOST_CHECK_EQ(dev.rgbReg[IOXP_ADDR_POLL_TIME_CFG], 0x02);
+
+	// data NACK on a write
+	Wire.FailNackData(1);
+	ioxp.SetRegister(IOXP_ADDR_POLL_TIME_CFG, 0x03);
+	HOST_CHECK_EQ(ioxp.GetLastI2CStatus(), IOXP_I2C_ERR_NACK_DATA);
+	HOST_CHECK_EQ(dev.rgbReg[IOXP_ADDR_POLL_TIME_CFG], 0x02);
+
+	// IOXPPin::Read returns the status, the level is kept on an error
+	IOXPPin<12> pin(ioxp);
+	bool fHigh = false;
+	dev.rgbReg[IOXP_ADDR_GPI_STATUS_B] = 0x08;
+	HOST_CHECK_EQ(pin.Read(fHigh), IOXP_I2C_OK);
+	HOST_CHECK(fHigh);
+	dev.rgbReg[IOXP_ADDR_GPI_STATUS_B] = 0;
+	Wire.FailNackAddr(1);
+	HOST_CHECK_EQ(pin.Read(fHigh), IOXP_I2C_ERR_NACK_ADDR);
+	HOST_CHECK(fHigh);
+	HOST_CHECK_EQ(pin.Read(fHigh), IOXP_I2C_OK);
+	HOST_CHECK(!fHigh);
+
+	// short read: the status says so and the bytes not received are 0
+	Wire.FailShortRead(1);
+	HOST_CHECK_EQ(ioxp.ReadConfig(cfg), IOXP_I2C_ERR_SHORT_READ);
+	HOST_CHECK_EQ(ioxp.GetLastI2CStatus(), IOXP_I2C_ERR_SHORT_READ);
+	HOST_CHECK_EQ(ioxp.GetBusErrors().dwShortReads, 1);
+
+	// with one retry the read goes on from the first byte not received
+	ioxp.SetRetryPolicy(1, 0, IOXP_CALL_TIMEOUT_US);
+	Wire.ResetStats();
+	Wire.FailShortRead(1);
+	HOST_CHECK_EQ(ioxp.ReadConfig(cfg), IOXP_I2C_OK);
+	HOST_CHECK_EQ(Wire.GetLogCount(), 6);
+	CheckXfer(1, true, BUFFER_LENGTH / 2, true);
+	CheckXfer(3, true, BUFFER_LENGTH, true);
+	CheckXfer(5, true, IOXP_CFG_IMAGE_SIZE - BUFFER_LENGTH / 2 - BUFFER_LENGTH, true);
+
+	// the object counters agree with the bus, a short read included
+	uint32_t dwBytes, dwConditions;
+	Wire.ResetStats();
+	ioxp.ResetBusCost();
+	Wire.FailShortRead(1);
+	ioxp.ReadConfig(cfg);
+	ioxp.WriteConfigRanges(rgbImage, &rngAll, 1);
+	ioxp.GetBusCost(dwBytes, dwConditions);
+	HOST_CHECK_EQ(dwBytes, Wire.GetStats().dwBytes);
+	HOST_CHECK_EQ(dwConditions, Wire.GetStats().dwStarts + Wire.GetStats().dwStops);
+
+	HOST_TEST_END("TestWire");
+}
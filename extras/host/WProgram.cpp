@@ -0,0 +1,104 @@
+/************************************************************************/
+/*																		*/
+/*	WProgram.cpp	--	Host stand-in for the MPIDE core				*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		Simulated time, digital pins and external interrupts, see		*/
+/*		WProgram.h.														*/
+/*																		*/
+/************************************************************************/
+#include "WProgram.h"
+
+Print Serial;
+
+static uint32_t dwHostMicros = 0;
+static bool rgfHostInputLow[HOST_NO_PINS];	// inputs read HIGH until set, like the pulled up I2C lines
+static uint8_t rgbHostOutput[HOST_NO_PINS];
+static uint32_t rgdwHostWrites[HOST_NO_PINS];
+static void (*rgpfHostInt[HOST_NO_EXT_INT])();
+
+unsigned long micros()
+{
+	return dwHostMicros;
+}
+
+unsigned long millis()
+{
+	return dwHostMicros / 1000;
+}
+
+void delay(unsigned long dwMS)
+{
+	dwHostMicros += dwMS * 1000;
+}
+
+void delayMicroseconds(unsigned int wUS)
+{
+	dwHostMicros += wUS;
+}
+
+void pinMode(uint8_t bPin, uint8_t bMode)
+{
+}
+
+void digitalWrite(uint8_t bPin, uint8_t bVal)
+{
+	if(bPin < HOST_NO_PINS)
+	{
+		rgbHostOutput[bPin] = bVal;
+		rgdwHostWrites[bPin]++;
+	}
+}
+
+int digitalRead(uint8_t bPin)
+{
+	return (bPin < HOST_NO_PINS && rgfHostInputLow[bPin]) ? LOW : HIGH;
+}
+
+void attachInterrupt(uint8_t bIntNo, void (*pfIntHandler)(), int iMode)
+{
+	if(bIntNo < HOST_NO_EXT_INT)
+	{
+		rgpfHostInt[bIntNo] = pfIntHandler;
+	}
+}
+
+void detachInterrupt(uint8_t bIntNo)
+{
+	if(bIntNo < HOST_NO_EXT_INT)
+	{
+		rgpfHostInt[bIntNo] = NULL;
+	}
+}
+
+void HostAdvanceUS(uint32_t dwUS)
+{
+	dwHostMicros += dwUS;
+}
+
+void HostSetInput(uint8_t bPin, uint8_t bVal)
+{
+	if(bPin < HOST_NO_PINS)
+	{
+		rgfHostInputLow[bPin] = (bVal == LOW);
+	}
+}
+
+uint8_t HostGetOutput(uint8_t bPin)
+{
+	return (bPin < HOST_NO_PINS) ? rgbHostOutput[bPin] : LOW;
+}
+
+uint32_t HostGetWriteCount(uint8_t bPin)
+{
+	return (bPin < HOST_NO_PINS) ? rgdwHostWrites[bPin] : 0;
+}
+
+void HostFireInterrupt(uint8_t bIntNo)
+{
+	if(bIntNo < HOST_NO_EXT_INT && rgpfHostInt[bIntNo] != NULL)
+	{
+		rgpfHostInt[bIntNo]();
+	}
+}
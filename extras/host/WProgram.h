@@ -0,0 +1,72 @@
+/************************************************************************/
+/*																		*/
+/*	WProgram.h	--	Host stand-in for the MPIDE core header				*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		Declares the small part of the MPIDE core used by the IOXP		*/
+/*		library, so IOXP.cpp can be built and tested on a PC. Time is	*/
+/*		simulated: micros() only moves when the fake Wire clocks bytes	*/
+/*		on the bus, or when delay / delayMicroseconds / HostAdvanceUS	*/
+/*		is called.														*/
+/*																		*/
+/************************************************************************/
+#if !defined(WPROGRAM_H)
+#define WPROGRAM_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+#define LOW			0
+#define HIGH		1
+#define INPUT		0
+#define OUTPUT		1
+#define OPEN		2
+#define CHANGE		1
+#define FALLING		2
+#define RISING		3
+#define DEC			10
+#define HEX			16
+
+#define HOST_NO_PINS		64	// digital pins modeled by digitalRead / digitalWrite
+#define HOST_NO_EXT_INT		5	// external interrupts modeled by attachInterrupt
+
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long dwMS);
+void delayMicroseconds(unsigned int wUS);
+void pinMode(uint8_t bPin, uint8_t bMode);
+void digitalWrite(uint8_t bPin, uint8_t bVal);
+int digitalRead(uint8_t bPin);
+void attachInterrupt(uint8_t bIntNo, void (*pfIntHandler)(), int iMode);
+void detachInterrupt(uint8_t bIntNo);
+
+/* Host side controls of the simulated core. */
+void HostAdvanceUS(uint32_t dwUS);						// move the simulated time forward
+void HostSetInput(uint8_t bPin, uint8_t bVal);			// level returned by digitalRead
+uint8_t HostGetOutput(uint8_t bPin);					// last level written by digitalWrite
+uint32_t HostGetWriteCount(uint8_t bPin);				// digitalWrite calls on a pin
+void HostFireInterrupt(uint8_t bIntNo);					// run the handler of attachInterrupt
+
+class Print
+{
+public:
+	void print(const char *sz)						{ fputs(sz, stdout); }
+	void print(char ch)								{ putchar(ch); }
+	void print(int iVal, int iBase = DEC)			{ printf(iBase == HEX ? "%X" : "%d", iVal); }
+	void print(unsigned int wVal, int iBase = DEC)	{ printf(iBase == HEX ? "%X" : "%u", wVal); }
+	void print(long lVal, int iBase = DEC)			{ printf(iBase == HEX ? "%lX" : "%ld", lVal); }
+	void print(unsigned long dwVal, int iBase = DEC)	{ printf(iBase == HEX ? "%lX" : "%lu", dwVal); }
+	void println()									{ putchar('\n'); }
+	void println(const char *sz)					{ print(sz); println(); }
+	void println(int iVal, int iBase = DEC)			{ print(iVal, iBase); println(); }
+	void println(unsigned int wVal, int iBase = DEC)	{ print(wVal, iBase); println(); }
+	void println(long lVal, int iBase = DEC)		{ print(lVal, iBase); println(); }
+	void println(unsigned long dwVal, int iBase = DEC)	{ print(dwVal, iBase); println(); }
+};
+
+extern Print Serial;
+
+#endif
@@ -0,0 +1,281 @@
+/************************************************************************/
+/*																		*/
+/*	Wire.cpp	--	Host stand-in for the MPIDE Wire library			*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		Fake I2C master, see Wire.h.									*/
+/*																		*/
+/************************************************************************/
+#include "Wire.h"
+#include "WProgram.h"
+
+TwoWire Wire;
+
+TwoWire::TwoWire()
+{
+	bCntDev = 0;
+	bCntTx = 0;
+	fTxOverflow = false;
+	bCntRx = 0;
+	bIdxRx = 0;
+	fBusOwned = false;
+	dwClockHz = 100000;
+	dwTimeRemNS = 0;
+	dwFailNackAddr = 0;
+	dwFailNackData = 0;
+	dwFailShortRead = 0;
+	dwFailSkip = 0;
+	ResetStats();
+}
+
+/* Counts one transfer; true once the transfers given to FailAfter have passed. */
+bool TwoWire::IsFailArmed()
+{
+	if(dwFailSkip != 0)
+	{
+		dwFailSkip--;
+		return false;
+	}
+	return true;
+}
+
+HostI2CDevice *TwoWire::FindDevice(uint8_t bAddr)
+{
+	for(uint8_t bIdx = 0; bIdx < bCntDev; bIdx++)
+	{
+		if(rgbDevAddr[bIdx] == bAddr)
+		{
+			return rgpDev[bIdx];
+		}
+	}
+	return NULL;
+}
+
+/* START (or repeated START when the bus is still owned) or STOP, one SCL clock each. */
+void TwoWire::Condition(bool fStart)
+{
+	if(fStart)
+	{
+		stats.dwStarts++;
+		if(fBusOwned)
+		{
+			stats.dwRestarts++;
+		}
+		fBusOwned = true;
+	}
+	else
+	{
+		stats.dwStops++;
+		fBusOwned = false;
+	}
+	stats.dwClocks++;
+	dwTimeRemNS += 1000000000UL / dwClockHz;
+	HostAdvanceUS(dwTimeRemNS / 1000);
+	dwTimeRemNS %= 1000;
+}
+
+/* Bytes with their acknowledge, 9 SCL clocks each. */
+void TwoWire::Clock(uint32_t dwBytes)
+{
+	stats.dwBytes += dwBytes;
+	stats.dwClocks += 9 * dwBytes;
+	dwTimeRemNS += 9 * dwBytes * (1000000000UL / dwClockHz);
+	HostAdvanceUS(dwTimeRemNS / 1000);
+	dwTimeRemNS %= 1000;
+}
+
+void TwoWire::Log(uint8_t bAddr, bool fRead, uint8_t bCntData, bool fStop, uint8_t bStatus)
+{
+	if(bCntLog < HOST_WIRE_LOG)
+	{
+		rgLog[bCntLog].bAddr = bAddr;
+		rgLog[bCntLog].fRead = fRead;
+		rgLog[bCntLog].bCntData = bCntData;
+		rgLog[bCntLog].fStop = fStop;
+		rgLog[bCntLog].bStatus = bStatus;
+		bCntLog++;
+	}
+}
+
+void TwoWire::begin()
+{
+}
+
+void TwoWire::beginTransmission(uint8_t bAddr)
+{
+	bTxAddr = bAddr;
+	bCntTx = 0;
+	fTxOverflow = false;
+}
+
+void TwoWire::send(uint8_t bVal)
+{
+	if(bCntTx >= BUFFER_LENGTH)
+	{
+		fTxOverflow = true;		// the real library drops the byte
+		return;
+	}
+	rgbTx[bCntTx++] = bVal;
+}
+
+void TwoWire::send(uint8_t *rgbVal, uint8_t bCnt)
+{
+	for(uint8_t bIdx = 0; bIdx < bCnt; bIdx++)
+	{
+		send(rgbVal[bIdx]);
+	}
+}
+
+uint8_t TwoWire::endTransmission(uint8_t fSendStop)
+{
+	if(fTxOverflow)
+	{
+		Log(bTxAddr, false, 0, false, HOST_WIRE_ERR_LENGTH);
+		return HOST_WIRE_ERR_LENGTH;
+	}
+	HostI2CDevice *pDev = FindDevice(bTxAddr);
+	uint8_t bStatus = HOST_WIRE_OK;
+	uint8_t bCntData = 0;
+	bool fArmed = IsFailArmed();
+	Condition(true);
+	Clock(1);
+	if(pDev == NULL || (fArmed && dwFailNackAddr != 0))
+	{
+		if(fArmed && dwFailNackAddr != 0)
+		{
+			dwFailNackAddr--;
+		}
+		bStatus = HOST_WIRE_ERR_NACK_ADDR;
+	}
+	else
+	{
+		pDev->Start(false);
+		bool fFailData = (fArmed && dwFailNackData != 0 && bCntTx != 0);
+		if(fFailData)
+		{
+			dwFailNackData--;
+		}
+		while(bCntData < bCntTx)
+		{
+			Clock(1);
+			if(fFailData || !pDev->Write(rgbTx[bCntData]))
+			{
+				bStatus = HOST_WIRE_ERR_NACK_DATA;
+				break;
+			}
+			bCntData++;
+		}
+	}
+	// a NACK always ends the transfer with a STOP
+	bool fStop = fSendStop || bStatus != HOST_WIRE_OK;
+	if(fStop)
+	{
+		Condition(false);
+		if(pDev != NULL)
+		{
+			pDev->Stop();
+		}
+	}
+	Log(bTxAddr, false, bCntData, fStop, bStatus);
+	return bStatus;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t bAddr, uint8_t bCnt)
+{
+	HostI2CDevice *pDev = FindDevice(bAddr);
+	uint8_t bStatus = HOST_WIRE_OK;
+	if(bCnt > BUFFER_LENGTH)
+	{
+		bCnt = BUFFER_LENGTH;
+	}
+	bCntRx = 0;
+	bIdxRx = 0;
+	bool fArmed = IsFailArmed();
+	Condition(true);
+	Clock(1);
+	if(pDev == NULL || (fArmed && dwFailNackAddr != 0))
+	{
+		if(fArmed && dwFailNackAddr != 0)
+		{
+			dwFailNackAddr--;
+		}
+		bStatus = HOST_WIRE_ERR_NACK_ADDR;
+	}
+	else
+	{
+		if(fArmed && dwFailShortRead != 0)
+		{
+			dwFailShortRead--;
+			bCnt /= 2;
+		}
+		pDev->Start(true);
+		while(bCntRx < bCnt)
+		{
+			rgbRx[bCntRx++] = pDev->Read();
+			Clock(1);
+		}
+	}
+	Condition(false);
+	if(pDev != NULL)
+	{
+		pDev->Stop();
+	}
+	Log(bAddr, true, bCntRx, true, bStatus);
+	return bCntRx;
+}
+
+int TwoWire::available()
+{
+	return bCntRx - bIdxRx;
+}
+
+uint8_t TwoWire::receive()
+{
+	return (bIdxRx < bCntRx) ? rgbRx[bIdxRx++] : 0;
+}
+
+void TwoWire::Attach(uint8_t bAddr, HostI2CDevice *pDev)
+{
+	Detach(bAddr);
+	if(bCntDev < HOST_WIRE_MAX_DEV)
+	{
+		rgbDevAddr[bCntDev] = bAddr;
+		rgpDev[bCntDev] = pDev;
+		bCntDev++;
+	}
+}
+
+void TwoWire::Detach(uint8_t bAddr)
+{
+	for(uint8_t bIdx = 0; bIdx < bCntDev; bIdx++)
+	{
+		if(rgbDevAddr[bIdx] == bAddr)
+		{
+			bCntDev--;
+			rgbDevAddr[bIdx] = rgbDevAddr[bCntDev];
+			rgpDev[bIdx] = rgpDev[bCntDev];
+			return;
+		}
+	}
+}
+
+void TwoWire::SetClock(uint32_t dwHz)
+{
+	dwClockHz = dwHz;
+}
+
+void TwoWire::ResetStats()
+{
+	stats.dwStarts = 0;
+	stats.dwRestarts = 0;
+	stats.dwStops = 0;
+	stats.dwBytes = 0;
+	stats.dwClocks = 0;
+	bCntLog = 0;
+}
+
+uint32_t TwoWire::GetWireTimeUS(uint32_t dwHz)
+{
+	return (uint32_t)(((uint64_t)stats.dwClocks * 1000000 + dwHz / 2) / dwHz);
+}
@@ -0,0 +1,127 @@
+/************************************************************************/
+/*																		*/
+/*	Wire.h		--	Host stand-in for the MPIDE Wire library			*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*		A fake I2C master with the old Wire interface (send / receive)	*/
+/*		used by IOXP.cpp. Device models (HostI2CDevice) are attached	*/
+/*		to a bus at their 7 bit address. The bus counts the START,		*/
+/*		repeated START and STOP conditions and the bytes clocked,		*/
+/*		advances the simulated time by the wire time of each transfer	*/
+/*		and can be told to fail the next transfers with an address		*/
+/*		NACK, a data NACK or a short read.								*/
+/*																		*/
+/************************************************************************/
+#if !defined(TwoWire_h)
+#define TwoWire_h
+
+#include <inttypes.h>
+
+#define BUFFER_LENGTH		32		// size of the transmit / receive buffers
+#define HOST_WIRE_MAX_DEV	8		// devices attached to one bus
+#define HOST_WIRE_LOG		64		// transfers kept in the log
+
+/* Wire.endTransmission return codes */
+#define HOST_WIRE_OK			0
+#define HOST_WIRE_ERR_LENGTH	1	// data too long for the transmit buffer
+#define HOST_WIRE_ERR_NACK_ADDR	2	// address not acknowledged
+#define HOST_WIRE_ERR_NACK_DATA	3	// data byte not acknowledged
+
+/* ------------------------------------------------------------ */
+/*	A device model attached to a fake bus. The address byte is	*/
+/*	handled by the bus, the model only sees the data phase.		*/
+/* ------------------------------------------------------------ */
+class HostI2CDevice
+{
+public:
+	virtual ~HostI2CDevice() {}
+	virtual void Start(bool fRead) {}			// addressed after a START or repeated START
+	virtual bool Write(uint8_t bVal) = 0;		// data byte written, false to NACK it
+	virtual uint8_t Read() = 0;					// data byte read
+	virtual void Stop() {}						// STOP condition
+};
+
+/* One transfer seen on the bus: the address byte and the data phase up to the next condition. */
+struct HostWireXfer
+{
+	uint8_t bAddr;			// 7 bit device address
+	bool	fRead;			// read phase (requestFrom) or write phase (endTransmission)
+	uint8_t bCntData;		// data bytes clocked
+	bool	fStop;			// the phase ended with a STOP
+	uint8_t bStatus;		// HOST_WIRE_... code of the phase
+};
+
+struct HostWireStats
+{
+	uint32_t dwStarts;		// START and repeated START conditions
+	uint32_t dwRestarts;	// repeated STARTs alone
+	uint32_t dwStops;		// STOP conditions
+	uint32_t dwBytes;		// bytes clocked, address bytes included
+	uint32_t dwClocks;		// SCL clocks: 9 per byte, 1 per condition
+};
+
+class TwoWire
+{
+private:
+	HostI2CDevice *rgpDev[HOST_WIRE_MAX_DEV];
+	uint8_t rgbDevAddr[HOST_WIRE_MAX_DEV];
+	uint8_t bCntDev;
+	uint8_t rgbTx[BUFFER_LENGTH];
+	uint8_t bTxAddr;
+	uint8_t bCntTx;
+	bool fTxOverflow;
+	uint8_t rgbRx[BUFFER_LENGTH];
+	uint8_t bCntRx;
+	uint8_t bIdxRx;
+	bool fBusOwned;			// a phase ended without STOP, the next START is repeated
+	uint32_t dwClockHz;
+	uint32_t dwTimeRemNS;
+	uint32_t dwFailNackAddr;
+	uint32_t dwFailNackData;
+	uint32_t dwFailShortRead;
+	uint32_t dwFailSkip;
+	HostWireStats stats;
+	HostWireXfer rgLog[HOST_WIRE_LOG];
+	uint8_t bCntLog;
+
+	HostI2CDevice *FindDevice(uint8_t bAddr);
+	bool IsFailArmed();
+	void Condition(bool fStart);
+	void Clock(uint32_t dwBytes);
+	void Log(uint8_t bAddr, bool fRead, uint8_t bCntData, bool fStop, uint8_t bStatus);
+
+public:
+	TwoWire();
+
+	/* Wire interface used by the library */
+	void begin();
+	void beginTransmission(uint8_t bAddr);
+	void beginTransmission(int iAddr)				{ beginTransmission((uint8_t)iAddr); }
+	void send(uint8_t bVal);
+	void send(uint8_t *rgbVal, uint8_t bCnt);
+	void send(int iVal)								{ send((uint8_t)iVal); }
+	uint8_t endTransmission(uint8_t fSendStop = true);
+	uint8_t requestFrom(uint8_t bAddr, uint8_t bCnt);
+	uint8_t requestFrom(int iAddr, int iCnt)		{ return requestFrom((uint8_t)iAddr, (uint8_t)iCnt); }
+	int available();
+	uint8_t receive();
+
+	/* Host side controls */
+	void Attach(uint8_t bAddr, HostI2CDevice *pDev);
+	void Detach(uint8_t bAddr);
+	void SetClock(uint32_t dwHz);
+	void FailNackAddr(uint32_t dwCnt)				{ dwFailNackAddr = dwCnt; }		// NACK the next address bytes
+	void FailNackData(uint32_t dwCnt)				{ dwFailNackData = dwCnt; }		// NACK the first data byte of the next writes
+	void FailShortRead(uint32_t dwCnt)				{ dwFailShortRead = dwCnt; }	// return half of the next reads
+	void FailAfter(uint32_t dwCnt)					{ dwFailSkip = dwCnt; }			// the failures above start after dwCnt transfers
+	const HostWireStats &GetStats()					{ return stats; }
+	void ResetStats();
+	uint8_t GetLogCount()							{ return bCntLog; }
+	const HostWireXfer &GetLog(uint8_t bIdx)		{ return rgLog[bIdx]; }
+	uint32_t GetWireTimeUS(uint32_t dwHz);			// wire time of the counted clocks at dwHz
+};
+
+extern TwoWire Wire;
+
+#endif